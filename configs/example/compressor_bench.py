@@ -0,0 +1,140 @@
+# Copyright (c) 2022 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+# This script measures the host throughput of the cache compressors on
+# real data. The data is a raw memory dump (e.g., the .pmem file of a
+# checkpoint, gunzipped), which is loaded into one memory per
+# compressor. A traffic generator then reads every line of the dump
+# through a compressed cache, so that each line is compressed once, and
+# the host time of each sweep is compared against a sweep through an
+# uncompressed cache to isolate the cost of compression. For example:
+#
+#   build/NULL/gem5.opt configs/example/compressor_bench.py \
+#       -c CPack -c FPCD -c BDI dump.raw
+
+import argparse
+import os
+import time
+
+import m5
+from m5.objects import *
+from m5.util import fatal
+
+parser = argparse.ArgumentParser(
+    formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+
+parser.add_argument("dump", type=str,
+                    help="Raw memory dump to compress")
+parser.add_argument("-c", "--compressor", action="append", default=[],
+                    help="Compressor to measure, by its SimObject name. "
+                    "May be repeated; all dictionary compressors and BDI "
+                    "are measured by default")
+parser.add_argument("--cache-size", type=str, default="64kB",
+                    help="Size of the cache in front of each memory")
+
+args = parser.parse_args()
+
+if not args.compressor:
+    args.compressor = [ "Base64Delta8", "Base64Delta16", "Base64Delta32",
+                        "Base32Delta8", "Base32Delta16", "Base16Delta8",
+                        "CPack", "FPC", "FPCD", "RepeatedQwordsCompressor",
+                        "ZeroCompressor", "BDI" ]
+
+line_size = 64
+dump_size = os.path.getsize(args.dump)
+if dump_size < line_size:
+    fatal("%s is smaller than a cache line" % args.dump)
+num_lines = dump_size // line_size
+# Memories are sized in whole pages
+mem_size = (dump_size + 4095) & ~4095
+
+# Issue a read every 100 ns, which is more than the miss latency, so
+# that the sweeps never stall on the cache
+period = 100000
+duration = num_lines * period + 1000000
+
+system = System(cache_line_size = line_size)
+system.voltage_domain = VoltageDomain(voltage = '1V')
+system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                   voltage_domain = system.voltage_domain)
+
+# The first sweep goes through an uncompressed cache as the baseline
+names = [ "none" ] + args.compressor
+system.tgen = [ PyTrafficGen() for name in names ]
+caches = []
+mems = []
+for name, tgen in zip(names, system.tgen):
+    cache = Cache(size = args.cache_size, assoc = 8, tag_latency = 1,
+                  data_latency = 1, response_latency = 1, mshrs = 16,
+                  tgts_per_mshr = 8)
+    if name != "none":
+        compressor = getattr(m5.objects, name, None)
+        if compressor is None or \
+           not issubclass(compressor, BaseCacheCompressor):
+            fatal("%s is not a cache compressor" % name)
+        cache.compressor = compressor()
+        cache.tags = CompressedTags()
+
+    # The memories all hold a copy of the dump at the same addresses,
+    # so keep them out of the global address map
+    mem = SimpleMemory(range = AddrRange(mem_size), in_addr_map = False,
+                       image_file = args.dump)
+
+    tgen.port = cache.cpu_side
+    cache.mem_side = mem.port
+    caches.append(cache)
+    mems.append(mem)
+
+system.cache = caches
+system.mem = mems
+
+root = Root(full_system = False, system = system)
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+
+def sweep(tgen):
+    yield tgen.createLinear(duration, 0, num_lines * line_size - 1,
+                            line_size, period, period, 100, 0)
+    yield tgen.createExit(0)
+
+elapsed = {}
+for name, tgen in zip(names, system.tgen):
+    tgen.start(sweep(tgen))
+    start = time.perf_counter()
+    m5.simulate()
+    elapsed[name] = time.perf_counter() - start
+
+base = elapsed["none"]
+print("%d lines, %.3f s through an uncompressed cache" % (num_lines, base))
+print("%-26s %10s %14s" % ("compressor", "host s", "lines/s"))
+for name in args.compressor:
+    # Subtract the cost of simulating the uncompressed sweep to get the
+    # time spent compressing
+    comp_time = elapsed[name] - base
+    rate = num_lines / comp_time if comp_time > 0 else float("inf")
+    print("%-26s %10.3f %14.0f" % (name, elapsed[name], rate))
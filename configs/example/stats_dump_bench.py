@@ -0,0 +1,112 @@
+# Copyright (c) 2022 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script compares the cost of periodic stat dumps in the text and
+# binary stat formats. It builds a system with many memory testers,
+# each behind a private cache, so that the stat tree is about as large
+# as that of a many-core system, and then times a series of dumps to
+# each format in turn. For example:
+#
+#   build/NULL/gem5.opt configs/example/stats_dump_bench.py -n 64 -d 50
+
+import argparse
+import os
+import time
+from urllib.parse import urlsplit
+
+import m5
+from m5.objects import *
+from m5.util.convert import anyToLatency
+
+parser = argparse.ArgumentParser(
+    formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+
+parser.add_argument("-n", "--num-testers", type=int, default=64,
+                    help="Number of memory testers (and L1 caches)")
+parser.add_argument("-d", "--dumps", type=int, default=20,
+                    help="Number of stat dumps per format")
+parser.add_argument("-p", "--period", type=str, default="1us",
+                    help="Simulated time between stat dumps")
+parser.add_argument("--binary-file", type=str, default="stats.bin",
+                    help="Binary stat file to write")
+
+args = parser.parse_args()
+
+system = System(physmem = SimpleMemory(), cache_line_size = 64)
+system.voltage_domain = VoltageDomain(voltage = '1V')
+system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                   voltage_domain = system.voltage_domain)
+
+system.l2 = Cache(size = '4MB', assoc = 16, tag_latency = 10,
+                  data_latency = 10, response_latency = 10, mshrs = 64,
+                  tgts_per_mshr = 8)
+system.l2bus = L2XBar()
+system.membus = SystemXBar()
+system.l2bus.mem_side_ports = system.l2.cpu_side
+system.l2.mem_side = system.membus.cpu_side_ports
+system.membus.mem_side_ports = system.physmem.port
+system.system_port = system.membus.cpu_side_ports
+
+system.tester = [ MemTest(max_loads = 0)
+                  for i in range(args.num_testers) ]
+system.l1 = [ Cache(size = '32kB', assoc = 4, tag_latency = 1,
+                    data_latency = 1, response_latency = 1, mshrs = 4,
+                    tgts_per_mshr = 8)
+              for i in range(args.num_testers) ]
+for tester, l1 in zip(system.tester, system.l1):
+    tester.port = l1.cpu_side
+    l1.mem_side = system.l2bus.cpu_side_ports
+
+root = Root(full_system = False, system = system)
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+
+def bench(name, path):
+    """Time args.dumps dumps to the outputs currently registered."""
+    elapsed = 0.0
+    for i in range(args.dumps):
+        m5.simulate(m5.ticks.fromSeconds(anyToLatency(args.period)))
+        start = time.perf_counter()
+        m5.stats.dump()
+        elapsed += time.perf_counter() - start
+
+    size = os.path.getsize(os.path.join(m5.options.outdir, path))
+    print("%-8s %10.2f ms/dump %12d bytes/dump" % (
+        name, 1000 * elapsed / args.dumps, size // args.dumps))
+
+# gem5 has already registered the text output (--stats-file), and
+# there can only be one text output, so time it on its own first.
+text_url = urlsplit(m5.options.stats_file)
+text_outputs = list(m5.stats.outputList)
+bench("text", text_url.netloc + text_url.path)
+
+del m5.stats.outputList[:]
+m5.stats.addStatVisitor("bin://%s" % args.binary_file)
+bench("binary", args.binary_file)
+
+# Restore the text output for the final dump at exit
+m5.stats.outputList[:] = text_outputs
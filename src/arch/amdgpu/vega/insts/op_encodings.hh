@@ -593,7 +593,7 @@ namespace VegaISA
             // create request and set flags
             gpuDynInst->resetEntireStatusVector();
             gpuDynInst->setStatusVector(0, 1);
-            RequestPtr req = std::make_shared<Request>(0, 0, 0,
+            RequestPtr req = Request::make(0, 0, 0,
                                        gpuDynInst->computeUnit()->
                                        requestorId(), 0,
                                        gpuDynInst->wfDynId);
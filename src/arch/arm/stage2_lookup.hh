@@ -83,7 +83,7 @@ class Stage2LookUp : public BaseMMU::Translation
         functional(_functional), tranType(_tranType), stage2Te(nullptr),
         fault(NoFault), complete(false), selfDelete(false), secure(_secure)
     {
-        req = std::make_shared<Request>();
+        req = Request::make();
         req->setVirt(s1_te.pAddr(s1Req->getVaddr()), s1Req->getSize(),
                      s1Req->getFlags(), s1Req->requestorId(), 0);
     }
@@ -156,6 +156,25 @@ class InstDecoder : public SimObject
      */
     virtual StaticInstPtr decode(PCStateBase &pc) = 0;
 
+    /**
+     * Summarize the decoder state, other than the instruction bytes
+     * and the PC, that a decoded instruction depends on.
+     *
+     * CPU models may reuse an instruction decoded from the same bytes,
+     * at the same PC and in the same context, without feeding it to
+     * the decoder again. Decoders that do not describe their state
+     * this way, which is the default, must always be used.
+     *
+     * @param pc Instruction pointer of the instruction to decode.
+     * @param context Set to the decoding context.
+     * @return Whether decoded instructions may be reused.
+     */
+    virtual bool
+    decodeContext(const PCStateBase &pc, uint64_t &context) const
+    {
+        return false;
+    }
+
     /**
      * Has decoder been stalled?
      *
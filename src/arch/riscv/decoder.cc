@@ -133,6 +133,21 @@ Decoder::decode(PCStateBase &_next_pc)
     return decode(emi, next_pc.instAddr());
 }
 
+bool
+Decoder::decodeContext(const PCStateBase &pc, uint64_t &context) const
+{
+    // Vector instructions are decoded with the vector configuration
+    // set by the last vset*vl* instruction, which must have executed.
+    if (!vConfigDone)
+        return false;
+
+    context = (uint64_t)machVl |
+              (uint64_t)(machVtype & 0xff) << 32 |
+              (uint64_t)machVtype.vill << 40 |
+              (uint64_t)pc.as<PCState>().rv32() << 41;
+    return true;
+}
+
 void
 Decoder::setVlAndVtype(uint32_t vl, VTYPE vtype)
 {
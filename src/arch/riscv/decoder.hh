@@ -91,6 +91,9 @@ class Decoder : public InstDecoder
 
     StaticInstPtr decode(PCStateBase &nextPC) override;
 
+    bool decodeContext(const PCStateBase &pc,
+                       uint64_t &context) const override;
+
     void setVlAndVtype(uint32_t vl, VTYPE vtype);
 };
 
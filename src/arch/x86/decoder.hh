@@ -353,6 +353,17 @@ class Decoder : public InstDecoder
   public:
     StaticInstPtr decode(PCStateBase &next_pc) override;
 
+    bool
+    decodeContext(const PCStateBase &pc, uint64_t &context) const override
+    {
+        // The predecoding state set from the m5Reg.
+        context = (uint64_t)mode | (uint64_t)submode << 1 |
+                  (uint64_t)cpl << 4 | (uint64_t)defOp << 8 |
+                  (uint64_t)altOp << 10 | (uint64_t)defAddr << 12 |
+                  (uint64_t)altAddr << 14 | (uint64_t)stack << 16;
+        return true;
+    }
+
     StaticInstPtr fetchRomMicroop(
             MicroPC micropc, StaticInstPtr curMacroop) override;
 };
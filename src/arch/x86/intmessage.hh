@@ -91,7 +91,7 @@ namespace X86ISA
     static inline PacketPtr
     buildIntAcknowledgePacket()
     {
-        RequestPtr req = std::make_shared<Request>(
+        RequestPtr req = Request::make(
                 PhysAddrIntA, 1, Request::UNCACHEABLE,
                 Request::intRequestorId);
         PacketPtr pkt = new Packet(req, MemCmd::ReadReq);
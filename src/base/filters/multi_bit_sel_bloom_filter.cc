@@ -45,7 +45,10 @@ namespace bloom_filter
 MultiBitSel::MultiBitSel(const BloomFilterMultiBitSelParams &p)
     : Base(p), numHashes(p.num_hashes),
       parFilterSize(p.size / numHashes),
-      isParallel(p.is_parallel), skipBits(p.skip_bits)
+      isParallel(p.is_parallel), skipBits(p.skip_bits),
+      counters(filter, numHashes,
+               [this](Addr addr, int hash_number)
+               { return hash(addr, hash_number); })
 {
     if (p.size % numHashes) {
         fatal("Can't divide filter (%d) in %d equal portions", p.size,
@@ -60,19 +63,19 @@ MultiBitSel::~MultiBitSel()
 void
 MultiBitSel::set(Addr addr)
 {
-    for (int i = 0; i < numHashes; i++) {
-        filter[hash(addr, i)]++;
-    }
+    counters.set(addr);
+}
+
+void
+MultiBitSel::unset(Addr addr)
+{
+    counters.unset(addr);
 }
 
 int
 MultiBitSel::getCount(Addr addr) const
 {
-    int count = 0;
-    for (int i=0; i < numHashes; i++) {
-        count += filter[hash(addr, i)];
-    }
-    return count;
+    return counters.getCount(addr);
 }
 
 int
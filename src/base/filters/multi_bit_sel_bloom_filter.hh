@@ -31,6 +31,7 @@
 #define __BASE_FILTERS_MULTI_BIT_SEL_BLOOM_FILTER_HH__
 
 #include "base/filters/base.hh"
+#include "base/filters/multi_bit_sel_counters.hh"
 
 namespace gem5
 {
@@ -52,6 +53,14 @@ class MultiBitSel : public Base
     ~MultiBitSel();
 
     void set(Addr addr) override;
+
+    /**
+     * Decrement the entries of an address. Saturated entries may have
+     * been set by more addresses than they can count, so they are
+     * left set to avoid false negatives.
+     */
+    void unset(Addr addr) override;
+
     int getCount(Addr addr) const override;
 
   protected:
@@ -78,6 +87,9 @@ class MultiBitSel : public Base
      * on larger than cache-line granularities, by skipping some bits.
      */
     const int skipBits;
+
+    /** Counting of the addresses in the filter entries. */
+    MultiBitSelCounters counters;
 };
 
 } // namespace bloom_filter
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_FILTERS_MULTI_BIT_SEL_COUNTERS_HH__
+#define __BASE_FILTERS_MULTI_BIT_SEL_COUNTERS_HH__
+
+#include <functional>
+#include <vector>
+
+#include "base/compiler.hh"
+#include "base/sat_counter.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+GEM5_DEPRECATED_NAMESPACE(BloomFilter, bloom_filter);
+namespace bloom_filter
+{
+
+/**
+ * The counting of a MultiBitSel Bloom filter, kept apart from the filter
+ * object. An address maps to one entry per hash function, and each
+ * entry counts the addresses mapped to it, up to its saturation.
+ */
+class MultiBitSelCounters
+{
+  public:
+    /** Entry an address maps to with one of the hash functions. */
+    using Hash = std::function<int(Addr addr, int hash_number)>;
+
+    /**
+     * @param filter The entries of the filter.
+     * @param num_hashes Number of hash functions.
+     * @param hash The hash functions.
+     */
+    MultiBitSelCounters(std::vector<SatCounter8> &filter, int num_hashes,
+                        Hash hash)
+        : filter(filter), numHashes(num_hashes), hash(std::move(hash))
+    {
+    }
+
+    /** Count an address in its entries. */
+    void
+    set(Addr addr)
+    {
+        for (int i = 0; i < numHashes; i++) {
+            filter[hash(addr, i)]++;
+        }
+    }
+
+    /**
+     * Remove an address from the count of its entries. Saturated entries
+     * may have been set by more addresses than they can count, so they
+     * are left set to avoid false negatives.
+     */
+    void
+    unset(Addr addr)
+    {
+        for (int i = 0; i < numHashes; i++) {
+            auto &entry = filter[hash(addr, i)];
+            if (!entry.isSaturated()) {
+                entry--;
+            }
+        }
+    }
+
+    /** Sum of the entries of an address. */
+    int
+    getCount(Addr addr) const
+    {
+        int count = 0;
+        for (int i = 0; i < numHashes; i++) {
+            count += filter[hash(addr, i)];
+        }
+        return count;
+    }
+
+  private:
+    std::vector<SatCounter8> &filter;
+    const int numHashes;
+    const Hash hash;
+};
+
+} // namespace bloom_filter
+} // namespace gem5
+
+#endif // __BASE_FILTERS_MULTI_BIT_SEL_COUNTERS_HH__
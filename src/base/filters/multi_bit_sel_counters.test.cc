@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "base/filters/multi_bit_sel_counters.hh"
+#include "base/sat_counter.hh"
+
+using namespace gem5;
+using namespace gem5::bloom_filter;
+
+namespace
+{
+
+/**
+ * Two hashes over a filter of 8 entries: the first uses the address
+ * itself, the second its upper bits, so that the entries shared by
+ * addresses are easy to tell.
+ */
+int
+testHash(Addr addr, int hash_number)
+{
+    return hash_number ? 4 + (addr / 4) % 4 : addr % 4;
+}
+
+} // anonymous namespace
+
+/** Setting an address counts it in each of its entries. */
+TEST(MultiBitSelCountersTest, Set)
+{
+    std::vector<SatCounter8> filter(8, SatCounter8(4));
+    MultiBitSelCounters counters(filter, 2, testHash);
+
+    EXPECT_EQ(counters.getCount(0x1), 0);
+    counters.set(0x1);
+    EXPECT_EQ(counters.getCount(0x1), 2);
+    EXPECT_EQ(filter[1], 1);
+    EXPECT_EQ(filter[4], 1);
+
+    // 0x5 shares the first entry of 0x1
+    EXPECT_EQ(counters.getCount(0x5), 1);
+    counters.set(0x5);
+    EXPECT_EQ(filter[1], 2);
+    EXPECT_EQ(filter[5], 1);
+    EXPECT_EQ(counters.getCount(0x1), 3);
+    EXPECT_EQ(counters.getCount(0x5), 3);
+}
+
+/** Unsetting an address leaves the addresses sharing its entries set. */
+TEST(MultiBitSelCountersTest, Unset)
+{
+    std::vector<SatCounter8> filter(8, SatCounter8(4));
+    MultiBitSelCounters counters(filter, 2, testHash);
+
+    counters.set(0x1);
+    counters.set(0x5);
+    counters.unset(0x1);
+    EXPECT_EQ(filter[1], 1);
+    EXPECT_EQ(filter[4], 0);
+    EXPECT_EQ(filter[5], 1);
+    EXPECT_EQ(counters.getCount(0x5), 2);
+    EXPECT_EQ(counters.getCount(0x1), 1);
+
+    counters.unset(0x5);
+    for (const auto &entry : filter)
+        EXPECT_EQ(entry, 0);
+}
+
+/** Saturated entries are left set, so there are no false negatives. */
+TEST(MultiBitSelCountersTest, UnsetSaturated)
+{
+    // Two bit entries count up to three addresses
+    std::vector<SatCounter8> filter(8, SatCounter8(2));
+    MultiBitSelCounters counters(filter, 2, testHash);
+
+    // 0x0, 0x10, 0x20 and 0x30 share both of their entries
+    for (Addr addr = 0; addr < 0x40; addr += 0x10)
+        counters.set(addr);
+    EXPECT_TRUE(filter[0].isSaturated());
+    EXPECT_TRUE(filter[4].isSaturated());
+    EXPECT_EQ(counters.getCount(0x30), 6);
+
+    // The entries can't tell how many addresses they hold any more
+    counters.unset(0x0);
+    counters.unset(0x10);
+    counters.unset(0x20);
+    EXPECT_EQ(counters.getCount(0x30), 6);
+
+    // Entries that did not saturate are still decremented
+    counters.set(0x1);
+    counters.unset(0x1);
+    EXPECT_EQ(filter[1], 0);
+    EXPECT_EQ(counters.getCount(0x30), 6);
+}
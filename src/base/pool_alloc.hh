@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_POOL_ALLOC_HH__
+#define __BASE_POOL_ALLOC_HH__
+
+#include <cstddef>
+#include <new>
+
+namespace gem5
+{
+
+/**
+ * Per-thread cache of fixed-size memory blocks.
+ *
+ * Freed blocks are kept on a thread-local free list and handed out
+ * again by the next allocation of the same thread, so the steady state
+ * of an allocate/free heavy object (e.g., packets) does not go through
+ * the general purpose allocator or take any lock. A block may be freed
+ * by a different thread than the one that allocated it; it then simply
+ * joins the free list of the freeing thread. At most MaxCached blocks
+ * are kept per thread, the others are returned to the heap.
+ *
+ * @tparam BlockSize Size of the blocks in bytes.
+ * @tparam MaxCached Maximum number of free blocks cached per thread.
+ */
+template <std::size_t BlockSize, std::size_t MaxCached = 4096>
+class FixedSizePool
+{
+  private:
+    struct Node
+    {
+        Node *next;
+    };
+
+    static_assert(BlockSize >= sizeof(Node),
+                  "Pool blocks must be able to hold a free list link");
+
+    struct FreeList
+    {
+        Node *head = nullptr;
+        std::size_t size = 0;
+
+        ~FreeList()
+        {
+            while (head) {
+                Node *next = head->next;
+                ::operator delete(head);
+                head = next;
+            }
+            size = 0;
+            destroyed() = true;
+        }
+    };
+
+    static FreeList &
+    freeList()
+    {
+        static thread_local FreeList list;
+        return list;
+    }
+
+    /**
+     * Set once the free list of the thread has been destroyed, so that
+     * blocks freed later during thread or program exit go straight
+     * back to the heap. A plain bool has no destructor and stays valid.
+     */
+    static bool &
+    destroyed()
+    {
+        static thread_local bool flag = false;
+        return flag;
+    }
+
+  public:
+    static void *
+    allocate()
+    {
+        if (!destroyed()) {
+            FreeList &list = freeList();
+            if (list.head) {
+                Node *node = list.head;
+                list.head = node->next;
+                --list.size;
+                return node;
+            }
+        }
+        return ::operator new(BlockSize);
+    }
+
+    static void
+    deallocate(void *p)
+    {
+        if (!p)
+            return;
+
+        if (!destroyed()) {
+            FreeList &list = freeList();
+            if (list.size < MaxCached) {
+                Node *node = static_cast<Node *>(p);
+                node->next = list.head;
+                list.head = node;
+                ++list.size;
+                return;
+            }
+        }
+        ::operator delete(p);
+    }
+
+    /** Number of free blocks cached by the calling thread. */
+    static std::size_t
+    cached()
+    {
+        return destroyed() ? 0 : freeList().size;
+    }
+};
+
+/**
+ * Standard allocator drawing single objects from a FixedSizePool.
+ * Arrays are allocated from the heap. It is stateless, so objects
+ * allocated by one instance may be freed by any other one. This is
+ * mostly meant for std::allocate_shared(), which then keeps the object
+ * and its reference counts in a single pooled block.
+ */
+template <typename T>
+class PoolAllocator
+{
+  public:
+    typedef T value_type;
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &) {}
+
+    T *
+    allocate(std::size_t n)
+    {
+        if (n == 1)
+            return static_cast<T *>(FixedSizePool<sizeof(T)>::allocate());
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T *p, std::size_t n)
+    {
+        if (n == 1)
+            FixedSizePool<sizeof(T)>::deallocate(p);
+        else
+            ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U> &) const { return true; }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U> &) const { return false; }
+};
+
+/**
+ * Pooled byte buffers, for payloads whose size is only known at run
+ * time. Sizes are rounded up to a power of two between 16 and 512
+ * bytes and served from the matching FixedSizePool. Larger buffers
+ * come from the heap. The buffer must be freed with the size it was
+ * allocated with.
+ */
+namespace buffer_pool
+{
+
+/** Largest buffer size served from a pool. */
+constexpr std::size_t MaxPooledSize = 512;
+
+inline void *
+allocate(std::size_t size)
+{
+    if (size <= 16)
+        return FixedSizePool<16>::allocate();
+    else if (size <= 32)
+        return FixedSizePool<32>::allocate();
+    else if (size <= 64)
+        return FixedSizePool<64>::allocate();
+    else if (size <= 128)
+        return FixedSizePool<128>::allocate();
+    else if (size <= 256)
+        return FixedSizePool<256>::allocate();
+    else if (size <= MaxPooledSize)
+        return FixedSizePool<MaxPooledSize>::allocate();
+    else
+        return ::operator new(size);
+}
+
+inline void
+deallocate(void *p, std::size_t size)
+{
+    if (size <= 16)
+        FixedSizePool<16>::deallocate(p);
+    else if (size <= 32)
+        FixedSizePool<32>::deallocate(p);
+    else if (size <= 64)
+        FixedSizePool<64>::deallocate(p);
+    else if (size <= 128)
+        FixedSizePool<128>::deallocate(p);
+    else if (size <= 256)
+        FixedSizePool<256>::deallocate(p);
+    else if (size <= MaxPooledSize)
+        FixedSizePool<MaxPooledSize>::deallocate(p);
+    else
+        ::operator delete(p);
+}
+
+} // namespace buffer_pool
+
+} // namespace gem5
+
+#endif // __BASE_POOL_ALLOC_HH__
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "base/pool_alloc.hh"
+
+using namespace gem5;
+
+/** Freed blocks are handed out again, most recently freed first. */
+TEST(PoolAllocTest, Recycle)
+{
+    typedef FixedSizePool<48> Pool;
+
+    void *a = Pool::allocate();
+    void *b = Pool::allocate();
+    ASSERT_NE(a, b);
+    const auto cached = Pool::cached();
+
+    Pool::deallocate(a);
+    Pool::deallocate(b);
+    EXPECT_EQ(Pool::cached(), cached + 2);
+
+    EXPECT_EQ(Pool::allocate(), b);
+    EXPECT_EQ(Pool::allocate(), a);
+    EXPECT_EQ(Pool::cached(), cached);
+
+    Pool::deallocate(a);
+    Pool::deallocate(b);
+}
+
+/** No more than MaxCached free blocks are kept. */
+TEST(PoolAllocTest, Bounded)
+{
+    typedef FixedSizePool<24, 4> Pool;
+
+    std::vector<void *> blocks;
+    for (int i = 0; i < 10; ++i)
+        blocks.push_back(Pool::allocate());
+    for (auto *p : blocks)
+        Pool::deallocate(p);
+    EXPECT_EQ(Pool::cached(), 4);
+}
+
+/** Blocks freed by another thread join that thread's free list. */
+TEST(PoolAllocTest, CrossThreadFree)
+{
+    typedef FixedSizePool<40> Pool;
+
+    void *p = Pool::allocate();
+    const auto cached = Pool::cached();
+    std::thread other([&] () {
+        Pool::deallocate(p);
+        EXPECT_EQ(Pool::cached(), 1);
+        EXPECT_EQ(Pool::allocate(), p);
+        Pool::deallocate(p);
+    });
+    other.join();
+    EXPECT_EQ(Pool::cached(), cached);
+}
+
+/** allocate_shared() keeps the object and its counts in the pool. */
+TEST(PoolAllocTest, SharedPtr)
+{
+    std::weak_ptr<uint64_t> weak;
+    {
+        auto ptr = std::allocate_shared<uint64_t>(
+            PoolAllocator<uint64_t>(), 42);
+        EXPECT_EQ(*ptr, 42);
+        weak = ptr;
+        auto copy = ptr;
+        EXPECT_EQ(ptr.use_count(), 2);
+    }
+    EXPECT_TRUE(weak.expired());
+}
+
+/** Buffers are served by the pool of the next power of two. */
+TEST(PoolAllocTest, Buffers)
+{
+    const std::size_t sizes[] = {
+        1, 16, 17, 64, 100, 256, 300, buffer_pool::MaxPooledSize,
+        buffer_pool::MaxPooledSize + 1, 4096 };
+
+    for (auto size : sizes) {
+        auto *buf = static_cast<uint8_t *>(buffer_pool::allocate(size));
+        for (std::size_t i = 0; i < size; ++i)
+            buf[i] = i;
+        buffer_pool::deallocate(buf, size);
+        if (size > buffer_pool::MaxPooledSize)
+            continue;
+
+        EXPECT_EQ(buffer_pool::allocate(size), buf);
+        buffer_pool::deallocate(buf, size);
+    }
+
+    void *buf = buffer_pool::allocate(64);
+    const auto cached = FixedSizePool<64>::cached();
+    buffer_pool::deallocate(buf, 33);
+    EXPECT_EQ(FixedSizePool<64>::cached(), cached + 1);
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_SPSC_QUEUE_HH__
+#define __BASE_SPSC_QUEUE_HH__
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace gem5
+{
+
+/**
+ * Lock-free, unbounded, single-producer/single-consumer FIFO.
+ *
+ * The queue is a linked list of fixed-size ring segments. The producer
+ * fills the segment at the tail and links a new one when it is full,
+ * so a push never blocks or fails, while the consumer pops from the
+ * segment at the head and retires it once it has been emptied. The
+ * most recently retired segment is kept aside for the producer to
+ * reuse, which avoids allocating in the steady state.
+ *
+ * Exactly one thread may call push() and exactly one (possibly other)
+ * thread may call pop() and empty() at any point in time. Handing
+ * either role over to another thread requires external
+ * synchronization (e.g., a mutex or a barrier).
+ *
+ * @tparam T Type of the elements, must be copy-assignable.
+ * @tparam SegmentSize Number of elements in a ring segment.
+ */
+template <typename T, size_t SegmentSize = 256>
+class SPSCQueue
+{
+  private:
+    static_assert(SegmentSize > 0, "Segments must hold elements");
+
+    struct Segment
+    {
+        /** Number of elements written, published by the producer. */
+        std::atomic<size_t> tail{0};
+        /** Next segment in the list, published by the producer. */
+        std::atomic<Segment *> next{nullptr};
+        /** Number of elements read, only used by the consumer. */
+        size_t head = 0;
+        std::array<T, SegmentSize> slots;
+    };
+
+    /** Segment being filled, only used by the producer. */
+    Segment *producerSeg;
+
+    /** Segment being drained, only used by the consumer. */
+    Segment *consumerSeg;
+
+    /** Retired segment waiting to be reused by the producer. */
+    std::atomic<Segment *> spare{nullptr};
+
+  public:
+    SPSCQueue() : producerSeg(new Segment), consumerSeg(producerSeg) {}
+
+    SPSCQueue(const SPSCQueue &) = delete;
+    SPSCQueue &operator=(const SPSCQueue &) = delete;
+
+    ~SPSCQueue()
+    {
+        while (consumerSeg) {
+            Segment *next = consumerSeg->next.load(std::memory_order_relaxed);
+            delete consumerSeg;
+            consumerSeg = next;
+        }
+        delete spare.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Append an element. Must only be called by the producer.
+     */
+    void
+    push(const T &value)
+    {
+        Segment *seg = producerSeg;
+        size_t tail = seg->tail.load(std::memory_order_relaxed);
+        if (tail == SegmentSize) {
+            Segment *next = spare.exchange(nullptr,
+                                           std::memory_order_acquire);
+            if (next) {
+                next->tail.store(0, std::memory_order_relaxed);
+                next->next.store(nullptr, std::memory_order_relaxed);
+                next->head = 0;
+            } else {
+                next = new Segment;
+            }
+            // Publishing the new segment also publishes its reset state.
+            seg->next.store(next, std::memory_order_release);
+            producerSeg = seg = next;
+            tail = 0;
+        }
+
+        seg->slots[tail] = value;
+        seg->tail.store(tail + 1, std::memory_order_release);
+    }
+
+    /**
+     * Remove the oldest element. Must only be called by the consumer.
+     *
+     * @param value Set to the removed element on success.
+     * @return False if no element was available.
+     */
+    bool
+    pop(T &value)
+    {
+        Segment *seg = consumerSeg;
+        while (true) {
+            if (seg->head < seg->tail.load(std::memory_order_acquire)) {
+                value = seg->slots[seg->head++];
+                return true;
+            }
+
+            if (seg->head < SegmentSize)
+                return false;
+
+            // The segment has been drained and will never be written
+            // again, move on to the next one if the producer linked it.
+            Segment *next = seg->next.load(std::memory_order_acquire);
+            if (!next)
+                return false;
+
+            consumerSeg = next;
+            delete spare.exchange(seg, std::memory_order_acq_rel);
+            seg = next;
+        }
+    }
+
+    /**
+     * Check if there are elements to pop. Must only be called by the
+     * consumer; elements pushed concurrently may or may not be seen.
+     */
+    bool
+    empty() const
+    {
+        const Segment *seg = consumerSeg;
+        if (seg->head < seg->tail.load(std::memory_order_acquire))
+            return false;
+
+        if (seg->head < SegmentSize)
+            return true;
+
+        const Segment *next = seg->next.load(std::memory_order_acquire);
+        return !next || next->tail.load(std::memory_order_acquire) == 0;
+    }
+};
+
+} // namespace gem5
+
+#endif // __BASE_SPSC_QUEUE_HH__
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "base/spsc_queue.hh"
+
+using namespace gem5;
+
+/** An empty queue has nothing to pop. */
+TEST(SPSCQueueTest, Empty)
+{
+    SPSCQueue<int> queue;
+    int value = -1;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.pop(value));
+    EXPECT_EQ(value, -1);
+}
+
+/** Elements come out in FIFO order, across segment boundaries. */
+TEST(SPSCQueueTest, FifoOrder)
+{
+    SPSCQueue<int, 4> queue;
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 11; ++i)
+            queue.push(i);
+        EXPECT_FALSE(queue.empty());
+
+        int value;
+        for (int i = 0; i < 11; ++i) {
+            ASSERT_TRUE(queue.pop(value));
+            EXPECT_EQ(value, i);
+        }
+        EXPECT_TRUE(queue.empty());
+        EXPECT_FALSE(queue.pop(value));
+    }
+}
+
+/** Interleaved pushes and pops on a full segment. */
+TEST(SPSCQueueTest, Interleaved)
+{
+    SPSCQueue<int, 2> queue;
+    int value;
+    queue.push(0);
+    queue.push(1);
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, 0);
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, 1);
+
+    // The first segment is now drained but not retired
+    EXPECT_TRUE(queue.empty());
+    queue.push(2);
+    EXPECT_FALSE(queue.empty());
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, 2);
+    EXPECT_TRUE(queue.empty());
+}
+
+/** A concurrent producer and consumer see every element in order. */
+TEST(SPSCQueueTest, ConcurrentProducerConsumer)
+{
+    const int num_values = 1000000;
+    SPSCQueue<int, 64> queue;
+
+    std::thread producer([&] () {
+        for (int i = 0; i < num_values; ++i)
+            queue.push(i);
+    });
+
+    int expected = 0;
+    int value;
+    while (expected < num_values) {
+        if (queue.pop(value)) {
+            ASSERT_EQ(value, expected);
+            ++expected;
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(queue.empty());
+}
@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/binary.hh"
+
+#include <cassert>
+
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "base/stats/info.hh"
+#include "sim/cur_tick.hh"
+
+namespace gem5
+{
+
+namespace statistics
+{
+
+Binary::Binary(std::ostream &_stream, bool desc)
+    : stream(_stream), enableDescriptions(desc),
+      schemaPos(0), schemaMatches(true), schemaCount(0)
+{
+    stream.write(magic, sizeof(magic));
+    write(version);
+    write(byteOrderMarker);
+}
+
+void
+Binary::begin()
+{
+    assert(path.empty());
+
+    values.clear();
+    pending.clear();
+    schemaPos = 0;
+    schemaMatches = true;
+}
+
+void
+Binary::end()
+{
+    assert(path.empty());
+
+    if (schemaMatches && schemaPos < schema.size()) {
+        // The dump visited a prefix of the schema, so the schema for
+        // this dump is that prefix.
+        pending.assign(schema.begin(), schema.begin() + schemaPos);
+        schemaMatches = false;
+    }
+
+    if (!schemaMatches || schemaCount == 0) {
+        schema = std::move(pending);
+        pending.clear();
+        writeSchema();
+    }
+
+    write(RecordDump);
+    write(uint32_t(schemaCount - 1));
+    write(uint64_t(curTick()));
+    write(uint64_t(values.size()));
+    stream.write(reinterpret_cast<const char *>(values.data()),
+                 values.size() * sizeof(double));
+    stream.flush();
+}
+
+bool
+Binary::valid() const
+{
+    return stream.good();
+}
+
+void
+Binary::beginGroup(const char *name)
+{
+    if (path.empty())
+        path.emplace_back(name);
+    else
+        path.emplace_back(path.back() + "." + name);
+}
+
+void
+Binary::endGroup()
+{
+    assert(!path.empty());
+    path.pop_back();
+}
+
+void
+Binary::addEntry(const Info &info, Kind kind, size_t size)
+{
+    if (schemaMatches) {
+        if (schemaPos < schema.size() && schema[schemaPos].info == &info &&
+            schema[schemaPos].size == size) {
+            ++schemaPos;
+            return;
+        }
+
+        // The dump no longer matches the schema. Start a new one with
+        // the stats matched so far.
+        pending.assign(schema.begin(), schema.begin() + schemaPos);
+        schemaMatches = false;
+    }
+
+    pending.push_back({&info, kind, size,
+                       path.empty() ? info.name :
+                                      path.back() + "." + info.name});
+}
+
+void
+Binary::visit(const ScalarInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    addEntry(info, KindScalar, 1);
+    values.push_back(info.result());
+}
+
+void
+Binary::visit(const VectorInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const VResult &vr = info.result();
+    addEntry(info, KindVector, vr.size());
+    values.insert(values.end(), vr.begin(), vr.end());
+}
+
+void
+Binary::appendDist(const DistData &data)
+{
+    values.push_back(data.samples);
+    values.push_back(data.sum);
+    values.push_back(data.squares);
+    values.push_back(data.logs);
+    values.push_back(data.min_val);
+    values.push_back(data.max_val);
+    values.push_back(data.underflow);
+    values.push_back(data.overflow);
+    values.insert(values.end(), data.cvec.begin(), data.cvec.end());
+}
+
+void
+Binary::visit(const DistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    addEntry(info, KindDist, distHeaderSize + info.data.cvec.size());
+    appendDist(info.data);
+}
+
+void
+Binary::visit(const VectorDistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    size_t size = 0;
+    for (const auto &data : info.data)
+        size += distHeaderSize + data.cvec.size();
+
+    addEntry(info, KindVectorDist, size);
+    for (const auto &data : info.data)
+        appendDist(data);
+}
+
+void
+Binary::visit(const Vector2dInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    addEntry(info, KindVector2d, info.cvec.size());
+    values.insert(values.end(), info.cvec.begin(), info.cvec.end());
+}
+
+void
+Binary::visit(const FormulaInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const VResult &vr = info.result();
+    addEntry(info, KindFormula, vr.size());
+    values.insert(values.end(), vr.begin(), vr.end());
+}
+
+void
+Binary::visit(const SparseHistInfo &info)
+{
+    warn_once("Binary stat files don't support sparse histograms.\n");
+}
+
+void
+Binary::writeString(const std::string &str)
+{
+    write(uint32_t(str.size()));
+    stream.write(str.data(), str.size());
+}
+
+void
+Binary::writeStrings(const std::vector<std::string> &strs)
+{
+    write(uint32_t(strs.size()));
+    for (const auto &str : strs)
+        writeString(str);
+}
+
+void
+Binary::writeSchema()
+{
+    write(RecordSchema);
+    write(uint32_t(schemaCount++));
+    write(uint64_t(schema.size()));
+    for (const auto &entry : schema)
+        writeEntry(entry);
+}
+
+void
+Binary::writeEntry(const Entry &entry)
+{
+    static const std::vector<std::string> none;
+
+    const Info &info = *entry.info;
+    const std::vector<std::string> *subnames = &none;
+    const std::vector<std::string> *y_subnames = &none;
+    std::vector<double> params;
+
+    auto dist_params = [&params](const DistData &data) {
+        params = { double(data.type), data.min, data.max,
+                   data.bucket_size, double(data.cvec.size()) };
+    };
+
+    switch (entry.kind) {
+      case KindVector:
+      case KindFormula:
+        subnames = &static_cast<const VectorInfo &>(info).subnames;
+        break;
+      case KindDist:
+        dist_params(static_cast<const DistInfo &>(info).data);
+        break;
+      case KindVectorDist:
+        {
+            const auto &vdist = static_cast<const VectorDistInfo &>(info);
+            subnames = &vdist.subnames;
+            if (!vdist.data.empty())
+                dist_params(vdist.data.front());
+        }
+        break;
+      case KindVector2d:
+        {
+            const auto &v2d = static_cast<const Vector2dInfo &>(info);
+            subnames = &v2d.subnames;
+            y_subnames = &v2d.y_subnames;
+            params = { double(v2d.x), double(v2d.y) };
+        }
+        break;
+      default:
+        break;
+    }
+
+    write(entry.kind);
+    write(uint64_t(entry.size));
+    writeString(entry.name);
+    writeString(info.unit->getUnitString());
+    writeString(enableDescriptions ? info.desc : std::string());
+    writeStrings(*subnames);
+    writeStrings(*y_subnames);
+    write(uint32_t(params.size()));
+    for (double param : params)
+        write(param);
+}
+
+std::unique_ptr<Output>
+initBinary(const std::string &filename, bool desc)
+{
+    OutputStream *os = simout.create(filename, true, true);
+    return std::unique_ptr<Output>(new Binary(*os->stream(), desc));
+}
+
+} // namespace statistics
+} // namespace gem5
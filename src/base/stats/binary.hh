@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_BINARY_HH__
+#define __BASE_STATS_BINARY_HH__
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+
+namespace gem5
+{
+
+namespace statistics
+{
+
+/**
+ * Compact binary stat output.
+ *
+ * The file starts with a header followed by a sequence of records. A
+ * schema record describes every stat in a dump: its name, kind,
+ * unit, description, subnames and the number of values it
+ * contributes. A dump record holds the simulated tick and the values
+ * of all stats as a flat array of doubles, in schema order.
+ *
+ * The schema is written on the first dump and then only when the
+ * set of stats visited changes (e.g., when dumping a subset of the
+ * hierarchy), so periodic dumps cost little more than the raw values.
+ * All fields are stored in host byte order; the header records a byte
+ * order marker so readers can tell. The format is read by the
+ * m5.stats.binary Python module.
+ */
+class Binary : public Output
+{
+  public:
+    /** The stat kinds stored in the schema. */
+    enum Kind : uint8_t
+    {
+        KindScalar = 0,
+        KindVector = 1,
+        KindDist = 2,
+        KindVectorDist = 3,
+        KindVector2d = 4,
+        KindFormula = 5,
+    };
+
+    /** The record types following the header. */
+    enum Record : uint8_t
+    {
+        RecordSchema = 'S',
+        RecordDump = 'D',
+    };
+
+    static constexpr char magic[8] = { 'g', 'e', 'm', '5',
+                                       's', 'b', 'i', 'n' };
+    static constexpr uint32_t version = 1;
+    static constexpr uint32_t byteOrderMarker = 0x01020304;
+
+    /**
+     * Number of values a distribution contributes ahead of its
+     * buckets: samples, sum, squares, logs, min_val, max_val,
+     * underflow and overflow.
+     */
+    static constexpr size_t distHeaderSize = 8;
+
+    Binary(std::ostream &stream, bool desc);
+
+    Binary() = delete;
+    Binary(const Binary &other) = delete;
+
+  public: // Output interface
+    void begin() override;
+    void end() override;
+    bool valid() const override;
+
+    void beginGroup(const char *name) override;
+    void endGroup() override;
+
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+
+  protected:
+    /** A stat in the current schema. */
+    struct Entry
+    {
+        const Info *info;
+        Kind kind;
+        /** Number of values the stat contributes to a dump. */
+        size_t size;
+        /** Full name, including the group path. */
+        std::string name;
+    };
+
+    /**
+     * Note that the stat info is about to add size values to the
+     * current dump. Checks the stat against the current schema and
+     * starts a new one if they don't match.
+     */
+    void addEntry(const Info &info, Kind kind, size_t size);
+
+    void appendDist(const DistData &data);
+
+    void writeSchema();
+    void writeEntry(const Entry &entry);
+
+    void writeString(const std::string &str);
+    void writeStrings(const std::vector<std::string> &strs);
+
+    template <typename T>
+    void
+    write(const T &value)
+    {
+        stream.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+  protected:
+    std::ostream &stream;
+    const bool enableDescriptions;
+
+    /** Current group path, used to name stats new to a schema. */
+    std::vector<std::string> path;
+
+    /** Stats of the last schema written. */
+    std::vector<Entry> schema;
+    /** Stats visited so far in the current dump. */
+    std::vector<Entry> pending;
+    /** Number of schema entries matched by the current dump. */
+    size_t schemaPos;
+    /**
+     * Whether the current dump matches the schema so far. Once it
+     * diverges, pending describes the schema for this dump.
+     */
+    bool schemaMatches;
+    /** Number of schema records written. */
+    uint32_t schemaCount;
+
+    /** Values of the current dump. */
+    std::vector<double> values;
+};
+
+std::unique_ptr<Output> initBinary(const std::string &filename,
+                                   bool desc = true);
+
+} // namespace statistics
+} // namespace gem5
+
+#endif // __BASE_STATS_BINARY_HH__
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include "base/gtest/cur_tick_fake.hh"
+#include "base/stats/binary.hh"
+#include "base/stats/group.hh"
+#include "base/stats/info.hh"
+
+using namespace gem5;
+
+// The binary output reads the current tick when dumping
+GTestTickHandler tickHandler;
+
+namespace
+{
+
+class DummyScalar : public statistics::ScalarInfo
+{
+  public:
+    explicit DummyScalar(const std::string &_name)
+    {
+        setName(_name, false);
+        flags.set(statistics::display);
+    }
+
+    statistics::Counter val = 0;
+
+    bool check() const override { return true; }
+    void prepare() override {}
+    void reset() override { val = 0; }
+    bool zero() const override { return val == 0; }
+    void visit(statistics::Output &visitor) override { visitor.visit(*this); }
+
+    statistics::Counter value() const override { return val; }
+    statistics::Result result() const override { return val; }
+    statistics::Result total() const override { return val; }
+};
+
+/** Minimal parser for the records written by statistics::Binary. */
+class BinaryParser
+{
+  public:
+    explicit BinaryParser(const std::string &_data) : data(_data) {}
+
+    template <typename T>
+    T
+    get()
+    {
+        T value;
+        std::memcpy(&value, data.data() + pos, sizeof(value));
+        pos += sizeof(value);
+        return value;
+    }
+
+    std::string
+    getString()
+    {
+        auto len = get<uint32_t>();
+        std::string str = data.substr(pos, len);
+        pos += len;
+        return str;
+    }
+
+    void
+    skipStrings()
+    {
+        for (auto count = get<uint32_t>(); count; --count)
+            getString();
+    }
+
+    bool done() const { return pos == data.size(); }
+
+  private:
+    const std::string data;
+    size_t pos = 0;
+};
+
+void
+dump(statistics::Binary &output, statistics::Group &root)
+{
+    output.begin();
+    root.visitStats(output);
+    output.end();
+}
+
+/** Check a schema record and return the stat names it contains. */
+std::vector<std::string>
+parseSchema(BinaryParser &parser, uint32_t id)
+{
+    EXPECT_EQ(parser.get<uint8_t>(), statistics::Binary::RecordSchema);
+    EXPECT_EQ(parser.get<uint32_t>(), id);
+
+    std::vector<std::string> names;
+    for (auto count = parser.get<uint64_t>(); count; --count) {
+        EXPECT_EQ(parser.get<uint8_t>(), statistics::Binary::KindScalar);
+        EXPECT_EQ(parser.get<uint64_t>(), 1);
+        names.push_back(parser.getString());
+        parser.getString(); // unit
+        parser.getString(); // description
+        parser.skipStrings(); // subnames
+        parser.skipStrings(); // y_subnames
+        EXPECT_EQ(parser.get<uint32_t>(), 0);
+    }
+    return names;
+}
+
+/** Check a dump record and return its values. */
+std::vector<double>
+parseDump(BinaryParser &parser, uint32_t schema, Tick tick)
+{
+    EXPECT_EQ(parser.get<uint8_t>(), statistics::Binary::RecordDump);
+    EXPECT_EQ(parser.get<uint32_t>(), schema);
+    EXPECT_EQ(parser.get<uint64_t>(), tick);
+
+    std::vector<double> values;
+    for (auto count = parser.get<uint64_t>(); count; --count)
+        values.push_back(parser.get<double>());
+    return values;
+}
+
+void
+parseHeader(BinaryParser &parser)
+{
+    for (char c : statistics::Binary::magic)
+        ASSERT_EQ(parser.get<char>(), c);
+    ASSERT_EQ(parser.get<uint32_t>(), statistics::Binary::version);
+    ASSERT_EQ(parser.get<uint32_t>(),
+              statistics::Binary::byteOrderMarker);
+}
+
+} // anonymous namespace
+
+/** Test that the schema is written once for repeated dumps. */
+TEST(StatsBinaryTest, SchemaWrittenOnce)
+{
+    statistics::Group root(nullptr);
+    statistics::Group node(&root, "node");
+    DummyScalar a("a"), b("b");
+    root.addStat(&a);
+    node.addStat(&b);
+
+    std::stringstream ss;
+    statistics::Binary output(ss, true);
+
+    a.val = 1;
+    b.val = 2;
+    tickHandler.setCurTick(100);
+    dump(output, root);
+
+    a.val = 3;
+    b.val = 4;
+    tickHandler.setCurTick(200);
+    dump(output, root);
+
+    BinaryParser parser(ss.str());
+    parseHeader(parser);
+    EXPECT_EQ(parseSchema(parser, 0),
+              std::vector<std::string>({ "a", "node.b" }));
+    EXPECT_EQ(parseDump(parser, 0, 100), std::vector<double>({ 1, 2 }));
+    EXPECT_EQ(parseDump(parser, 0, 200), std::vector<double>({ 3, 4 }));
+    EXPECT_TRUE(parser.done());
+}
+
+/** Test that dumping a different set of stats starts a new schema. */
+TEST(StatsBinaryTest, SchemaChange)
+{
+    statistics::Group root(nullptr);
+    statistics::Group node(&root, "node");
+    DummyScalar a("a"), b("b");
+    root.addStat(&a);
+    node.addStat(&b);
+
+    std::stringstream ss;
+    statistics::Binary output(ss, true);
+
+    tickHandler.setCurTick(100);
+    dump(output, root);
+
+    // Dump only the sub-group, as when dumping selected roots
+    tickHandler.setCurTick(200);
+    output.begin();
+    output.beginGroup("node");
+    node.visitStats(output);
+    output.endGroup();
+    output.end();
+
+    // And the whole tree again
+    b.val = 5;
+    tickHandler.setCurTick(300);
+    dump(output, root);
+
+    BinaryParser parser(ss.str());
+    parseHeader(parser);
+    EXPECT_EQ(parseSchema(parser, 0),
+              std::vector<std::string>({ "a", "node.b" }));
+    EXPECT_EQ(parseDump(parser, 0, 100), std::vector<double>({ 0, 0 }));
+    EXPECT_EQ(parseSchema(parser, 1),
+              std::vector<std::string>({ "node.b" }));
+    EXPECT_EQ(parseDump(parser, 1, 200), std::vector<double>({ 0 }));
+    EXPECT_EQ(parseSchema(parser, 2),
+              std::vector<std::string>({ "a", "node.b" }));
+    EXPECT_EQ(parseDump(parser, 2, 300), std::vector<double>({ 0, 5 }));
+    EXPECT_TRUE(parser.done());
+}
+
+/** Test that stats without the display flag are not written. */
+TEST(StatsBinaryTest, NoDisplay)
+{
+    statistics::Group root(nullptr);
+    DummyScalar a("a"), hidden("hidden");
+    hidden.flags.clear(statistics::display);
+    root.addStat(&a);
+    root.addStat(&hidden);
+
+    std::stringstream ss;
+    statistics::Binary output(ss, false);
+
+    tickHandler.setCurTick(100);
+    dump(output, root);
+
+    BinaryParser parser(ss.str());
+    parseHeader(parser);
+    EXPECT_EQ(parseSchema(parser, 0), std::vector<std::string>({ "a" }));
+    EXPECT_EQ(parseDump(parser, 0, 100), std::vector<double>({ 0 }));
+    EXPECT_TRUE(parser.done());
+}
@@ -41,6 +41,7 @@
 #include "base/logging.hh"
 #include "base/named.hh"
 #include "base/stats/info.hh"
+#include "base/stats/output.hh"
 #include "base/trace.hh"
 #include "debug/Stats.hh"
 
@@ -189,5 +190,18 @@ Group::getStats() const
     return stats;
 }
 
+void
+Group::visitStats(Output &visitor) const
+{
+    for (auto *info : stats)
+        info->visit(visitor);
+
+    for (const auto &[name, group] : statGroups) {
+        visitor.beginGroup(name.c_str());
+        group->visitStats(visitor);
+        visitor.endGroup();
+    }
+}
+
 } // namespace statistics
 } // namespace gem5
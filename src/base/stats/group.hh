@@ -79,6 +79,7 @@ namespace statistics
 {
 
 class Info;
+struct Output;
 
 /**
  * Statistics container.
@@ -177,6 +178,18 @@ class Group
      */
     const std::vector<Info *> &getStats() const;
 
+    /**
+     * Visit all stats in this group and its children.
+     *
+     * Stats are visited before child groups, and child groups are
+     * visited in name order wrapped in Output::beginGroup() and
+     * Output::endGroup() calls. This matches the order used when
+     * dumping stats from Python.
+     *
+     * @param visitor Output to pass each stat to.
+     */
+    void visitStats(Output &visitor) const;
+
      /**
      * Add a stat block as a child of this block
      *
@@ -40,7 +40,7 @@ ActivityRecorder::ActivityRecorder(const std::string &name, int num_stages,
     int longest_latency, int activity)
     : _name(name), activityBuffer(longest_latency, 0),
       longestLatency(longest_latency), activityCount(activity),
-      numStages(num_stages)
+      commCount(0), numStages(num_stages)
 {
     stageActive = new bool[numStages];
     std::memset(stageActive, 0, numStages);
@@ -64,6 +64,7 @@ ActivityRecorder::activity()
     activityBuffer[0] = true;
 
     ++activityCount;
+    ++commCount;
 
     DPRINTF(Activity, "Activity without stage: %i\n", activityCount);
 }
@@ -75,8 +76,10 @@ ActivityRecorder::advance()
     // time buffer advances, then decrement the activityCount.
     if (activityBuffer[-longestLatency]) {
         --activityCount;
+        --commCount;
 
         assert(activityCount >= 0);
+        assert(commCount >= 0);
 
         DPRINTF(Activity, "Longestlatency:%i Activity: %i\n",
         longestLatency, activityCount);
@@ -129,6 +132,7 @@ void
 ActivityRecorder::reset()
 {
     activityCount = 0;
+    commCount = 0;
     std::memset(stageActive, 0, numStages);
     for (int i = 0; i < longestLatency + 1; ++i)
         activityBuffer.advance();
@@ -162,6 +166,8 @@ ActivityRecorder::validate()
         }
     }
 
+    assert(count == commCount);
+
     for (int i = 0; i < numStages; ++i) {
         if (stageActive[i]) {
             count++;
@@ -90,6 +90,11 @@ class ActivityRecorder
     /** Returns if the CPU should be active. */
     bool active() { return activityCount; }
 
+    /** Returns if there is communication in flight in any time buffer,
+     *  regardless of the stages' status.
+     */
+    bool commInFlight() const { return commCount; }
+
     /** Clears the time buffer and the activity count. */
     void reset();
 
@@ -131,6 +136,11 @@ class ActivityRecorder
      */
     int activityCount;
 
+    /** Number of cycles in the activity buffer that had communication.
+     *  Unlike activityCount, this doesn't include the active stages.
+     */
+    int commCount;
+
     /** Number of stages that can be marked as active or inactive. */
     int numStages;
 
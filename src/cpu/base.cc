@@ -242,7 +242,7 @@ BaseCPU::mwaitAtomic(ThreadID tid, ThreadContext *tc, BaseMMU *mmu)
     assert(tid < numThreads);
     AddressMonitor &monitor = addressMonitor[tid];
 
-    RequestPtr req = std::make_shared<Request>();
+    RequestPtr req = Request::make();
 
     Addr addr = monitor.vAddr;
     int block_size = cacheLineSize();
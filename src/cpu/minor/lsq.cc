@@ -72,7 +72,7 @@ LSQ::LSQRequest::LSQRequest(LSQ &port_, MinorDynInstPtr inst_, bool isLoad_,
     isTranslationDelayed(false),
     state(NotIssued)
 {
-    request = std::make_shared<Request>();
+    request = Request::make();
 }
 
 void
@@ -494,7 +494,7 @@ LSQ::SplitDataRequest::makeFragmentRequests()
             }
         }
 
-        RequestPtr fragment = std::make_shared<Request>();
+        RequestPtr fragment = Request::make();
         bool disabled_fragment = false;
 
         fragment->setContext(request->contextId());
@@ -72,6 +72,9 @@ class BaseO3CPU(BaseCPU):
         return True
 
     activity = Param.Unsigned(0, "Initial count")
+    skipIdleStages = Param.Bool(False, "Skip the tick of stages that have "
+        "no activity and no time buffer communication in flight. Skipped "
+        "ticks don't update the stages' per-cycle stats.")
 
     cacheStorePorts = Param.Unsigned(200, "Cache Ports. "
           "Constrains stores only.")
@@ -101,7 +101,7 @@ Commit::Commit(CPU *_cpu, const BaseO3CPUParams &params)
 {
     if (commitWidth > MaxWidth)
         fatal("commitWidth (%d) is larger than compiled limit (%d),\n"
-             "\tincrease MaxWidth in src/cpu/o3/limits.hh\n",
+             "\trebuild with a larger O3_MAX_WIDTH\n",
              commitWidth, static_cast<int>(MaxWidth));
 
     _status = Active;
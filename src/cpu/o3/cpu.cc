@@ -77,6 +77,7 @@ CPU::CPU(const BaseO3CPUParams &params)
                 false, Event::CPU_Tick_Pri),
       threadExitEvent([this]{ exitThreads(); }, "O3CPU exit threads",
                 false, Event::CPU_Exit_Pri),
+      dynInstPool(this),
 #ifndef NDEBUG
       instcount(0),
 #endif
@@ -110,6 +111,7 @@ CPU::CPU(const BaseO3CPUParams &params)
       activityRec(name(), NumStages,
                   params.backComSize + params.forwardComSize,
                   params.activity),
+      skipIdleStages(params.skipIdleStages),
 
       globalSeqNum(1),
       system(params.system),
@@ -184,8 +186,8 @@ CPU::CPU(const BaseO3CPUParams &params)
         active_threads = params.workload.size();
 
         if (active_threads > MaxThreads) {
-            panic("Workload Size too large. Increase the 'MaxThreads' "
-                  "constant in cpu/o3/limits.hh or edit your workload size.");
+            panic("Workload Size too large. Rebuild with a larger "
+                  "O3_MAX_THREADS or edit your workload size.");
         }
     }
 
@@ -327,6 +329,9 @@ CPU::CPUStats::CPUStats(CPU *cpu)
       ADD_STAT(quiesceCycles, statistics::units::Cycle::get(),
                "Total number of cycles that CPU has spent quiesced or waiting "
                "for an interrupt"),
+      ADD_STAT(idleStageCycles, statistics::units::Cycle::get(),
+               "Number of cycles each stage skipped its tick while the CPU "
+               "was running, as it had nothing to do"),
       ADD_STAT(committedInsts, statistics::units::Count::get(),
                "Number of Instructions Simulated"),
       ADD_STAT(committedOps, statistics::units::Count::get(),
@@ -378,6 +383,16 @@ CPU::CPUStats::CPUStats(CPU *cpu)
     quiesceCycles
         .prereq(quiesceCycles);
 
+    idleStageCycles
+        .init(cpu->NumStages)
+        .subname(cpu->FetchIdx, "fetch")
+        .subname(cpu->DecodeIdx, "decode")
+        .subname(cpu->RenameIdx, "rename")
+        .subname(cpu->IEWIdx, "iew")
+        .subname(cpu->CommitIdx, "commit")
+        .flags(statistics::total)
+        .prereq(idleStageCycles);
+
     // Number of Instructions simulated
     // --------------------------------
     // Should probably be in Base CPU but need templated
@@ -455,16 +470,25 @@ CPU::tick()
 
 //    activity = false;
 
-    //Tick each of the stages
-    fetch.tick();
+    //Tick each of the stages, skipping those with nothing to do.
+    // Whether a stage is idle is checked right before it ticks, as
+    // the stages before it may have written to the time buffers.
+    auto tick_stage = [this](StageIdx idx, auto &stage) {
+        if (stageIdle(idx))
+            cpuStats.idleStageCycles[idx]++;
+        else
+            stage.tick();
+    };
+
+    tick_stage(FetchIdx, fetch);
 
-    decode.tick();
+    tick_stage(DecodeIdx, decode);
 
-    rename.tick();
+    tick_stage(RenameIdx, rename);
 
-    iew.tick();
+    tick_stage(IEWIdx, iew);
 
-    commit.tick();
+    tick_stage(CommitIdx, commit);
 
     // Now advance the time buffers
     timeBuffer.advance();
@@ -958,8 +982,13 @@ CPU::drainResume()
     }
 
     assert(!tickEvent.scheduled());
-    if (_status == Running)
+    if (_status == Running) {
+        // The stages' status was lost when switching out, so let them
+        // all tick until they have worked it out again.
+        if (skipIdleStages)
+            activityRec.activity();
         schedule(tickEvent, nextCycle());
+    }
 
     // Reschedule any power gating event (if any)
     schedulePowerGatingEvent();
@@ -1209,12 +1238,10 @@ CPU::squashFromTC(ThreadID tid)
     commit.generateTCEvent(tid);
 }
 
-CPU::ListIt
+void
 CPU::addInst(const DynInstPtr &inst)
 {
-    instList.push_back(inst);
-
-    return --(instList.end());
+    instList.push_back(inst.get());
 }
 
 void
@@ -1246,7 +1273,7 @@ CPU::removeFrontInst(const DynInstPtr &inst)
     removeInstsThisCycle = true;
 
     // Remove the front instruction.
-    removeList.push(inst->getInstListIt());
+    removeList.push(instList.iteratorTo(inst.get()));
 }
 
 void
@@ -1266,7 +1293,7 @@ CPU::removeInstsNotInROB(ThreadID tid)
         end_it = instList.begin();
         rob_empty = true;
     } else {
-        end_it = (rob.readTailInst(tid))->getInstListIt();
+        end_it = instList.iteratorTo(rob.readTailInst(tid).get());
         DPRINTF(O3CPU, "ROB is not empty, squashing insts not in ROB.\n");
     }
 
@@ -1395,8 +1422,12 @@ CPU::wakeDependents(const DynInstPtr &inst)
 void
 CPU::wakeCPU()
 {
+    // Whatever woke the CPU has work for a stage that it didn't pass
+    // through the time buffers, so keep the stages from skipping it.
     if (activityRec.active() || tickEvent.scheduled()) {
         DPRINTF(Activity, "CPU already running.\n");
+        if (skipIdleStages)
+            activityRec.activity();
         return;
     }
 
@@ -1410,6 +1441,8 @@ CPU::wakeCPU()
         baseStats.numCycles += cycles;
     }
 
+    if (skipIdleStages)
+        activityRec.activity();
     schedule(tickEvent, clockEdge());
 }
 
@@ -1537,7 +1570,7 @@ CPU::htmSendAbortSignal(ThreadID tid, uint64_t htm_uid,
 
     // notify l1 d-cache (ruby) that core has aborted transaction
     RequestPtr req =
-        std::make_shared<Request>(addr, size, flags, _dataRequestorId);
+        Request::make(addr, size, flags, _dataRequestorId);
 
     req->taskId(taskId());
     req->setContext(thread[tid]->contextId());
@@ -55,10 +55,12 @@
 #include "cpu/o3/comm.hh"
 #include "cpu/o3/commit.hh"
 #include "cpu/o3/decode.hh"
+#include "cpu/o3/dyn_inst_pool.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
 #include "cpu/o3/fetch.hh"
 #include "cpu/o3/free_list.hh"
 #include "cpu/o3/iew.hh"
+#include "cpu/o3/inst_list.hh"
 #include "cpu/o3/limits.hh"
 #include "cpu/o3/rename.hh"
 #include "cpu/o3/rob.hh"
@@ -94,7 +96,7 @@ class ThreadContext;
 class CPU : public BaseCPU
 {
   public:
-    typedef std::list<DynInstPtr>::iterator ListIt;
+    typedef InstList<DynInst, CPUInstList>::iterator ListIt;
 
     friend class ThreadContext;
 
@@ -346,7 +348,7 @@ class CPU : public BaseCPU
     /** Function to add instruction onto the head of the list of the
      *  instructions.  Used when new instructions are fetched.
      */
-    ListIt addInst(const DynInstPtr &inst);
+    void addInst(const DynInstPtr &inst);
 
     /** Function to tell the CPU that an instruction has completed. */
     void instDone(ThreadID tid, const DynInstPtr &inst);
@@ -373,13 +375,19 @@ class CPU : public BaseCPU
     void dumpInsts();
 
   public:
+    /**
+     * Storage of the dynamic instructions. It must outlive all the
+     * structures holding instructions below.
+     */
+    DynInstPool dynInstPool;
+
 #ifndef NDEBUG
     /** Count of total number of dynamic instructions in flight. */
     int instcount;
 #endif
 
     /** List of all the instructions in flight. */
-    std::list<DynInstPtr> instList;
+    InstList<DynInst, CPUInstList> instList;
 
     /** List of all the instructions that will be removed at the end of this
      *  cycle.
@@ -481,6 +489,20 @@ class CPU : public BaseCPU
      */
     ActivityRecorder activityRec;
 
+    /** Whether stages with nothing to do skip their tick. */
+    const bool skipIdleStages;
+
+    /** Returns if a stage has nothing to do this cycle: it has no
+     *  internal activity, and there is no communication in flight in
+     *  the time buffers that it might have to read.
+     */
+    bool
+    stageIdle(StageIdx idx) const
+    {
+        return skipIdleStages && !activityRec.getStageActive(idx) &&
+            !activityRec.commInFlight();
+    }
+
   public:
     /** Records that there was time buffer activity this cycle. */
     void activityThisCycle() { activityRec.activity(); }
@@ -582,6 +604,9 @@ class CPU : public BaseCPU
         /** Stat for total number of cycles the CPU spends descheduled due to a
          * quiesce operation or waiting for an interrupt. */
         statistics::Scalar quiesceCycles;
+        /** Stat for the number of stage ticks skipped while the CPU was
+         *  running, per stage. */
+        statistics::Vector idleStageCycles;
         /** Stat for the number of committed instructions per thread. */
         statistics::Vector committedInsts;
         /** Stat for the number of committed ops (including micro ops) per
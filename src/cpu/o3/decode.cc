@@ -74,7 +74,7 @@ Decode::Decode(CPU *_cpu, const BaseO3CPUParams &params)
 {
     if (decodeWidth > MaxWidth)
         fatal("decodeWidth (%d) is larger than compiled limit (%d),\n"
-             "\tincrease MaxWidth in src/cpu/o3/limits.hh\n",
+             "\trebuild with a larger O3_MAX_WIDTH\n",
              decodeWidth, static_cast<int>(MaxWidth));
 
     // @todo: Make into a parameter
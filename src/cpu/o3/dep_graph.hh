@@ -81,7 +81,8 @@ class DependencyGraph
 
     /** Default construction.  Must call resize() prior to use. */
     DependencyGraph()
-        : numEntries(0), memAllocCounter(0), nodesTraversed(0), nodesRemoved(0)
+        : numEntries(0), freeEntries(NULL), memAllocCounter(0),
+          nodesTraversed(0), nodesRemoved(0)
     { }
 
     ~DependencyGraph();
@@ -120,6 +121,12 @@ class DependencyGraph
     void dump();
 
   private:
+    /** Gets a node off the free list, or allocates one if it is empty. */
+    DepEntry *allocEntry();
+
+    /** Returns a node to the free list. */
+    void freeEntry(DepEntry *entry);
+
     /** Array of linked lists.  Each linked list is a list of all the
      *  instructions that depend upon a given register.  The actual
      *  register's index is used to index into the graph; ie all
@@ -131,6 +138,12 @@ class DependencyGraph
     /** Number of linked lists; identical to the number of registers. */
     int numEntries;
 
+    /** Nodes no longer on any list.  Dependencies are added and removed
+     *  on every instruction, so the nodes are recycled rather than going
+     *  through the heap each time.
+     */
+    DepEntry *freeEntries;
+
     // Debug variable, remove when done testing.
     unsigned memAllocCounter;
 
@@ -144,6 +157,34 @@ class DependencyGraph
 template <class DynInstPtr>
 DependencyGraph<DynInstPtr>::~DependencyGraph()
 {
+    reset();
+
+    while (freeEntries) {
+        DepEntry *entry = freeEntries;
+        freeEntries = entry->next;
+        delete entry;
+    }
+}
+
+template <class DynInstPtr>
+typename DependencyGraph<DynInstPtr>::DepEntry *
+DependencyGraph<DynInstPtr>::allocEntry()
+{
+    DepEntry *entry = freeEntries;
+    if (entry) {
+        freeEntries = entry->next;
+        return entry;
+    }
+    return new DepEntry;
+}
+
+template <class DynInstPtr>
+void
+DependencyGraph<DynInstPtr>::freeEntry(DepEntry *entry)
+{
+    entry->inst = NULL;
+    entry->next = freeEntries;
+    freeEntries = entry;
 }
 
 template <class DynInstPtr>
@@ -170,9 +211,8 @@ DependencyGraph<DynInstPtr>::reset()
 
             prev = curr;
             curr = prev->next;
-            prev->inst = NULL;
 
-            delete prev;
+            freeEntry(prev);
         }
 
         if (dependGraph[i].inst) {
@@ -192,7 +232,7 @@ DependencyGraph<DynInstPtr>::insert(RegIndex idx, const DynInstPtr &new_inst)
 
     // First create the entry that will be added to the head of the
     // dependency chain.
-    DepEntry *new_entry = new DepEntry;
+    DepEntry *new_entry = allocEntry();
     new_entry->next = dependGraph[idx].next;
     new_entry->inst = new_inst;
 
@@ -235,10 +275,7 @@ DependencyGraph<DynInstPtr>::remove(RegIndex idx,
 
     --memAllocCounter;
 
-    // Could push this off to the destructor of DependencyEntry
-    curr->inst = NULL;
-
-    delete curr;
+    freeEntry(curr);
 }
 
 template <class DynInstPtr>
@@ -251,9 +288,8 @@ DependencyGraph<DynInstPtr>::pop(RegIndex idx)
     if (node) {
         inst = node->inst;
         dependGraph[idx].next = node->next;
-        node->inst = NULL;
         memAllocCounter--;
-        delete node;
+        freeEntry(node);
     }
     return inst;
 }
@@ -45,7 +45,6 @@
 #include <algorithm>
 #include <array>
 #include <deque>
-#include <list>
 #include <string>
 
 #include "base/refcnt.hh"
@@ -57,7 +56,9 @@
 #include "cpu/inst_res.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/o3/cpu.hh"
+#include "cpu/o3/dyn_inst_pool.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
+#include "cpu/o3/inst_list.hh"
 #include "cpu/o3/lsq_unit.hh"
 #include "cpu/op_class.hh"
 #include "cpu/reg_class.hh"
@@ -80,9 +81,6 @@ class DynInst : public ExecContext, public RefCounted
             InstSeqNum seq_num, CPU *cpu);
 
   public:
-    // The list of instructions iterator type.
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
-
     struct Arrays
     {
         size_t numSrcs;
@@ -95,7 +93,9 @@ class DynInst : public ExecContext, public RefCounted
         uint8_t *readySrcIdx;
     };
 
-    static void *operator new(size_t count, Arrays &arrays);
+    static void *operator new(size_t count, Arrays &arrays,
+                              DynInstPool &pool);
+    static void operator delete(void *ptr);
 
     /** BaseDynInst constructor given a binary instruction. */
     DynInst(const Arrays &arrays, const StaticInstPtr &staticInst,
@@ -316,8 +316,8 @@ class DynInst : public ExecContext, public RefCounted
     /** The thread this instruction is from. */
     ThreadID threadNumber = 0;
 
-    /** Iterator pointing to this BaseDynInst in the list of all insts. */
-    ListIt instListIt;
+    /** Links of this instruction in the lists it is in. */
+    InstListHook<DynInst> listHooks[NumInstLists];
 
     ////////////////////// Branch Data ///////////////
     /** Predicted PC state after this instruction. */
@@ -933,11 +933,8 @@ class DynInst : public ExecContext, public RefCounted
     /** Assert this instruction has generated a memory request. */
     void setRequest() { instFlags[ReqMade] = true; }
 
-    /** Returns iterator to this instruction in the list of all insts. */
-    ListIt &getInstListIt() { return instListIt; }
-
-    /** Sets iterator for this instruction in the list of all insts. */
-    void setInstListIt(ListIt _instListIt) { instListIt = _instListIt; }
+    /** Links of this instruction in one of the InstLists. */
+    InstListHook<DynInst> &listHook(InstListId id) { return listHooks[id]; }
 
   public:
     /** Returns the number of consecutive store conditional failures. */
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/o3/dyn_inst_pool.hh"
+
+#include <cassert>
+#include <new>
+
+#include "sim/stats.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+DynInstPool::DynInstPool(statistics::Group *parent)
+    : statistics::Group(parent, "dynInsts"),
+      numLive(0),
+      ADD_STAT(liveInsts, statistics::units::Count::get(),
+               "Number of dynamic instructions in flight"),
+      ADD_STAT(allocations, statistics::units::Count::get(),
+               "Number of dynamic instructions allocated"),
+      ADD_STAT(heapAllocations, statistics::units::Count::get(),
+               "Number of dynamic instructions that needed new host "
+               "memory rather than recycled storage"),
+      ADD_STAT(allocRate, statistics::units::Rate<
+                    statistics::units::Count, statistics::units::Second>::get(),
+               "Dynamic instructions allocated per simulated second",
+               allocations / simSeconds)
+{
+    liveInsts.functor([this]() { return numLive; });
+}
+
+DynInstPool::~DynInstPool()
+{
+    for (auto &free_list : freeLists) {
+        for (void *buf : free_list) {
+            ::operator delete(buf);
+        }
+    }
+}
+
+void *
+DynInstPool::allocate(size_t size)
+{
+    const size_t size_class = divCeil(size, granularity);
+    if (size_class >= freeLists.size()) {
+        freeLists.resize(size_class + 1);
+    }
+
+    allocations++;
+    numLive++;
+
+    auto &free_list = freeLists[size_class];
+    uint8_t *buf;
+    if (free_list.empty()) {
+        heapAllocations++;
+        buf = (uint8_t *)::operator new(headerSize +
+                                        size_class * granularity);
+        new (buf) Header{this, size_class};
+    } else {
+        buf = (uint8_t *)free_list.back();
+        free_list.pop_back();
+    }
+
+    return buf + headerSize;
+}
+
+void
+DynInstPool::release(void *ptr)
+{
+    uint8_t *buf = (uint8_t *)ptr - headerSize;
+    const Header *header = (const Header *)buf;
+    DynInstPool *pool = header->pool;
+
+    assert(pool->numLive > 0);
+    pool->numLive--;
+    pool->freeLists[header->sizeClass].push_back(buf);
+}
+
+} // namespace o3
+} // namespace gem5
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_DYN_INST_POOL_HH__
+#define __CPU_O3_DYN_INST_POOL_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "base/intmath.hh"
+#include "base/statistics.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/**
+ * Storage for the dynamic instructions of a CPU. The memory of an
+ * instruction goes back to a free list when it is destroyed, and is
+ * reused for the next instruction of a similar size, so that the
+ * allocator is only called until the pipeline has filled up.
+ *
+ * Instructions are grouped in size classes, as their size depends on
+ * their number of operands. Each buffer starts with a header that
+ * records its pool and size class, so that it can be returned without
+ * knowing which CPU the instruction belonged to.
+ */
+class DynInstPool : public statistics::Group
+{
+  public:
+    DynInstPool(statistics::Group *parent);
+    ~DynInstPool();
+
+    DynInstPool(const DynInstPool &) = delete;
+    DynInstPool &operator=(const DynInstPool &) = delete;
+
+    /**
+     * Get storage for an instruction.
+     *
+     * @param size Number of bytes needed, including the operand arrays.
+     * @return Storage aligned for any type.
+     */
+    void *allocate(size_t size);
+
+    /**
+     * Return the storage of an instruction to the pool it came from.
+     *
+     * @param ptr Storage obtained from allocate.
+     */
+    static void release(void *ptr);
+
+  private:
+    struct Header
+    {
+        DynInstPool *pool;
+        size_t sizeClass;
+    };
+
+    /** Room taken by the header, keeping the instruction aligned. */
+    static constexpr size_t headerSize =
+        roundUp(sizeof(Header), alignof(std::max_align_t));
+
+    /** Size difference between consecutive size classes, in bytes. */
+    static constexpr size_t granularity = 64;
+
+    /** Free buffers of each size class. */
+    std::vector<std::vector<void *>> freeLists;
+
+    /** Number of instructions currently allocated. */
+    uint64_t numLive;
+
+    statistics::Value liveInsts;
+    statistics::Scalar allocations;
+    statistics::Scalar heapAllocations;
+    statistics::Formula allocRate;
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_DYN_INST_POOL_HH__
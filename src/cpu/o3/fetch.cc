@@ -104,11 +104,11 @@ Fetch::Fetch(CPU *_cpu, const BaseO3CPUParams &params)
 {
     if (numThreads > MaxThreads)
         fatal("numThreads (%d) is larger than compiled limit (%d),\n"
-              "\tincrease MaxThreads in src/cpu/o3/limits.hh\n",
+              "\trebuild with a larger O3_MAX_THREADS\n",
               numThreads, static_cast<int>(MaxThreads));
     if (fetchWidth > MaxWidth)
         fatal("fetchWidth (%d) is larger than compiled limit (%d),\n"
-             "\tincrease MaxWidth in src/cpu/o3/limits.hh\n",
+             "\trebuild with a larger O3_MAX_WIDTH\n",
              fetchWidth, static_cast<int>(MaxWidth));
     if (fetchBufferSize > cacheBlkSize)
         fatal("fetch buffer size (%u bytes) is greater than the cache "
@@ -586,7 +586,7 @@ Fetch::fetchCacheLine(Addr vaddr, ThreadID tid, Addr pc)
     // Setup the memReq to do a read of the first instruction's address.
     // Set the appropriate read size and flags as well.
     // Build request here.
-    RequestPtr mem_req = std::make_shared<Request>(
+    RequestPtr mem_req = Request::make(
         fetchBufferBlockPC, fetchBufferSize,
         Request::INST_FETCH, cpu->instRequestorId(), pc,
         cpu->thread[tid]->contextId());
@@ -1067,7 +1067,7 @@ Fetch::buildInst(ThreadID tid, StaticInstPtr staticInst,
     arrays.numDests = staticInst->numDestRegs();
 
     // Create a new DynInst from the instruction fetched.
-    DynInstPtr instruction = new (arrays) DynInst(
+    DynInstPtr instruction = new (arrays, cpu->dynInstPool) DynInst(
             arrays, staticInst, curMacroop, this_pc, next_pc, seq, cpu);
     instruction->setTid(tid);
 
@@ -1090,7 +1090,7 @@ Fetch::buildInst(ThreadID tid, StaticInstPtr staticInst,
 #endif
 
     // Add instruction to the CPU's list of instructions.
-    instruction->setInstListIt(cpu->addInst(instruction));
+    cpu->addInst(instruction);
 
     // Write the instruction to the first slot in the queue
     // that heads to decode.
@@ -84,15 +84,15 @@ IEW::IEW(CPU *_cpu, const BaseO3CPUParams &params)
 {
     if (dispatchWidth > MaxWidth)
         fatal("dispatchWidth (%d) is larger than compiled limit (%d),\n"
-             "\tincrease MaxWidth in src/cpu/o3/limits.hh\n",
+             "\trebuild with a larger O3_MAX_WIDTH\n",
              dispatchWidth, static_cast<int>(MaxWidth));
     if (issueWidth > MaxWidth)
         fatal("issueWidth (%d) is larger than compiled limit (%d),\n"
-             "\tincrease MaxWidth in src/cpu/o3/limits.hh\n",
+             "\trebuild with a larger O3_MAX_WIDTH\n",
              issueWidth, static_cast<int>(MaxWidth));
     if (wbWidth > MaxWidth)
         fatal("wbWidth (%d) is larger than compiled limit (%d),\n"
-             "\tincrease MaxWidth in src/cpu/o3/limits.hh\n",
+             "\trebuild with a larger O3_MAX_WIDTH\n",
              wbWidth, static_cast<int>(MaxWidth));
 
     _status = Active;
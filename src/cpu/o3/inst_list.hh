@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_INST_LIST_HH__
+#define __CPU_O3_INST_LIST_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/** The lists that link in-flight instructions through their hooks. */
+enum InstListId
+{
+    CPUInstList,
+    IQInstList,
+    IQToExecuteList,
+    MemDepInstList,
+    NumInstLists
+};
+
+/** The links of an instruction in one of the InstLists. */
+template <class Inst>
+struct InstListHook
+{
+    Inst *prev = nullptr;
+    Inst *next = nullptr;
+    bool linked = false;
+};
+
+/**
+ * A list of instructions linked through a hook in each of them, so that
+ * adding an instruction doesn't allocate a node, and the instruction
+ * finds its own place in the list without keeping an iterator. An
+ * instruction is in at most one list of each InstListId, and the list
+ * holds a reference to it, like a list of DynInstPtr would.
+ *
+ * Inst must be reference counted and provide listHook(InstListId).
+ * Iterators stay valid until their instruction is erased.
+ */
+template <class Inst, InstListId Id>
+class InstList
+{
+  public:
+    class iterator
+    {
+      public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Inst *;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Inst **;
+        using reference = Inst *;
+
+        iterator() = default;
+
+        Inst *operator*() const { return inst; }
+
+        iterator &
+        operator++()
+        {
+            inst = inst->listHook(Id).next;
+            return *this;
+        }
+
+        iterator
+        operator++(int)
+        {
+            iterator it = *this;
+            ++*this;
+            return it;
+        }
+
+        /** Going back from end() gives the last instruction. */
+        iterator &
+        operator--()
+        {
+            inst = inst ? inst->listHook(Id).prev : list->tail;
+            return *this;
+        }
+
+        iterator
+        operator--(int)
+        {
+            iterator it = *this;
+            --*this;
+            return it;
+        }
+
+        bool operator==(const iterator &other) const
+        { return inst == other.inst; }
+        bool operator!=(const iterator &other) const
+        { return inst != other.inst; }
+
+      private:
+        friend class InstList;
+
+        iterator(const InstList *_list, Inst *_inst)
+            : list(_list), inst(_inst)
+        {}
+
+        const InstList *list = nullptr;
+        /** The instruction, or nullptr for end(). */
+        Inst *inst = nullptr;
+    };
+
+    InstList() = default;
+    ~InstList() { clear(); }
+
+    InstList(const InstList &) = delete;
+    InstList &operator=(const InstList &) = delete;
+
+    bool empty() const { return !head; }
+    size_t size() const { return count; }
+
+    Inst *front() const { assert(head); return head; }
+    Inst *back() const { assert(tail); return tail; }
+
+    iterator begin() const { return iterator(this, head); }
+    iterator end() const { return iterator(this, nullptr); }
+
+    /** Iterator to an instruction that is in this list. */
+    iterator
+    iteratorTo(Inst *inst) const
+    {
+        assert(inst->listHook(Id).linked);
+        return iterator(this, inst);
+    }
+
+    void
+    push_back(Inst *inst)
+    {
+        auto &hook = inst->listHook(Id);
+        assert(!hook.linked);
+        inst->incref();
+        hook.prev = tail;
+        hook.next = nullptr;
+        hook.linked = true;
+        if (tail)
+            tail->listHook(Id).next = inst;
+        else
+            head = inst;
+        tail = inst;
+        ++count;
+    }
+
+    void pop_front() { erase(begin()); }
+
+    /** Remove an instruction, and return the iterator to the next one. */
+    iterator
+    erase(iterator it)
+    {
+        Inst *inst = *it;
+        auto &hook = inst->listHook(Id);
+        assert(hook.linked);
+        Inst *next = hook.next;
+        if (hook.prev)
+            hook.prev->listHook(Id).next = next;
+        else
+            head = next;
+        if (next)
+            next->listHook(Id).prev = hook.prev;
+        else
+            tail = hook.prev;
+        hook.prev = hook.next = nullptr;
+        hook.linked = false;
+        --count;
+        // This may destroy the instruction
+        inst->decref();
+        return iterator(this, next);
+    }
+
+    void
+    clear()
+    {
+        while (head)
+            pop_front();
+    }
+
+  private:
+    Inst *head = nullptr;
+    Inst *tail = nullptr;
+    size_t count = 0;
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_INST_LIST_HH__
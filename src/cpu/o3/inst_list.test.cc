@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "base/refcnt.hh"
+#include "cpu/o3/inst_list.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+struct FakeInst : public RefCounted
+{
+    FakeInst(int _id, int *_destroyed) : id(_id), destroyed(_destroyed) {}
+    ~FakeInst() { ++*destroyed; }
+
+    o3::InstListHook<FakeInst> &
+    listHook(o3::InstListId id)
+    {
+        return hooks[id];
+    }
+
+    int id;
+    int *destroyed;
+    o3::InstListHook<FakeInst> hooks[o3::NumInstLists];
+};
+
+using FakeInstPtr = RefCountingPtr<FakeInst>;
+using FakeList = o3::InstList<FakeInst, o3::CPUInstList>;
+using OtherFakeList = o3::InstList<FakeInst, o3::IQInstList>;
+
+std::vector<int>
+ids(const FakeList &list)
+{
+    std::vector<int> result;
+    for (auto *inst : list)
+        result.push_back(inst->id);
+    return result;
+}
+
+} // anonymous namespace
+
+TEST(InstListTest, PushAndErase)
+{
+    int destroyed = 0;
+    FakeList list;
+    std::vector<FakeInstPtr> insts;
+    for (int i = 0; i < 5; i++) {
+        insts.emplace_back(new FakeInst(i, &destroyed));
+        list.push_back(insts.back().get());
+    }
+    ASSERT_EQ(list.size(), 5);
+    EXPECT_EQ(list.front(), insts[0].get());
+    EXPECT_EQ(list.back(), insts[4].get());
+
+    // Erase from the middle, the front and the back
+    auto it = list.erase(list.iteratorTo(insts[2].get()));
+    EXPECT_EQ(*it, insts[3].get());
+    list.pop_front();
+    list.erase(--list.end());
+    EXPECT_EQ(ids(list), (std::vector<int>{1, 3}));
+    EXPECT_EQ(list.size(), 2);
+
+    // An erased instruction can be added again
+    list.push_back(insts[0].get());
+    EXPECT_EQ(ids(list), (std::vector<int>{1, 3, 0}));
+    EXPECT_EQ(destroyed, 0);
+}
+
+TEST(InstListTest, WalkBackwards)
+{
+    int destroyed = 0;
+    FakeList list;
+    std::vector<FakeInstPtr> insts;
+    for (int i = 0; i < 4; i++) {
+        insts.emplace_back(new FakeInst(i, &destroyed));
+        list.push_back(insts.back().get());
+    }
+
+    // Erase while walking from the back, the way squashes do
+    auto it = --list.end();
+    while ((*it)->id > 1)
+        list.erase(it--);
+    EXPECT_EQ(*it, insts[1].get());
+    EXPECT_EQ(ids(list), (std::vector<int>{0, 1}));
+}
+
+TEST(InstListTest, HoldsReferences)
+{
+    int destroyed = 0;
+    FakeList list;
+    OtherFakeList other;
+    {
+        FakeInstPtr inst = new FakeInst(0, &destroyed);
+        list.push_back(inst.get());
+        other.push_back(inst.get());
+    }
+    EXPECT_EQ(destroyed, 0);
+
+    // The instruction is in both lists independently
+    list.clear();
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(destroyed, 0);
+    EXPECT_EQ(other.front()->id, 0);
+    other.pop_front();
+    EXPECT_EQ(destroyed, 1);
+}
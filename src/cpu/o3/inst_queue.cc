@@ -89,6 +89,7 @@ InstructionQueue::InstructionQueue(CPU *cpu_ptr, IEW *iew_ptr,
     : cpu(cpu_ptr),
       iewStage(iew_ptr),
       fuPool(params.fuPool),
+      readyInsts(Num_OpClasses),
       iqPolicy(params.smtIQPolicy),
       numThreads(params.numThreads),
       numEntries(params.numIQEntries),
@@ -414,14 +415,8 @@ InstructionQueue::resetState()
         squashedSeqNum[tid] = 0;
     }
 
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        while (!readyInsts[i].empty())
-            readyInsts[i].pop();
-        queueOnList[i] = false;
-        readyIt[i] = listOrder.end();
-    }
+    readyInsts.clear();
     nonSpecInsts.clear();
-    listOrder.clear();
     deferredMemInsts.clear();
     blockedMemInsts.clear();
     retryMemInsts.clear();
@@ -545,17 +540,7 @@ InstructionQueue::isFull(ThreadID tid)
 bool
 InstructionQueue::hasReadyInsts()
 {
-    if (!listOrder.empty()) {
-        return true;
-    }
-
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        if (!readyInsts[i].empty()) {
-            return true;
-        }
-    }
-
-    return false;
+    return !readyInsts.empty();
 }
 
 void
@@ -576,7 +561,7 @@ InstructionQueue::insert(const DynInstPtr &new_inst)
 
     assert(freeEntries != 0);
 
-    instList[new_inst->threadNumber].push_back(new_inst);
+    instList[new_inst->threadNumber].push_back(new_inst.get());
 
     --freeEntries;
 
@@ -626,7 +611,7 @@ InstructionQueue::insertNonSpec(const DynInstPtr &new_inst)
 
     assert(freeEntries != 0);
 
-    instList[new_inst->threadNumber].push_back(new_inst);
+    instList[new_inst->threadNumber].push_back(new_inst.get());
 
     --freeEntries;
 
@@ -661,7 +646,7 @@ DynInstPtr
 InstructionQueue::getInstToExecute()
 {
     assert(!instsToExecute.empty());
-    DynInstPtr inst = std::move(instsToExecute.front());
+    DynInstPtr inst = instsToExecute.front();
     instsToExecute.pop_front();
     if (inst->isFloating()) {
         iqIOStats.fpInstQueueReads++;
@@ -673,58 +658,6 @@ InstructionQueue::getInstToExecute()
     return inst;
 }
 
-void
-InstructionQueue::addToOrderList(OpClass op_class)
-{
-    assert(!readyInsts[op_class].empty());
-
-    ListOrderEntry queue_entry;
-
-    queue_entry.queueType = op_class;
-
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
-    // the smallest seqNum
-
-    ListOrderIt list_it = listOrder.begin();
-    ListOrderIt list_end_it = listOrder.end();
-
-    while (list_it != list_end_it) {
-        if ((*list_it).oldestInst > queue_entry.oldestInst) {
-            break;
-        }
-
-        list_it++;
-    }
-
-    readyIt[op_class] = listOrder.insert(list_it, queue_entry);
-    queueOnList[op_class] = true;
-}
-
-void
-InstructionQueue::moveToYoungerInst(ListOrderIt list_order_it)
-{
-    // Get iterator of next item on the list
-    // Delete the original iterator
-    // Determine if the next item is either the end of the list or younger
-    // than the new instruction.  If so, then add in a new iterator right here.
-    // If not, then move along.
-    ListOrderEntry queue_entry;
-    OpClass op_class = (*list_order_it).queueType;
-    ListOrderIt next_it = list_order_it;
-
-    ++next_it;
-
-    queue_entry.queueType = op_class;
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
-
-    while (next_it != listOrder.end() &&
-           (*next_it).oldestInst < queue_entry.oldestInst) {
-        ++next_it;
-    }
-
-    readyIt[op_class] = listOrder.insert(next_it, queue_entry);
-}
-
 void
 InstructionQueue::processFUCompletion(const DynInstPtr &inst, int fu_idx)
 {
@@ -742,7 +675,7 @@ InstructionQueue::processFUCompletion(const DynInstPtr &inst, int fu_idx)
     // of a cycle, otherwise they could add too many instructions to
     // the queue.
     issueToExecuteQueue->access(-1)->size++;
-    instsToExecute.push_back(inst);
+    instsToExecute.push_back(inst.get());
 }
 
 // @todo: Figure out a better way to remove the squashed items from the
@@ -766,24 +699,22 @@ InstructionQueue::scheduleReadyInsts()
         addReadyMemInst(mem_inst);
     }
 
-    // Have iterator to head of the list
-    // While I haven't exceeded bandwidth or reached the end of the list,
-    // Try to get a FU that can do what this op needs.
-    // If successful, change the oldestInst to the new top of the list, put
-    // the queue in the proper place in the list.
-    // Increment the iterator.
+    // While I haven't exceeded bandwidth or run out of candidates,
+    // take the oldest ready instruction and try to get a FU that can do
+    // what this op needs.
+    // If successful, remove the instruction from the ready set.
+    // If not, block its op class for the rest of this cycle.
     // This will avoid trying to schedule a certain op class if there are no
     // FUs that handle it.
     int total_issued = 0;
-    ListOrderIt order_it = listOrder.begin();
-    ListOrderIt order_end_it = listOrder.end();
-
-    while (total_issued < totalWidth && order_it != order_end_it) {
-        OpClass op_class = (*order_it).queueType;
+    int slot;
 
-        assert(!readyInsts[op_class].empty());
+    readyInsts.beginSelect();
+    while (total_issued < totalWidth &&
+           (slot = readyInsts.oldest()) != readyInsts.noSlot) {
+        OpClass op_class = (OpClass)readyInsts.opClass(slot);
 
-        DynInstPtr issuing_inst = readyInsts[op_class].top();
+        DynInstPtr issuing_inst = readyInsts.inst(slot);
 
         if (issuing_inst->isFloating()) {
             iqIOStats.fpInstQueueReads++;
@@ -793,19 +724,8 @@ InstructionQueue::scheduleReadyInsts()
             iqIOStats.intInstQueueReads++;
         }
 
-        assert(issuing_inst->seqNum == (*order_it).oldestInst);
-
         if (issuing_inst->isSquashed()) {
-            readyInsts[op_class].pop();
-
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
-
-            listOrder.erase(order_it++);
+            readyInsts.remove(slot);
 
             ++iqStats.squashedInstsIssued;
 
@@ -835,7 +755,7 @@ InstructionQueue::scheduleReadyInsts()
         if (idx != FUPool::NoFreeFU) {
             if (op_latency == Cycles(1)) {
                 i2e_info->size++;
-                instsToExecute.push_back(issuing_inst);
+                instsToExecute.push_back(issuing_inst.get());
 
                 // Add the FU onto the list of FU's to be freed next
                 // cycle if we used one.
@@ -866,14 +786,7 @@ InstructionQueue::scheduleReadyInsts()
                     tid, issuing_inst->pcState(),
                     issuing_inst->seqNum);
 
-            readyInsts[op_class].pop();
-
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
+            readyInsts.remove(slot);
 
             issuing_inst->setIssued();
             ++total_issued;
@@ -895,12 +808,11 @@ InstructionQueue::scheduleReadyInsts()
                 memDepUnit[tid].issue(issuing_inst);
             }
 
-            listOrder.erase(order_it++);
             iqStats.statIssuedInstType[tid][op_class]++;
         } else {
             iqStats.statFuBusy[op_class]++;
             iqStats.fuBusy[tid]++;
-            ++order_it;
+            readyInsts.blockClass(op_class);
         }
     }
 
@@ -951,7 +863,7 @@ InstructionQueue::commit(const InstSeqNum &inst, ThreadID tid)
     DPRINTF(IQ, "[tid:%i] Committing instructions older than [sn:%llu]\n",
             tid,inst);
 
-    ListIt iq_it = instList[tid].begin();
+    auto iq_it = instList[tid].begin();
 
     while (iq_it != instList[tid].end() &&
            (*iq_it)->seqNum <= inst) {
@@ -1070,17 +982,7 @@ InstructionQueue::addReadyMemInst(const DynInstPtr &ready_inst)
 {
     OpClass op_class = ready_inst->opClass();
 
-    readyInsts[op_class].push(ready_inst);
-
-    // Will need to reorder the list if either a queue is not on the list,
-    // or it has an older instruction than last time.
-    if (!queueOnList[op_class]) {
-        addToOrderList(op_class);
-    } else if (readyInsts[op_class].top()->seqNum  <
-               (*readyIt[op_class]).oldestInst) {
-        listOrder.erase(readyIt[op_class]);
-        addToOrderList(op_class);
-    }
+    readyInsts.push(op_class, ready_inst);
 
     DPRINTF(IQ, "Instruction is ready to issue, putting it onto "
             "the ready list, PC %s opclass:%i [sn:%llu].\n",
@@ -1187,7 +1089,7 @@ void
 InstructionQueue::doSquash(ThreadID tid)
 {
     // Start at the tail.
-    ListIt squash_it = instList[tid].end();
+    auto squash_it = instList[tid].end();
     --squash_it;
 
     DPRINTF(IQ, "[tid:%i] Squashing until sequence number %i!\n",
@@ -1326,13 +1228,6 @@ InstructionQueue::doSquash(ThreadID tid)
     }
 }
 
-bool
-InstructionQueue::PqCompare::operator()(
-        const DynInstPtr &lhs, const DynInstPtr &rhs) const
-{
-    return lhs->seqNum > rhs->seqNum;
-}
-
 bool
 InstructionQueue::addToDependents(const DynInstPtr &new_inst)
 {
@@ -1446,17 +1341,7 @@ InstructionQueue::addIfReady(const DynInstPtr &inst)
                 "the ready list, PC %s opclass:%i [sn:%llu].\n",
                 inst->pcState(), op_class, inst->seqNum);
 
-        readyInsts[op_class].push(inst);
-
-        // Will need to reorder the list if either a queue is not on the list,
-        // or it has an older instruction than last time.
-        if (!queueOnList[op_class]) {
-            addToOrderList(op_class);
-        } else if (readyInsts[op_class].top()->seqNum  <
-                   (*readyIt[op_class]).oldestInst) {
-            listOrder.erase(readyIt[op_class]);
-            addToOrderList(op_class);
-        }
+        readyInsts.push(op_class, inst);
     }
 }
 
@@ -1470,7 +1355,7 @@ void
 InstructionQueue::dumpLists()
 {
     for (int i = 0; i < Num_OpClasses; ++i) {
-        cprintf("Ready list %i size: %i\n", i, readyInsts[i].size());
+        cprintf("Ready list %i size: %i\n", i, readyInsts.size(i));
 
         cprintf("\n");
     }
@@ -1489,22 +1374,6 @@ InstructionQueue::dumpLists()
     }
 
     cprintf("\n");
-
-    ListOrderIt list_order_it = listOrder.begin();
-    ListOrderIt list_order_end_it = listOrder.end();
-    int i = 1;
-
-    cprintf("List order: ");
-
-    while (list_order_it != list_order_end_it) {
-        cprintf("%i OpClass:%i [sn:%llu] ", i, (*list_order_it).queueType,
-                (*list_order_it).oldestInst);
-
-        ++list_order_it;
-        ++i;
-    }
-
-    cprintf("\n");
 }
 
 
@@ -1514,7 +1383,7 @@ InstructionQueue::dumpInsts()
     for (ThreadID tid = 0; tid < numThreads; ++tid) {
         int num = 0;
         int valid_num = 0;
-        ListIt inst_list_it = instList[tid].begin();
+        auto inst_list_it = instList[tid].begin();
 
         while (inst_list_it != instList[tid].end()) {
             cprintf("Instruction:%i\n", num);
@@ -1554,7 +1423,7 @@ InstructionQueue::dumpInsts()
 
     int num = 0;
     int valid_num = 0;
-    ListIt inst_list_it = instsToExecute.begin();
+    auto inst_list_it = instsToExecute.begin();
 
     while (inst_list_it != instsToExecute.end())
     {
@@ -44,7 +44,6 @@
 
 #include <list>
 #include <map>
-#include <queue>
 #include <vector>
 
 #include "base/statistics.hh"
@@ -53,8 +52,10 @@
 #include "cpu/o3/comm.hh"
 #include "cpu/o3/dep_graph.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
+#include "cpu/o3/inst_list.hh"
 #include "cpu/o3/limits.hh"
 #include "cpu/o3/mem_dep_unit.hh"
+#include "cpu/o3/ready_inst_set.hh"
 #include "cpu/o3/store_set.hh"
 #include "cpu/op_class.hh"
 #include "cpu/timebuf.hh"
@@ -79,9 +80,10 @@ class CPU;
 class IEW;
 
 /**
- * A standard instruction queue class.  It holds ready instructions, in
- * order, in seperate priority queues to facilitate the scheduling of
- * instructions.  The IQ uses a separate linked list to track dependencies.
+ * A standard instruction queue class.  It holds ready instructions in a
+ * set with a bit vector per op class, which selects the oldest ready
+ * instruction among the op classes with free FUs.  The IQ uses a separate
+ * linked list to track dependencies.
  * Similar to the rename map and the free list, it expects that
  * floating point registers have their indices start after the integer
  * registers (ie with 96 int and 96 fp registers, regs 0-95 are integer
@@ -318,10 +320,10 @@ class InstructionQueue
     //////////////////////////////////////
 
     /** List of all the instructions in the IQ (some of which may be issued). */
-    std::list<DynInstPtr> instList[MaxThreads];
+    InstList<DynInst, IQInstList> instList[MaxThreads];
 
     /** List of instructions that are ready to be executed. */
-    std::list<DynInstPtr> instsToExecute;
+    InstList<DynInst, IQToExecuteList> instsToExecute;
 
     /** List of instructions waiting for their DTB translation to
      *  complete (hw page table walk in progress).
@@ -336,25 +338,10 @@ class InstructionQueue
      */
     std::list<DynInstPtr> retryMemInsts;
 
-    /**
-     * Struct for comparing entries to be added to the priority queue.
-     * This gives reverse ordering to the instructions in terms of
-     * sequence numbers: the instructions with smaller sequence
-     * numbers (and hence are older) will be at the top of the
-     * priority queue.
-     */
-    struct PqCompare
-    {
-        bool operator()(const DynInstPtr &lhs, const DynInstPtr &rhs) const;
-    };
-
-    typedef std::priority_queue<
-        DynInstPtr, std::vector<DynInstPtr>, PqCompare> ReadyInstQueue;
-
-    /** List of ready instructions, per op class.  They are separated by op
-     *  class to allow for easy mapping to FUs.
+    /** The ready instructions.  They are tracked by op class to allow for
+     *  easy mapping to FUs.
      */
-    ReadyInstQueue readyInsts[Num_OpClasses];
+    ReadyInstSet<DynInstPtr> readyInsts;
 
     /** List of non-speculative instructions that will be scheduled
      *  once the IQ gets a signal from commit.  While it's redundant to
@@ -367,41 +354,6 @@ class InstructionQueue
 
     typedef std::map<InstSeqNum, DynInstPtr>::iterator NonSpecMapIt;
 
-    /** Entry for the list age ordering by op class. */
-    struct ListOrderEntry
-    {
-        OpClass queueType;
-        InstSeqNum oldestInst;
-    };
-
-    /** List that contains the age order of the oldest instruction of each
-     *  ready queue.  Used to select the oldest instruction available
-     *  among op classes.
-     *  @todo: Might be better to just move these entries around instead
-     *  of creating new ones every time the position changes due to an
-     *  instruction issuing.  Not sure std::list supports this.
-     */
-    std::list<ListOrderEntry> listOrder;
-
-    typedef typename std::list<ListOrderEntry>::iterator ListOrderIt;
-
-    /** Tracks if each ready queue is on the age order list. */
-    bool queueOnList[Num_OpClasses];
-
-    /** Iterators of each ready queue.  Points to their spot in the age order
-     *  list.
-     */
-    ListOrderIt readyIt[Num_OpClasses];
-
-    /** Add an op class to the age order list. */
-    void addToOrderList(OpClass op_class);
-
-    /**
-     * Called when the oldest instruction has been removed from a ready queue;
-     * this places that ready queue into the proper spot in the age order list.
-     */
-    void moveToYoungerInst(ListOrderIt age_order_it);
-
     DependencyGraph<DynInstPtr> dependGraph;
 
     //////////////////////////////////////
@@ -28,14 +28,26 @@
 #ifndef __CPU_O3_LIMITS_HH__
 #define __CPU_O3_LIMITS_HH__
 
+#include "config/o3_max_threads.hh"
+#include "config/o3_max_width.hh"
+
 namespace gem5
 {
 
 namespace o3
 {
 
-static constexpr int MaxWidth = 12;
-static constexpr int MaxThreads = 4;
+/**
+ * Upper bounds on the shape of an O3 CPU, set with the O3_MAX_WIDTH and
+ * O3_MAX_THREADS build options. They size the time buffer structs and
+ * the per-thread state of every stage, so building with the smallest
+ * values the simulated configurations need saves work every cycle.
+ */
+static constexpr int MaxWidth = O3_MAX_WIDTH;
+static constexpr int MaxThreads = O3_MAX_THREADS;
+
+static_assert(MaxWidth > 0, "O3_MAX_WIDTH must be positive");
+static_assert(MaxThreads > 0, "O3_MAX_THREADS must be positive");
 
 } // namespace o3
 } // namespace gem5
@@ -68,7 +68,7 @@ MemDepUnit::~MemDepUnit()
 {
     for (ThreadID tid = 0; tid < MaxThreads; tid++) {
 
-        ListIt inst_list_it = instList[tid].begin();
+        auto inst_list_it = instList[tid].begin();
 
         MemDepHashIt hash_it;
 
@@ -200,9 +200,7 @@ MemDepUnit::insert(const DynInstPtr &inst)
     MemDepEntry::memdep_insert++;
 #endif
 
-    instList[tid].push_back(inst);
-
-    inst_entry->listIt = --(instList[tid].end());
+    instList[tid].push_back(inst.get());
 
     // Check any barriers and the dependence predictor for any
     // producing memrefs/stores.
@@ -334,9 +332,7 @@ MemDepUnit::insertBarrier(const DynInstPtr &barr_inst)
 #endif
 
     // Add the instruction to the instruction list.
-    instList[tid].push_back(barr_inst);
-
-    inst_entry->listIt = --(instList[tid].end());
+    instList[tid].push_back(barr_inst.get());
 
     insertBarrierSN(barr_inst);
 }
@@ -414,7 +410,7 @@ MemDepUnit::completed(const DynInstPtr &inst)
 
     assert(hash_it != memDepHash.end());
 
-    instList[tid].erase((*hash_it).second->listIt);
+    instList[tid].erase(instList[tid].iteratorTo(inst.get()));
 
     (*hash_it).second = NULL;
 
@@ -532,7 +528,7 @@ MemDepUnit::squash(const InstSeqNum &squashed_num, ThreadID tid)
         }
     }
 
-    ListIt squash_it = instList[tid].end();
+    auto squash_it = instList[tid].end();
     --squash_it;
 
     MemDepHashIt hash_it;
@@ -617,7 +613,7 @@ MemDepUnit::dumpLists()
         cprintf("Instruction list %i size: %i\n",
                 tid, instList[tid].size());
 
-        ListIt inst_list_it = instList[tid].begin();
+        auto inst_list_it = instList[tid].begin();
         int num = 0;
 
         while (inst_list_it != instList[tid].end()) {
@@ -50,6 +50,7 @@
 #include "base/statistics.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
+#include "cpu/o3/inst_list.hh"
 #include "cpu/o3/limits.hh"
 #include "cpu/o3/store_set.hh"
 #include "debug/MemDepUnit.hh"
@@ -194,9 +195,6 @@ class MemDepUnit
         /** The instruction being tracked. */
         DynInstPtr inst;
 
-        /** The iterator to the instruction's location inside the list. */
-        ListIt listIt;
-
         /** A vector of any dependent instructions. */
         std::vector<MemDepEntryPtr> dependInsts;
 
@@ -231,7 +229,7 @@ class MemDepUnit
     MemDepHash memDepHash;
 
     /** A list of all instructions in the memory dependence unit. */
-    std::list<DynInstPtr> instList[MaxThreads];
+    InstList<DynInst, MemDepInstList> instList[MaxThreads];
 
     /** A list of all instructions that are going to be replayed. */
     std::list<DynInstPtr> instsToReplay;
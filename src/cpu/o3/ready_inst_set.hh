@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_READY_INST_SET_HH__
+#define __CPU_O3_READY_INST_SET_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "cpu/inst_seq.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/**
+ * The instructions that are ready to issue, kept in slots tracked by a
+ * bit vector per op class. The slots form a ring indexed by sequence
+ * number modulo its size, which is kept larger than the span of the
+ * sequence numbers held, so going around the ring from the slot of
+ * the oldest instruction visits the slots in age order. The oldest
+ * candidate among a set of op classes is then the first set bit in
+ * that order, found with a count of trailing zeros on the first
+ * non-zero word, instead of keeping a priority queue per op class and
+ * a list ordering the op classes by their oldest instruction.
+ *
+ * A select goes as follows: beginSelect() makes all the instructions
+ * candidates, oldest() returns the candidate with the lowest sequence
+ * number, and remove() or blockClass() take it, or its whole op class,
+ * out of the candidates. This issues in the same order as always
+ * picking the op class with the oldest head that hasn't been blocked.
+ * A push may grow the ring, which moves the instructions to other
+ * slots, so slots are only valid until the next push.
+ */
+template <class DynInstPtr>
+class ReadyInstSet
+{
+  public:
+    /** Returned by oldest() when there are no candidates. */
+    static constexpr int noSlot = -1;
+
+    /** @param num_classes Number of op classes. */
+    ReadyInstSet(int num_classes)
+        : classMasks(num_classes), classSizes(num_classes, 0), numInsts(0),
+          minSeqNum(0), maxSeqNum(0)
+    {
+        resize(64);
+    }
+
+    /** Add a ready instruction. It isn't a candidate until the next
+     *  select. */
+    void push(int op_class, const DynInstPtr &inst);
+
+    /** Remove the instruction in a slot. */
+    void remove(int slot);
+
+    /** Remove all the instructions. */
+    void clear();
+
+    /** Whether there are no ready instructions. */
+    bool empty() const { return numInsts == 0; }
+
+    /** Number of ready instructions of an op class. */
+    size_t size(int op_class) const { return classSizes[op_class]; }
+
+    /** Make all the ready instructions candidates for a select. */
+    void beginSelect();
+
+    /** Take the instructions of an op class out of the candidates. */
+    void blockClass(int op_class);
+
+    /** Slot of the oldest candidate, or noSlot if there is none. */
+    int oldest() const;
+
+    /** Instruction in a slot. */
+    const DynInstPtr &inst(int slot) const { return insts[slot]; }
+
+    /** Op class of the instruction in a slot. */
+    int opClass(int slot) const { return classes[slot]; }
+
+  private:
+    /** Number of slots in the ring. */
+    size_t capacity() const { return insts.size(); }
+
+    /** Slot of a sequence number. */
+    int slotOf(InstSeqNum seq_num) const
+    { return seq_num & (capacity() - 1); }
+
+    /** Whether the ring can hold a sequence number along with the
+     *  ones it holds. */
+    bool fits(InstSeqNum seq_num) const;
+
+    /** Narrow minSeqNum and maxSeqNum down to the instructions held. */
+    void updateBounds();
+
+    /** Move the instructions to a ring of another size, which must be
+     *  a power of two. */
+    void resize(size_t new_capacity);
+
+    static void set(std::vector<uint64_t> &mask, int slot)
+    { mask[slot / 64] |= (uint64_t)1 << (slot % 64); }
+
+    static void unset(std::vector<uint64_t> &mask, int slot)
+    { mask[slot / 64] &= ~((uint64_t)1 << (slot % 64)); }
+
+    static bool isSet(const std::vector<uint64_t> &mask, int slot)
+    { return mask[slot / 64] & ((uint64_t)1 << (slot % 64)); }
+
+    /** The instructions, their sequence numbers and op classes. */
+    std::vector<DynInstPtr> insts;
+    std::vector<InstSeqNum> seqNums;
+    std::vector<int> classes;
+
+    /** Slots holding an instruction, by op class and overall. */
+    std::vector<std::vector<uint64_t>> classMasks;
+    std::vector<uint64_t> readyMask;
+
+    /** Slots that can still be selected in the current select. */
+    std::vector<uint64_t> candidates;
+
+    std::vector<size_t> classSizes;
+    size_t numInsts;
+
+    /**
+     * Bounds of the sequence numbers held, if there are any. Removing
+     * instructions doesn't narrow them, so they may be loose.
+     */
+    InstSeqNum minSeqNum;
+    InstSeqNum maxSeqNum;
+};
+
+template <class DynInstPtr>
+bool
+ReadyInstSet<DynInstPtr>::fits(InstSeqNum seq_num) const
+{
+    return numInsts == 0 ||
+        std::max(maxSeqNum, seq_num) - std::min(minSeqNum, seq_num) <
+        capacity();
+}
+
+template <class DynInstPtr>
+void
+ReadyInstSet<DynInstPtr>::updateBounds()
+{
+    bool first = true;
+    for (size_t word = 0; word < readyMask.size(); word++) {
+        for (uint64_t bits = readyMask[word]; bits; bits &= bits - 1) {
+            const InstSeqNum seq_num = seqNums[word * 64 + ctz64(bits)];
+            if (first || seq_num < minSeqNum)
+                minSeqNum = seq_num;
+            if (first || seq_num > maxSeqNum)
+                maxSeqNum = seq_num;
+            first = false;
+        }
+    }
+}
+
+template <class DynInstPtr>
+void
+ReadyInstSet<DynInstPtr>::resize(size_t new_capacity)
+{
+    assert(new_capacity >= 64 && isPowerOf2(new_capacity));
+
+    std::vector<DynInstPtr> old_insts(new_capacity);
+    std::vector<InstSeqNum> old_seq_nums(new_capacity);
+    std::vector<int> old_classes(new_capacity);
+    std::vector<uint64_t> old_ready(new_capacity / 64, 0);
+    std::vector<uint64_t> old_candidates(new_capacity / 64, 0);
+    insts.swap(old_insts);
+    seqNums.swap(old_seq_nums);
+    classes.swap(old_classes);
+    readyMask.swap(old_ready);
+    candidates.swap(old_candidates);
+    for (auto &mask : classMasks) {
+        mask.assign(new_capacity / 64, 0);
+    }
+
+    for (size_t word = 0; word < old_ready.size(); word++) {
+        for (uint64_t bits = old_ready[word]; bits; bits &= bits - 1) {
+            const int old_slot = word * 64 + ctz64(bits);
+            const int slot = slotOf(old_seq_nums[old_slot]);
+            insts[slot] = std::move(old_insts[old_slot]);
+            seqNums[slot] = old_seq_nums[old_slot];
+            classes[slot] = old_classes[old_slot];
+            set(classMasks[classes[slot]], slot);
+            set(readyMask, slot);
+            if (isSet(old_candidates, old_slot))
+                set(candidates, slot);
+        }
+    }
+}
+
+template <class DynInstPtr>
+void
+ReadyInstSet<DynInstPtr>::push(int op_class, const DynInstPtr &inst)
+{
+    const InstSeqNum seq_num = inst->seqNum;
+    if (!fits(seq_num)) {
+        updateBounds();
+        if (!fits(seq_num)) {
+            const InstSeqNum span = std::max(maxSeqNum, seq_num) -
+                std::min(minSeqNum, seq_num);
+            size_t new_capacity = capacity();
+            while (new_capacity <= span)
+                new_capacity *= 2;
+            resize(new_capacity);
+        }
+    }
+
+    if (numInsts == 0) {
+        minSeqNum = maxSeqNum = seq_num;
+    } else {
+        minSeqNum = std::min(minSeqNum, seq_num);
+        maxSeqNum = std::max(maxSeqNum, seq_num);
+    }
+
+    const int slot = slotOf(seq_num);
+    assert(!insts[slot]);
+
+    insts[slot] = inst;
+    seqNums[slot] = seq_num;
+    classes[slot] = op_class;
+    set(classMasks[op_class], slot);
+    set(readyMask, slot);
+    classSizes[op_class]++;
+    numInsts++;
+}
+
+template <class DynInstPtr>
+void
+ReadyInstSet<DynInstPtr>::remove(int slot)
+{
+    assert(insts[slot]);
+
+    const int op_class = classes[slot];
+    insts[slot] = nullptr;
+    unset(classMasks[op_class], slot);
+    unset(readyMask, slot);
+    unset(candidates, slot);
+    classSizes[op_class]--;
+    numInsts--;
+}
+
+template <class DynInstPtr>
+void
+ReadyInstSet<DynInstPtr>::clear()
+{
+    for (size_t word = 0; word < readyMask.size(); word++) {
+        while (readyMask[word]) {
+            remove(word * 64 + ctz64(readyMask[word]));
+        }
+    }
+}
+
+template <class DynInstPtr>
+void
+ReadyInstSet<DynInstPtr>::beginSelect()
+{
+    candidates = readyMask;
+
+    // Narrow the lower bound to the oldest instruction, so that the
+    // searches of this select start from it
+    const int slot = oldest();
+    if (slot != noSlot)
+        minSeqNum = seqNums[slot];
+}
+
+template <class DynInstPtr>
+void
+ReadyInstSet<DynInstPtr>::blockClass(int op_class)
+{
+    const auto &mask = classMasks[op_class];
+    for (size_t word = 0; word < candidates.size(); word++) {
+        candidates[word] &= ~mask[word];
+    }
+}
+
+template <class DynInstPtr>
+int
+ReadyInstSet<DynInstPtr>::oldest() const
+{
+    if (numInsts == 0)
+        return noSlot;
+
+    // Go around the ring from the slot of the oldest instruction: the
+    // rest of its word, the following words, then the start of its word
+    const size_t num_words = candidates.size();
+    const int start = slotOf(minSeqNum);
+    const size_t first = start / 64;
+    const uint64_t upper = ~(uint64_t)0 << (start % 64);
+
+    if (uint64_t bits = candidates[first] & upper)
+        return first * 64 + ctz64(bits);
+    for (size_t i = 1; i < num_words; i++) {
+        const size_t word = (first + i) & (num_words - 1);
+        if (candidates[word])
+            return word * 64 + ctz64(candidates[word]);
+    }
+    if (uint64_t bits = candidates[first] & ~upper)
+        return first * 64 + ctz64(bits);
+    return noSlot;
+}
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_READY_INST_SET_HH__
@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "cpu/o3/ready_inst_set.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+struct FakeInst
+{
+    InstSeqNum seqNum;
+};
+
+using FakeInstPtr = std::shared_ptr<FakeInst>;
+using FakeReadySet = o3::ReadyInstSet<FakeInstPtr>;
+
+FakeInstPtr
+makeInst(InstSeqNum seq_num)
+{
+    return std::make_shared<FakeInst>(FakeInst{seq_num});
+}
+
+/** Take the oldest candidate and return its sequence number. */
+InstSeqNum
+issue(FakeReadySet &set)
+{
+    const int slot = set.oldest();
+    EXPECT_NE(slot, FakeReadySet::noSlot);
+    if (slot == FakeReadySet::noSlot)
+        return 0;
+    const InstSeqNum seq_num = set.inst(slot)->seqNum;
+    set.remove(slot);
+    return seq_num;
+}
+
+} // anonymous namespace
+
+/** Instructions are selected oldest first across op classes. */
+TEST(ReadyInstSetTest, OldestFirst)
+{
+    FakeReadySet set(3);
+    set.push(2, makeInst(7));
+    set.push(0, makeInst(3));
+    set.push(1, makeInst(5));
+    set.push(0, makeInst(9));
+    set.push(2, makeInst(1));
+
+    set.beginSelect();
+    EXPECT_EQ(issue(set), 1);
+    EXPECT_EQ(issue(set), 3);
+    EXPECT_EQ(issue(set), 5);
+    EXPECT_EQ(issue(set), 7);
+    EXPECT_EQ(issue(set), 9);
+    EXPECT_EQ(set.oldest(), FakeReadySet::noSlot);
+    EXPECT_TRUE(set.empty());
+}
+
+/** A blocked op class is skipped until the next select. */
+TEST(ReadyInstSetTest, BlockClass)
+{
+    FakeReadySet set(2);
+    set.push(0, makeInst(1));
+    set.push(0, makeInst(2));
+    set.push(1, makeInst(3));
+
+    set.beginSelect();
+    int slot = set.oldest();
+    ASSERT_NE(slot, FakeReadySet::noSlot);
+    EXPECT_EQ(set.inst(slot)->seqNum, 1);
+    EXPECT_EQ(set.opClass(slot), 0);
+    set.blockClass(0);
+    EXPECT_EQ(issue(set), 3);
+    EXPECT_EQ(set.oldest(), FakeReadySet::noSlot);
+    EXPECT_EQ(set.size(0), 2);
+
+    // Instructions pushed during a select wait for the next one
+    set.push(1, makeInst(4));
+    EXPECT_EQ(set.oldest(), FakeReadySet::noSlot);
+
+    set.beginSelect();
+    EXPECT_EQ(issue(set), 1);
+    EXPECT_EQ(issue(set), 2);
+    EXPECT_EQ(issue(set), 4);
+}
+
+/** The ring grows when the sequence numbers span more than its slots. */
+TEST(ReadyInstSetTest, Grow)
+{
+    FakeReadySet set(1);
+    for (InstSeqNum seq_num = 200; seq_num > 0; seq_num--)
+        set.push(0, makeInst(seq_num));
+    EXPECT_EQ(set.size(0), 200);
+
+    set.beginSelect();
+    for (InstSeqNum seq_num = 1; seq_num <= 100; seq_num++)
+        EXPECT_EQ(issue(set), seq_num);
+
+    for (InstSeqNum seq_num = 300; seq_num > 250; seq_num--)
+        set.push(0, makeInst(seq_num));
+
+    set.beginSelect();
+    for (InstSeqNum seq_num = 101; seq_num <= 200; seq_num++)
+        EXPECT_EQ(issue(set), seq_num);
+    for (InstSeqNum seq_num = 251; seq_num <= 300; seq_num++)
+        EXPECT_EQ(issue(set), seq_num);
+    EXPECT_TRUE(set.empty());
+}
+
+/** Clearing the set drops the references to the instructions. */
+TEST(ReadyInstSetTest, Clear)
+{
+    FakeReadySet set(2);
+    FakeInstPtr inst = makeInst(1);
+    set.push(1, inst);
+    set.push(0, makeInst(2));
+    EXPECT_EQ(inst.use_count(), 2);
+
+    set.clear();
+    EXPECT_TRUE(set.empty());
+    EXPECT_EQ(set.size(1), 0);
+    EXPECT_EQ(inst.use_count(), 1);
+
+    set.beginSelect();
+    EXPECT_EQ(set.oldest(), FakeReadySet::noSlot);
+}
+
+/** Age order holds when the sequence numbers wrap around the ring. */
+TEST(ReadyInstSetTest, WrapAround)
+{
+    // The ring starts with 64 slots, so 64 and on wrap around to slot 0
+    FakeReadySet set(2);
+    set.push(0, makeInst(70));
+    set.push(1, makeInst(60));
+    set.push(1, makeInst(100));
+    set.push(0, makeInst(66));
+    set.push(0, makeInst(63));
+    set.push(1, makeInst(64));
+
+    set.beginSelect();
+    EXPECT_EQ(issue(set), 60);
+    EXPECT_EQ(issue(set), 63);
+    set.blockClass(1);
+    EXPECT_EQ(issue(set), 66);
+    EXPECT_EQ(issue(set), 70);
+    EXPECT_EQ(set.oldest(), FakeReadySet::noSlot);
+
+    // 122 takes the slot right before the one of 60
+    set.push(0, makeInst(122));
+    set.beginSelect();
+    EXPECT_EQ(issue(set), 64);
+    EXPECT_EQ(issue(set), 100);
+    EXPECT_EQ(issue(set), 122);
+    EXPECT_TRUE(set.empty());
+}
+
+/** Growing the ring during a select keeps the candidates. */
+TEST(ReadyInstSetTest, GrowDuringSelect)
+{
+    FakeReadySet set(2);
+    set.push(0, makeInst(10));
+    set.push(1, makeInst(20));
+    set.push(0, makeInst(30));
+
+    set.beginSelect();
+    set.blockClass(1);
+    set.push(1, makeInst(1000));
+    EXPECT_EQ(issue(set), 10);
+    EXPECT_EQ(issue(set), 30);
+    EXPECT_EQ(set.oldest(), FakeReadySet::noSlot);
+
+    set.beginSelect();
+    EXPECT_EQ(issue(set), 20);
+    EXPECT_EQ(issue(set), 1000);
+}
+
+/** Match sorted sets per op class over random pushes and selects. */
+TEST(ReadyInstSetTest, MatchesSortedSets)
+{
+    const int num_classes = 4;
+    FakeReadySet set(num_classes);
+    std::vector<std::set<InstSeqNum>> ref(num_classes);
+    std::mt19937 rng(1);
+
+    InstSeqNum next_seq_num = 1;
+    for (int cycle = 0; cycle < 20000; ++cycle) {
+        // Instructions become ready out of order within a window, and
+        // squashes now and then skip sequence numbers
+        std::vector<InstSeqNum> ready;
+        for (int i = rng() % 6; i > 0; --i)
+            ready.push_back(next_seq_num + rng() % 32);
+        next_seq_num += (rng() % 64 == 0) ? 500 : 4;
+        for (auto seq_num : ready) {
+            const int op_class = seq_num % num_classes;
+            if (ref[op_class].insert(seq_num).second)
+                set.push(op_class, makeInst(seq_num));
+        }
+
+        set.beginSelect();
+        std::vector<bool> blocked(num_classes, false);
+        for (int issued = 0; issued < 4; ) {
+            InstSeqNum expected = 0;
+            int expected_class = -1;
+            for (int c = 0; c < num_classes; ++c) {
+                if (!blocked[c] && !ref[c].empty() &&
+                    (expected_class < 0 || *ref[c].begin() < expected)) {
+                    expected = *ref[c].begin();
+                    expected_class = c;
+                }
+            }
+
+            const int slot = set.oldest();
+            if (expected_class < 0) {
+                ASSERT_EQ(slot, FakeReadySet::noSlot) << cycle;
+                break;
+            }
+            ASSERT_NE(slot, FakeReadySet::noSlot) << cycle;
+            ASSERT_EQ(set.inst(slot)->seqNum, expected) << cycle;
+
+            if (rng() % 4 == 0) {
+                set.blockClass(expected_class);
+                blocked[expected_class] = true;
+            } else {
+                set.remove(slot);
+                ref[expected_class].erase(ref[expected_class].begin());
+                ++issued;
+            }
+        }
+    }
+}
@@ -69,7 +69,7 @@ Rename::Rename(CPU *_cpu, const BaseO3CPUParams &params)
 {
     if (renameWidth > MaxWidth)
         fatal("renameWidth (%d) is larger than compiled limit (%d),\n"
-             "\tincrease MaxWidth in src/cpu/o3/limits.hh\n",
+             "\trebuild with a larger O3_MAX_WIDTH\n",
              renameWidth, static_cast<int>(MaxWidth));
 
     // @todo: Make into a parameter.
@@ -40,6 +40,7 @@
 
 #include "cpu/o3/rob.hh"
 
+#include <algorithm>
 #include <list>
 
 #include "base/logging.hh"
@@ -59,6 +60,7 @@ ROB::ROB(CPU *_cpu, const BaseO3CPUParams &params)
     : robPolicy(params.smtROBPolicy),
       cpu(_cpu),
       numEntries(params.numROBEntries),
+      instList(MaxThreads, CircularQueue<DynInstPtr>(numEntries)),
       squashWidth(params.squashWidth),
       numInstsInROB(0),
       numThreads(params.numThreads),
@@ -237,11 +239,10 @@ ROB::retireHead(ThreadID tid)
 
     assert(numInstsInROB > 0);
 
-    // Get the head ROB instruction by copying it and remove it from the list
-    InstIt head_it = instList[tid].begin();
-
-    DynInstPtr head_inst = std::move(*head_it);
-    instList[tid].erase(head_it);
+    // Get the head ROB instruction by moving it out of the list, which
+    // leaves no reference behind in the ring buffer
+    DynInstPtr head_inst = std::move(instList[tid].front());
+    instList[tid].pop_front();
 
     assert(head_inst->readyToCommit());
 
@@ -533,10 +534,14 @@ ROB::ROBStats::ROBStats(statistics::Group *parent)
 DynInstPtr
 ROB::findInst(ThreadID tid, InstSeqNum squash_inst)
 {
-    for (InstIt it = instList[tid].begin(); it != instList[tid].end(); it++) {
-        if ((*it)->seqNum == squash_inst) {
-            return *it;
-        }
+    // The instructions are in program order, so they are sorted by
+    // sequence number
+    InstIt it = std::lower_bound(instList[tid].begin(), instList[tid].end(),
+        squash_inst, [](const DynInstPtr &inst, InstSeqNum seq_num) {
+            return inst->seqNum < seq_num;
+        });
+    if (it != instList[tid].end() && (*it)->seqNum == squash_inst) {
+        return *it;
     }
     return NULL;
 }
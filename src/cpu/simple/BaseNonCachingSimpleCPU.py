@@ -51,6 +51,13 @@ class BaseNonCachingSimpleCPU(BaseAtomicSimpleCPU):
 
     numThreads = 1
 
+    decoded_block_cache = Param.Bool(False,
+        "Reuse decoded basic blocks rather than fetching and decoding "
+        "every instruction (requires memory backdoors, meant for "
+        "fast-forwarding)")
+    decoded_block_cache_size = Param.Unsigned(16384,
+        "Number of decoded basic blocks kept before the cache is flushed")
+
     @classmethod
     def memory_mode(cls):
         return 'atomic_noncaching'
@@ -33,6 +33,10 @@ class BaseTimingSimpleCPU(BaseSimpleCPU):
     cxx_header = "cpu/simple/timing.hh"
     cxx_class = 'gem5::TimingSimpleCPU'
 
+    fetch_buffer = Param.Bool(False,
+        "Keep the last fetched cache line in the CPU and serve later "
+        "fetches from it rather than sending a packet per instruction")
+
     @classmethod
     def memory_mode(cls):
         return 'timing'
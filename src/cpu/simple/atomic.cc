@@ -85,10 +85,10 @@ AtomicSimpleCPU::AtomicSimpleCPU(const BaseAtomicSimpleCPUParams &p)
       ppCommit(nullptr)
 {
     _status = Idle;
-    ifetch_req = std::make_shared<Request>();
-    data_read_req = std::make_shared<Request>();
-    data_write_req = std::make_shared<Request>();
-    data_amo_req = std::make_shared<Request>();
+    ifetch_req = Request::make();
+    data_read_req = Request::make();
+    data_write_req = Request::make();
+    data_amo_req = Request::make();
 }
 
 
@@ -629,117 +629,126 @@ AtomicSimpleCPU::tick()
         data_amo_req->setContext(cid);
     }
 
-    SimpleExecContext &t_info = *threadInfo[curThread];
-    SimpleThread *thread = t_info.thread;
-
     Tick latency = 0;
 
     for (int i = 0; i < width || locked; ++i) {
-        baseStats.numCycles++;
-        updateCycleCounters(BaseCPU::CPU_STATE_ON);
+        if (!executeInst(latency))
+            return;
+    }
 
-        if (!curStaticInst || !curStaticInst->isDelayedCommit()) {
-            checkForInterrupts();
-            checkPcEventQueue();
-        }
+    if (tryCompleteDrain())
+        return;
 
-        // We must have just got suspended by a PC event
-        if (_status == Idle) {
-            tryCompleteDrain();
-            return;
-        }
+    // instruction takes at least one cycle
+    if (latency < clockPeriod())
+        latency = clockPeriod();
 
-        serviceInstCountEvents();
+    if (_status != Idle)
+        reschedule(tickEvent, curTick() + latency, true);
+}
 
-        Fault fault = NoFault;
+bool
+AtomicSimpleCPU::executeInst(Tick &latency)
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+    SimpleThread *thread = t_info.thread;
 
-        const PCStateBase &pc = thread->pcState();
+    baseStats.numCycles++;
+    updateCycleCounters(BaseCPU::CPU_STATE_ON);
 
-        bool needToFetch = !isRomMicroPC(pc.microPC()) && !curMacroStaticInst;
-        if (needToFetch) {
-            ifetch_req->taskId(taskId());
-            setupFetchRequest(ifetch_req);
-            fault = thread->mmu->translateAtomic(ifetch_req, thread->getTC(),
-                                                 BaseMMU::Execute);
-        }
+    if (!curStaticInst || !curStaticInst->isDelayedCommit()) {
+        checkForInterrupts();
+        checkPcEventQueue();
+    }
 
-        if (fault == NoFault) {
-            Tick icache_latency = 0;
-            bool icache_access = false;
-            dcache_access = false; // assume no dcache access
-
-            if (needToFetch) {
-                // This is commented out because the decoder would act like
-                // a tiny cache otherwise. It wouldn't be flushed when needed
-                // like the I cache. It should be flushed, and when that works
-                // this code should be uncommented.
-                //Fetch more instruction memory if necessary
-                //if (decoder.needMoreBytes())
-                //{
-                    icache_access = true;
-                    icache_latency = fetchInstMem();
-                //}
-            }
+    // We must have just got suspended by a PC event
+    if (_status == Idle) {
+        tryCompleteDrain();
+        return false;
+    }
 
-            preExecute();
+    serviceInstCountEvents();
 
-            Tick stall_ticks = 0;
-            if (curStaticInst) {
-                fault = curStaticInst->execute(&t_info, traceData);
+    Fault fault = NoFault;
 
-                // keep an instruction count
-                if (fault == NoFault) {
-                    countInst();
-                    ppCommit->notify(std::make_pair(thread, curStaticInst));
-                } else if (traceData) {
-                    traceFault();
-                }
+    const PCStateBase &pc = thread->pcState();
 
-                if (fault != NoFault &&
-                    std::dynamic_pointer_cast<SyscallRetryFault>(fault)) {
-                    // Retry execution of system calls after a delay.
-                    // Prevents immediate re-execution since conditions which
-                    // caused the retry are unlikely to change every tick.
-                    stall_ticks += clockEdge(syscallRetryLatency) - curTick();
-                }
+    bool needToFetch = !isRomMicroPC(pc.microPC()) && !curMacroStaticInst;
+    if (needToFetch) {
+        ifetch_req->taskId(taskId());
+        setupFetchRequest(ifetch_req);
+        fault = thread->mmu->translateAtomic(ifetch_req, thread->getTC(),
+                                             BaseMMU::Execute);
+    }
 
-                postExecute();
-            }
+    if (fault == NoFault) {
+        Tick icache_latency = 0;
+        bool icache_access = false;
+        dcache_access = false; // assume no dcache access
 
-            // @todo remove me after debugging with legion done
-            if (curStaticInst && (!curStaticInst->isMicroop() ||
-                        curStaticInst->isFirstMicroop())) {
-                instCnt++;
-            }
+        if (needToFetch) {
+            // This is commented out because the decoder would act like
+            // a tiny cache otherwise. It wouldn't be flushed when needed
+            // like the I cache. It should be flushed, and when that works
+            // this code should be uncommented.
+            //Fetch more instruction memory if necessary
+            //if (decoder.needMoreBytes())
+            //{
+                icache_access = true;
+                icache_latency = fetchInstMem();
+            //}
+        }
+
+        preExecute();
 
-            if (simulate_inst_stalls && icache_access)
-                stall_ticks += icache_latency;
+        Tick stall_ticks = 0;
+        if (curStaticInst) {
+            fault = curStaticInst->execute(&t_info, traceData);
 
-            if (simulate_data_stalls && dcache_access)
-                stall_ticks += dcache_latency;
+            // keep an instruction count
+            if (fault == NoFault) {
+                countInst();
+                ppCommit->notify(std::make_pair(thread, curStaticInst));
+            } else if (traceData) {
+                traceFault();
+            }
 
-            if (stall_ticks) {
-                // the atomic cpu does its accounting in ticks, so
-                // keep counting in ticks but round to the clock
-                // period
-                latency += divCeil(stall_ticks, clockPeriod()) *
-                    clockPeriod();
+            if (fault != NoFault &&
+                std::dynamic_pointer_cast<SyscallRetryFault>(fault)) {
+                // Retry execution of system calls after a delay.
+                // Prevents immediate re-execution since conditions which
+                // caused the retry are unlikely to change every tick.
+                stall_ticks += clockEdge(syscallRetryLatency) - curTick();
             }
 
+            postExecute();
         }
-        if (fault != NoFault || !t_info.stayAtPC)
-            advancePC(fault);
-    }
 
-    if (tryCompleteDrain())
-        return;
+        // @todo remove me after debugging with legion done
+        if (curStaticInst && (!curStaticInst->isMicroop() ||
+                    curStaticInst->isFirstMicroop())) {
+            instCnt++;
+        }
 
-    // instruction takes at least one cycle
-    if (latency < clockPeriod())
-        latency = clockPeriod();
+        if (simulate_inst_stalls && icache_access)
+            stall_ticks += icache_latency;
 
-    if (_status != Idle)
-        reschedule(tickEvent, curTick() + latency, true);
+        if (simulate_data_stalls && dcache_access)
+            stall_ticks += dcache_latency;
+
+        if (stall_ticks) {
+            // the atomic cpu does its accounting in ticks, so
+            // keep counting in ticks but round to the clock
+            // period
+            latency += divCeil(stall_ticks, clockPeriod()) *
+                clockPeriod();
+        }
+
+    }
+    if (fault != NoFault || !t_info.stayAtPC)
+        advancePC(fault);
+
+    return true;
 }
 
 Tick
@@ -68,7 +68,15 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     const bool simulate_inst_stalls;
 
     // main simulation loop (one cycle)
-    void tick();
+    virtual void tick();
+
+    /**
+     * Execute an instruction, or a microop, of the current thread.
+     *
+     * @param latency Stall ticks of the instruction are added to it.
+     * @return false if the CPU got suspended, and the tick must end.
+     */
+    bool executeInst(Tick &latency);
 
     /**
      * Check if a system is in a drained state.
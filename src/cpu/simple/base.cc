@@ -300,6 +300,15 @@ BaseSimpleCPU::serviceInstCountEvents()
     t_info.thread->comInstEventQueue.serviceEvents(t_info.numInst);
 }
 
+StaticInstPtr
+BaseSimpleCPU::decodeInst(PCStateBase &pc_state, Addr fetch_pc)
+{
+    auto &decoder = threadInfo[curThread]->thread->decoder;
+
+    decoder->moreBytes(pc_state, fetch_pc);
+    return decoder->decode(pc_state);
+}
+
 void
 BaseSimpleCPU::preExecute()
 {
@@ -329,11 +338,9 @@ BaseSimpleCPU::preExecute()
         Addr fetch_pc =
             (pc_state.instAddr() & decoder->pcMask()) + t_info.fetchOffset;
 
-        decoder->moreBytes(pc_state, fetch_pc);
-
         //Decode an instruction if one is ready. Otherwise, we'll have to
         //fetch beyond the MachInst at the current pc.
-        instPtr = decoder->decode(pc_state);
+        instPtr = decodeInst(pc_state, fetch_pc);
         if (instPtr) {
             t_info.stayAtPC = false;
             thread->pcState(pc_state);
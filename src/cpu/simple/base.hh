@@ -132,6 +132,15 @@ class BaseSimpleCPU : public BaseCPU
 
     std::unique_ptr<PCStateBase> preExecuteTempPC;
 
+    /**
+     * Decode the instruction at pc_state from the bytes last fetched
+     * from fetch_pc, updating pc_state as the decoder does.
+     *
+     * @return The decoded instruction, or nullptr if more bytes are
+     * needed.
+     */
+    virtual StaticInstPtr decodeInst(PCStateBase &pc_state, Addr fetch_pc);
+
   public:
     void checkForInterrupts();
     void setupFetchRequest(const RequestPtr &req);
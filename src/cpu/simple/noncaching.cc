@@ -38,21 +38,45 @@
 #include "cpu/simple/noncaching.hh"
 
 #include <cassert>
+#include <cstring>
 
 #include "arch/generic/decoder.hh"
+#include "base/trace.hh"
+#include "debug/SimpleCPU.hh"
+#include "sim/eventq.hh"
 
 namespace gem5
 {
 
 NonCachingSimpleCPU::NonCachingSimpleCPU(
         const BaseNonCachingSimpleCPUParams &p)
-    : AtomicSimpleCPU(p)
+    : AtomicSimpleCPU(p),
+      useDecodedBlocks(p.decoded_block_cache),
+      maxDecodedBlocks(p.decoded_block_cache_size),
+      decodedBlockStats(this)
 {
     assert(p.numThreads == 1);
     fatal_if(!FullSystem && p.workload.size() != 1,
              "only one workload allowed");
 }
 
+NonCachingSimpleCPU::DecodedBlockStats::DecodedBlockStats(
+        statistics::Group *parent)
+    : statistics::Group(parent, "decodedBlocks"),
+      ADD_STAT(hits, statistics::units::Count::get(),
+               "Number of instructions found in the decoded block cache"),
+      ADD_STAT(misses, statistics::units::Count::get(),
+               "Number of instructions fetched and decoded"),
+      ADD_STAT(stale, statistics::units::Count::get(),
+               "Number of cached instructions whose bytes had changed"),
+      ADD_STAT(flushes, statistics::units::Count::get(),
+               "Number of times the decoded block cache was flushed"),
+      ADD_STAT(chained, statistics::units::Count::get(),
+               "Number of instructions run from the tick of the "
+               "instruction before them")
+{
+}
+
 void
 NonCachingSimpleCPU::verifyMemoryMode() const
 {
@@ -62,6 +86,64 @@ NonCachingSimpleCPU::verifyMemoryMode() const
     }
 }
 
+void
+NonCachingSimpleCPU::tick()
+{
+    // Running ahead would break the synchronization of the event queues
+    if (!useDecodedBlocks || numMainEventQueues > 1) {
+        AtomicSimpleCPU::tick();
+        return;
+    }
+
+    DPRINTF(SimpleCPU, "Tick\n");
+
+    swapActiveThread();
+
+    while (true) {
+        Tick latency = 0;
+
+        for (int i = 0; i < width || locked; ++i) {
+            if (!executeInst(latency))
+                return;
+        }
+
+        if (tryCompleteDrain())
+            return;
+
+        // instruction takes at least one cycle
+        if (latency < clockPeriod())
+            latency = clockPeriod();
+
+        if (_status == Idle)
+            return;
+
+        // Run the next instruction right away if it follows in the
+        // block and nothing else happens until then. Interrupts and
+        // instruction count events are checked by each instruction.
+        const Tick next = curTick() + latency;
+        EventQueue *eventq = eventQueue();
+        if (!followingBlock() || drainState() != DrainState::Running ||
+                eventq->empty() || next >= eventq->nextTick()) {
+            reschedule(tickEvent, next, true);
+            return;
+        }
+
+        ++decodedBlockStats.chained;
+        setCurTick(next);
+    }
+}
+
+bool
+NonCachingSimpleCPU::followingBlock() const
+{
+    if (curMacroStaticInst)
+        return true;
+
+    return curBlock && curBlockIdx < curBlock->size() &&
+        (*curBlock)[curBlockIdx].pc->instAddr() ==
+        threadInfo[curThread]->thread->pcState().instAddr();
+}
+
 Tick
 NonCachingSimpleCPU::sendPacket(RequestPort &port, const PacketPtr &pkt)
 {
@@ -90,6 +172,9 @@ NonCachingSimpleCPU::sendPacket(RequestPort &port, const PacketPtr &pkt)
 Tick
 NonCachingSimpleCPU::fetchInstMem()
 {
+    fetchedInst = nullptr;
+    fetchedFromBackdoor = false;
+
     auto bd_it = memBackdoors.contains(ifetch_req->getPaddr());
     if (bd_it == memBackdoors.end())
         return AtomicSimpleCPU::fetchInstMem();
@@ -97,9 +182,158 @@ NonCachingSimpleCPU::fetchInstMem()
     auto &decoder = threadInfo[curThread]->thread->decoder;
 
     auto *bd = bd_it->second;
+
+    // Only the first fetch of an instruction can be skipped.
+    if (useDecodedBlocks && threadInfo[curThread]->fetchOffset == 0) {
+        const Addr inst_addr =
+            threadInfo[curThread]->thread->pcState().instAddr();
+        const Addr paddr =
+            ifetch_req->getPaddr() + (inst_addr - ifetch_req->getVaddr());
+        fetchedInst = lookupDecoded(*bd, paddr);
+        if (fetchedInst)
+            return 0;
+    }
+
     Addr offset = ifetch_req->getPaddr() - bd->range().start();
     memcpy(decoder->moreBytesPtr(), bd->ptr() + offset, ifetch_req->getSize());
+    fetchedFromBackdoor = true;
     return 0;
 }
 
+const NonCachingSimpleCPU::DecodedInst *
+NonCachingSimpleCPU::lookupDecoded(const MemBackdoor &bd, Addr paddr)
+{
+    const DecodedInst *inst = nullptr;
+
+    if (curBlock && curBlockIdx < curBlock->size() &&
+            (*curBlock)[curBlockIdx].paddr == paddr) {
+        // Following the current block.
+        inst = &(*curBlock)[curBlockIdx];
+    } else {
+        auto it = decodedBlocks.find(paddr);
+        if (it != decodedBlocks.end()) {
+            curBlock = &it->second;
+            curBlockIdx = 0;
+            inst = &curBlock->front();
+        } else if (!curBlock || curBlockIdx < curBlock->size() ||
+                curBlockIdx >= maxBlockInsts ||
+                curBlock->back().inst->isControl()) {
+            // The instruction will start a new block, unless it can
+            // extend the current one.
+            curBlock = nullptr;
+        }
+    }
+
+    if (!inst)
+        return nullptr;
+
+    SimpleThread *thread = threadInfo[curThread]->thread;
+    uint64_t context;
+    if (!thread->decoder->decodeContext(thread->pcState(), context) ||
+            context != inst->context || !inst->pc->equals(thread->pcState())) {
+        return nullptr;
+    }
+
+    const uint8_t *bytes =
+        bd.ptr() + (ifetch_req->getPaddr() - bd.range().start());
+    if (memcmp(bytes, &inst->bytes, ifetch_req->getSize()) != 0) {
+        ++decodedBlockStats.stale;
+        return nullptr;
+    }
+
+    return inst;
+}
+
+StaticInstPtr
+NonCachingSimpleCPU::decodeInst(PCStateBase &pc_state, Addr fetch_pc)
+{
+    if (fetchedInst) {
+        const DecodedInst *decoded = fetchedInst;
+        fetchedInst = nullptr;
+        ++decodedBlockStats.hits;
+        ++curBlockIdx;
+
+        pc_state.update(*decoded->nextPC);
+        return decoded->inst;
+    }
+
+    if (!useDecodedBlocks)
+        return AtomicSimpleCPU::decodeInst(pc_state, fetch_pc);
+
+    auto &decoder = threadInfo[curThread]->thread->decoder;
+
+    // The decoded instruction can only be validated later if it was
+    // decoded from a single fetch, read through a backdoor.
+    uint64_t context = 0;
+    bool cacheable = fetchedFromBackdoor &&
+        fetch_pc == (pc_state.instAddr() & decoder->pcMask()) &&
+        ifetch_req->getSize() <= sizeof(DecodedInst::bytes) &&
+        decoder->decodeContext(pc_state, context);
+
+    std::unique_ptr<PCStateBase> pc;
+    if (cacheable)
+        pc.reset(pc_state.clone());
+
+    StaticInstPtr inst = AtomicSimpleCPU::decodeInst(pc_state, fetch_pc);
+    if (!inst || !cacheable) {
+        curBlock = nullptr;
+        return inst;
+    }
+
+    ++decodedBlockStats.misses;
+
+    DecodedInst decoded;
+    decoded.paddr =
+        ifetch_req->getPaddr() + (pc->instAddr() - ifetch_req->getVaddr());
+    decoded.bytes = 0;
+    memcpy(&decoded.bytes, decoder->moreBytesPtr(), ifetch_req->getSize());
+    decoded.context = context;
+    decoded.pc = std::move(pc);
+    decoded.nextPC.reset(pc_state.clone());
+    decoded.inst = inst;
+
+    if (!curBlock) {
+        if (decodedBlocks.size() >= maxDecodedBlocks)
+            flushDecodedBlocks();
+        curBlock = &decodedBlocks[decoded.paddr];
+        curBlockIdx = 0;
+    }
+
+    // Replace whatever followed in the block, it was decoded along a
+    // different path or is stale.
+    curBlock->resize(curBlockIdx);
+    curBlock->push_back(std::move(decoded));
+    ++curBlockIdx;
+
+    return inst;
+}
+
+void
+NonCachingSimpleCPU::flushDecodedBlocks()
+{
+    if (!decodedBlocks.empty())
+        ++decodedBlockStats.flushes;
+
+    decodedBlocks.clear();
+    curBlock = nullptr;
+    curBlockIdx = 0;
+    fetchedInst = nullptr;
+}
+
+void
+NonCachingSimpleCPU::drainResume()
+{
+    // Memory may have been restored from a checkpoint, and the decoder
+    // state may have changed.
+    flushDecodedBlocks();
+    AtomicSimpleCPU::drainResume();
+}
+
+void
+NonCachingSimpleCPU::takeOverFrom(BaseCPU *old_cpu)
+{
+    flushDecodedBlocks();
+    AtomicSimpleCPU::takeOverFrom(old_cpu);
+}
+
 } // namespace gem5
@@ -38,8 +38,15 @@
 #ifndef __CPU_SIMPLE_NONCACHING_HH__
 #define __CPU_SIMPLE_NONCACHING_HH__
 
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "arch/generic/pcstate.hh"
 #include "base/addr_range_map.hh"
+#include "base/statistics.hh"
 #include "cpu/simple/atomic.hh"
+#include "cpu/static_inst.hh"
 #include "mem/backdoor.hh"
 #include "params/BaseNonCachingSimpleCPU.hh"
 
@@ -49,6 +56,25 @@ namespace gem5
 /**
  * The NonCachingSimpleCPU is an AtomicSimpleCPU using the
  * 'atomic_noncaching' memory mode instead of just 'atomic'.
+ *
+ * For fast-forwarding, it can keep the instructions it decodes in a
+ * cache of basic blocks. The instructions of a block are chained in
+ * the order they were executed, so following the block only takes a
+ * comparison per instruction, and a hash lookup on the physical
+ * address of the instruction is only needed to enter a block. An
+ * instruction is reused if its bytes in memory, read through a
+ * memory backdoor, the PC and the decoding context (see
+ * InstDecoder::decodeContext()) are the same as when it was decoded.
+ * This skips both the instruction fetch through the memory system
+ * and the decoder. Writes to code pages, by this CPU or any other
+ * agent, are caught by the byte comparison.
+ *
+ * While the instructions of a block are found in the cache, they are
+ * run from the same tick event, one after the other. The time is
+ * moved on by the latency of each instruction in between, and the
+ * block is left before the next event in the queue, so the rest of the
+ * system sees the same instructions at the same ticks as without the
+ * cache.
  */
 class NonCachingSimpleCPU : public AtomicSimpleCPU
 {
@@ -57,11 +83,90 @@ class NonCachingSimpleCPU : public AtomicSimpleCPU
 
     void verifyMemoryMode() const override;
 
+    void drainResume() override;
+    void takeOverFrom(BaseCPU *old_cpu) override;
+
   protected:
     AddrRangeMap<MemBackdoorPtr, 1> memBackdoors;
 
+    void tick() override;
+
     Tick sendPacket(RequestPort &port, const PacketPtr &pkt) override;
     Tick fetchInstMem() override;
+    StaticInstPtr decodeInst(PCStateBase &pc_state, Addr fetch_pc) override;
+
+    /** An instruction of a decoded basic block. */
+    struct DecodedInst
+    {
+        /** Physical address of the instruction. */
+        Addr paddr;
+        /** Bytes fetched to decode the instruction. */
+        uint64_t bytes;
+        /** Decoding context of the instruction. */
+        uint64_t context;
+        /** PC before and after decoding the instruction. */
+        std::unique_ptr<PCStateBase> pc;
+        std::unique_ptr<PCStateBase> nextPC;
+        /** The decoded (possibly macroop) instruction. */
+        StaticInstPtr inst;
+    };
+
+    typedef std::vector<DecodedInst> DecodedBlock;
+
+    /** Whether the decoded block cache is enabled. */
+    const bool useDecodedBlocks;
+    /** Maximum number of blocks kept before the cache is flushed. */
+    const size_t maxDecodedBlocks;
+    /** Maximum number of instructions in a block. */
+    static constexpr size_t maxBlockInsts = 64;
+
+    /** Decoded blocks, indexed by the physical address of their start. */
+    std::unordered_map<Addr, DecodedBlock> decodedBlocks;
+
+    /**
+     * Block and position in the block of the instruction being
+     * fetched. If the index is past the end of the block, the
+     * instruction will be appended to it when decoded. If the block is
+     * null, the instruction starts a new block.
+     */
+    DecodedBlock *curBlock = nullptr;
+    size_t curBlockIdx = 0;
+
+    /** The instruction found for the current fetch, if any. */
+    const DecodedInst *fetchedInst = nullptr;
+    /** Whether the bytes of the current fetch came from a backdoor. */
+    bool fetchedFromBackdoor = false;
+
+    /**
+     * Look for a valid decoded instruction for the current fetch
+     * in the decoded block cache.
+     */
+    const DecodedInst *lookupDecoded(const MemBackdoor &bd, Addr paddr);
+
+    /** Drop all the decoded blocks. */
+    void flushDecodedBlocks();
+
+    /**
+     * Whether the next instruction is the next one of the current
+     * block, or a microop of the current instruction.
+     */
+    bool followingBlock() const;
+
+    struct DecodedBlockStats : public statistics::Group
+    {
+        DecodedBlockStats(statistics::Group *parent);
+
+        /** Instructions found in the cache. */
+        statistics::Scalar hits;
+        /** Instructions that had to be fetched and decoded. */
+        statistics::Scalar misses;
+        /** Cached instructions whose bytes had been overwritten. */
+        statistics::Scalar stale;
+        /** Number of times the whole cache was dropped. */
+        statistics::Scalar flushes;
+        /** Instructions run from the tick of the one before them. */
+        statistics::Scalar chained;
+    } decodedBlockStats;
 };
 
 } // namespace gem5
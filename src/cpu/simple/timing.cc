@@ -41,6 +41,8 @@
 
 #include "cpu/simple/timing.hh"
 
+#include <cstring>
+
 #include "arch/generic/decoder.hh"
 #include "base/compiler.hh"
 #include "config/the_isa.hh"
@@ -77,11 +79,27 @@ TimingSimpleCPU::TimingCPUPort::TickEvent::schedule(PacketPtr _pkt, Tick t)
 TimingSimpleCPU::TimingSimpleCPU(const BaseTimingSimpleCPUParams &p)
     : BaseSimpleCPU(p), fetchTranslation(this), icachePort(this),
       dcachePort(this), ifetch_pkt(NULL), dcache_pkt(NULL), previousCycle(0),
-      fetchEvent([this]{ fetch(); }, name())
+      fetchEvent([this]{ fetch(); }, name()),
+      fetchBuffer(p.fetch_buffer, cacheLineSize()),
+      fetchBufferEvent([this]{ completeIfetch(NULL); },
+                       name() + ".fetchBufferEvent"),
+      fetchBufferStats(this)
 {
     _status = Idle;
 }
 
+TimingSimpleCPU::FetchBufferStats::FetchBufferStats(
+        statistics::Group *parent)
+    : statistics::Group(parent, "fetchBuffer"),
+      ADD_STAT(hits, statistics::units::Count::get(),
+               "Number of fetches served from the fetch buffer"),
+      ADD_STAT(misses, statistics::units::Count::get(),
+               "Number of lines fetched into the fetch buffer"),
+      ADD_STAT(invalidations, statistics::units::Count::get(),
+               "Number of buffered lines dropped by writes or snoops")
+{
+}
+
 
 
 TimingSimpleCPU::~TimingSimpleCPU()
@@ -125,6 +143,10 @@ TimingSimpleCPU::drainResume()
     DPRINTF(SimpleCPU, "Resume\n");
     verifyMemoryMode();
 
+    // Memory may have been changed behind our back while drained,
+    // e.g., by a checkpoint restore.
+    invalidateFetchBuffer();
+
     assert(!threadContexts.empty());
 
     _status = BaseSimpleCPU::Idle;
@@ -193,6 +215,7 @@ TimingSimpleCPU::takeOverFrom(BaseCPU *oldCPU)
 {
     BaseSimpleCPU::takeOverFrom(oldCPU);
 
+    invalidateFetchBuffer();
     previousCycle = curCycle();
 }
 
@@ -304,6 +327,9 @@ TimingSimpleCPU::sendData(const RequestPtr &req, uint8_t *data, uint64_t *res,
     PacketPtr pkt = buildPacket(req, read);
     pkt->dataDynamic<uint8_t>(data);
 
+    if (pkt->isWrite())
+        invalidateFetchBuffer(req->getPaddr(), req->getSize());
+
     // hardware transactional memory
     // If the core is in transactional mode or if the request is HtmCMD
     // to abort a transaction, the packet should reflect that it is
@@ -351,6 +377,11 @@ TimingSimpleCPU::sendSplitData(const RequestPtr &req1, const RequestPtr &req2,
     PacketPtr pkt1, pkt2;
     buildSplitPacket(pkt1, pkt2, req1, req2, req, data, read);
 
+    if (pkt1->isWrite()) {
+        invalidateFetchBuffer(req1->getPaddr(), req1->getSize());
+        invalidateFetchBuffer(req2->getPaddr(), req2->getSize());
+    }
+
     // hardware transactional memory
     // HTM commands should never use SplitData
     assert(!req1->isHTMCmd() && !req2->isHTMCmd());
@@ -433,7 +464,7 @@ TimingSimpleCPU::buildSplitPacket(PacketPtr &pkt1, PacketPtr &pkt2,
     pkt1 = buildPacket(req1, read);
     pkt2 = buildPacket(req2, read);
 
-    PacketPtr pkt = new Packet(req, pkt1->cmd.responseCommand());
+    PacketPtr pkt = Packet::make(req, pkt1->cmd.responseCommand());
 
     pkt->dataDynamic<uint8_t>(data);
     pkt1->dataStatic<uint8_t>(data);
@@ -464,7 +495,7 @@ TimingSimpleCPU::initiateMemRead(Addr addr, unsigned size,
     if (traceData)
         traceData->setMem(addr, size, flags);
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::make(
         addr, size, flags, dataRequestorId(), pc, thread->contextId());
     req->setByteEnable(byte_enable);
 
@@ -546,7 +577,7 @@ TimingSimpleCPU::writeMem(uint8_t *data, unsigned size,
     if (traceData)
         traceData->setMem(addr, size, flags);
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::make(
         addr, size, flags, dataRequestorId(), pc, thread->contextId());
     req->setByteEnable(byte_enable);
 
@@ -602,7 +633,7 @@ TimingSimpleCPU::initiateMemAMO(Addr addr, unsigned size,
     if (traceData)
         traceData->setMem(addr, size, flags);
 
-    RequestPtr req = std::make_shared<Request>(addr, size, flags,
+    RequestPtr req = Request::make(addr, size, flags,
                             dataRequestorId(), pc, thread->contextId(),
                             std::move(amo_op));
 
@@ -699,7 +730,7 @@ TimingSimpleCPU::fetch()
 
     if (needToFetch) {
         _status = BaseSimpleCPU::Running;
-        RequestPtr ifetch_req = std::make_shared<Request>();
+        RequestPtr ifetch_req = Request::make();
         ifetch_req->taskId(taskId());
         ifetch_req->setContext(thread->contextId());
         setupFetchRequest(ifetch_req);
@@ -725,8 +756,39 @@ TimingSimpleCPU::sendFetch(const Fault &fault, const RequestPtr &req,
     if (fault == NoFault) {
         DPRINTF(SimpleCPU, "Sending fetch for addr %#x(pa: %#x)\n",
                 req->getVaddr(), req->getPaddr());
-        ifetch_pkt = new Packet(req, MemCmd::ReadReq);
-        ifetch_pkt->dataStatic(decoder->moreBytesPtr());
+
+        const Addr line_size = cacheLineSize();
+        const Addr line_addr = req->getPaddr() & ~(line_size - 1);
+        const bool use_buffer = fetchBuffer.enabled &&
+            !req->isUncacheable() &&
+            req->getPaddr() + req->getSize() <= line_addr + line_size;
+
+        if (use_buffer && fetchFromBuffer(req, decoder->moreBytesPtr())) {
+            DPRINTF(SimpleCPU, " -- served by fetch buffer\n");
+            // Complete on the next cycle as a single cycle instruction
+            // cache hit would, which also keeps us from recursing
+            // through fetch() for every buffered instruction.
+            _status = IcacheWaitResponse;
+            schedule(fetchBufferEvent, clockEdge(Cycles(1)));
+
+            updateCycleCounts();
+            updateCycleCounters(BaseCPU::CPU_STATE_ON);
+            return;
+        }
+
+        if (use_buffer) {
+            // Fetch the whole line, the response fills the buffer.
+            ++fetchBufferStats.misses;
+            fetchBuffer.valid = false;
+            fetchBuffer.filling = true;
+            fetchBuffer.fillSquashed = false;
+            fetchBuffer.addr = line_addr;
+            ifetch_pkt = Packet::make(req, MemCmd::ReadReq, line_size);
+            ifetch_pkt->dataStatic(fetchBuffer.data.data());
+        } else {
+            ifetch_pkt = Packet::make(req, MemCmd::ReadReq);
+            ifetch_pkt->dataStatic(decoder->moreBytesPtr());
+        }
         DPRINTF(SimpleCPU, " -- pkt addr: %#x\n", ifetch_pkt->getAddr());
 
         if (!icachePort.sendTimingReq(ifetch_pkt)) {
@@ -749,6 +811,67 @@ TimingSimpleCPU::sendFetch(const Fault &fault, const RequestPtr &req,
     updateCycleCounters(BaseCPU::CPU_STATE_ON);
 }
 
+bool
+TimingSimpleCPU::fetchFromBuffer(const RequestPtr &req, uint8_t *dest)
+{
+    const Addr paddr = req->getPaddr();
+    const Addr line_addr = paddr & ~(Addr(cacheLineSize()) - 1);
+    if (!fetchBuffer.valid || fetchBuffer.addr != line_addr)
+        return false;
+
+    ++fetchBufferStats.hits;
+    std::memcpy(dest, fetchBuffer.data.data() + (paddr - fetchBuffer.addr),
+                req->getSize());
+    return true;
+}
+
+void
+TimingSimpleCPU::fillFetchBuffer(PacketPtr pkt)
+{
+    assert(fetchBuffer.filling && pkt->getAddr() == fetchBuffer.addr);
+
+    auto &decoder = threadInfo[curThread]->thread->decoder;
+    const RequestPtr &req = pkt->req;
+    std::memcpy(decoder->moreBytesPtr(),
+                fetchBuffer.data.data() + (req->getPaddr() - pkt->getAddr()),
+                req->getSize());
+
+    // If the line was written while the fill was in flight the data
+    // may predate the write. It is still good enough for the fetch
+    // that requested it, which was ordered before the write, but it
+    // must not be used for later ones.
+    fetchBuffer.valid = !fetchBuffer.fillSquashed;
+    fetchBuffer.filling = false;
+    fetchBuffer.fillSquashed = false;
+}
+
+void
+TimingSimpleCPU::invalidateFetchBuffer(Addr addr, Addr size)
+{
+    if (!fetchBuffer.valid && !fetchBuffer.filling)
+        return;
+
+    if (addr >= fetchBuffer.addr + fetchBuffer.data.size() ||
+        addr + size <= fetchBuffer.addr) {
+        return;
+    }
+
+    DPRINTF(SimpleCPU, "Invalidating fetch buffer line %#x\n",
+            fetchBuffer.addr);
+    ++fetchBufferStats.invalidations;
+    fetchBuffer.valid = false;
+    if (fetchBuffer.filling)
+        fetchBuffer.fillSquashed = true;
+}
+
+void
+TimingSimpleCPU::invalidateFetchBuffer()
+{
+    fetchBuffer.valid = false;
+    if (fetchBuffer.filling)
+        fetchBuffer.fillSquashed = true;
+}
+
 
 void
 TimingSimpleCPU::advanceInst(const Fault &fault)
@@ -835,8 +958,11 @@ TimingSimpleCPU::completeIfetch(PacketPtr pkt)
     updateCycleCounts();
     updateCycleCounters(BaseCPU::CPU_STATE_ON);
 
-    if (pkt)
+    if (pkt) {
         pkt->req->setAccessLatency();
+        if (fetchBuffer.filling)
+            fillFetchBuffer(pkt);
+    }
 
 
     preExecute();
@@ -926,6 +1052,20 @@ TimingSimpleCPU::IcachePort::recvTimingResp(PacketPtr pkt)
     return true;
 }
 
+void
+TimingSimpleCPU::IcachePort::recvTimingSnoopReq(PacketPtr pkt)
+{
+    if (pkt->isInvalidate() || pkt->isWrite())
+        cpu->invalidateFetchBuffer(pkt->getAddr(), pkt->getSize());
+}
+
+void
+TimingSimpleCPU::IcachePort::recvFunctionalSnoop(PacketPtr pkt)
+{
+    if (pkt->isWrite())
+        cpu->invalidateFetchBuffer(pkt->getAddr(), pkt->getSize());
+}
+
 void
 TimingSimpleCPU::IcachePort::recvReqRetry()
 {
@@ -1102,6 +1242,7 @@ TimingSimpleCPU::DcachePort::recvTimingSnoopReq(PacketPtr pkt)
     // using caches) It is not necessary to wake up the processor on
     // all incoming packets
     if (pkt->isInvalidate() || pkt->isWrite()) {
+        cpu->invalidateFetchBuffer(pkt->getAddr(), pkt->getSize());
         for (auto &t_info : cpu->threadInfo) {
             t_info->thread->getIsaPtr()->handleLockedSnoop(pkt,
                     cacheBlockMask);
@@ -1128,6 +1269,9 @@ TimingSimpleCPU::DcachePort::recvTimingSnoopReq(PacketPtr pkt)
 void
 TimingSimpleCPU::DcachePort::recvFunctionalSnoop(PacketPtr pkt)
 {
+    if (pkt->isWrite())
+        cpu->invalidateFetchBuffer(pkt->getAddr(), pkt->getSize());
+
     for (ThreadID tid = 0; tid < cpu->numThreads; tid++) {
         if (cpu->getCpuAddrMonitor(tid)->doMonitor(pkt)) {
             cpu->wakeup(tid);
@@ -1245,7 +1389,7 @@ TimingSimpleCPU::initiateMemMgmtCmd(Request::Flags flags)
     if (traceData)
         traceData->setMem(addr, size, flags);
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::make(
         addr, size, flags, dataRequestorId());
 
     req->setPC(pc);
@@ -1300,7 +1444,7 @@ TimingSimpleCPU::htmSendAbortSignal(ThreadID tid, uint64_t htm_uid,
 
     // notify l1 d-cache (ruby) that core has aborted transaction
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::make(
         addr, size, flags, dataRequestorId());
 
     req->setPC(pc);
@@ -41,7 +41,10 @@
 #ifndef __CPU_SIMPLE_TIMING_HH__
 #define __CPU_SIMPLE_TIMING_HH__
 
+#include <vector>
+
 #include "arch/generic/mmu.hh"
+#include "base/statistics.hh"
 #include "cpu/simple/base.hh"
 #include "cpu/simple/exec_context.hh"
 #include "cpu/translation.hh"
@@ -200,6 +203,16 @@ class TimingSimpleCPU : public BaseSimpleCPU
 
         virtual void recvReqRetry();
 
+        /** Snoop writes and invalidations to keep the fetch buffer
+         * coherent with the rest of the memory system.
+         */
+        virtual void recvTimingSnoopReq(PacketPtr pkt);
+        virtual void recvFunctionalSnoop(PacketPtr pkt);
+
+        virtual bool isSnooping() const {
+            return cpu->fetchBuffer.enabled;
+        }
+
         struct ITickEvent : public TickEvent
         {
 
@@ -334,6 +347,72 @@ class TimingSimpleCPU : public BaseSimpleCPU
 
     EventFunctionWrapper fetchEvent;
 
+    /**
+     * A copy of the most recently fetched instruction cache line.
+     * Fetches that fall within the buffered line are served from it
+     * on the next cycle rather than by sending a packet to the
+     * instruction cache. The line is dropped on any snooped write or
+     * invalidation and on stores from this CPU that overlap it, which
+     * also covers self-modifying code.
+     */
+    struct FetchBuffer
+    {
+        FetchBuffer(bool _enabled, unsigned line_size)
+            : enabled(_enabled), data(_enabled ? line_size : 0)
+        {}
+
+        /** Whether the fetch buffer is used at all. */
+        const bool enabled;
+        /** The buffer holds the line at addr. */
+        bool valid = false;
+        /** A fill for the line at addr is in flight. */
+        bool filling = false;
+        /** The line was invalidated while its fill was in flight. */
+        bool fillSquashed = false;
+        /** Physical address of the buffered (or filling) line. */
+        Addr addr = 0;
+        /** Line data, also used as the target of the fill packet. */
+        std::vector<uint8_t> data;
+    };
+
+    FetchBuffer fetchBuffer;
+
+    /** Completes a fetch served from the fetch buffer. */
+    EventFunctionWrapper fetchBufferEvent;
+
+    /**
+     * Try to serve a fetch from the fetch buffer.
+     *
+     * @param req The translated fetch request.
+     * @param dest Where to copy the instruction bytes.
+     * @return Whether the buffer held the bytes requested.
+     */
+    bool fetchFromBuffer(const RequestPtr &req, uint8_t *dest);
+
+    /**
+     * Install a fetched line in the fetch buffer and copy the bytes
+     * originally requested to the decoder.
+     */
+    void fillFetchBuffer(PacketPtr pkt);
+
+    /** Drop the fetch buffer if it overlaps [addr, addr + size). */
+    void invalidateFetchBuffer(Addr addr, Addr size);
+
+    /** Unconditionally drop the fetch buffer. */
+    void invalidateFetchBuffer();
+
+    struct FetchBufferStats : public statistics::Group
+    {
+        FetchBufferStats(statistics::Group *parent);
+
+        /** Fetches served from the fetch buffer. */
+        statistics::Scalar hits;
+        /** Lines fetched into the fetch buffer. */
+        statistics::Scalar misses;
+        /** Buffered lines dropped by writes or snoops. */
+        statistics::Scalar invalidations;
+    } fetchBufferStats;
+
     struct IprEvent : Event
     {
         Packet *pkt;
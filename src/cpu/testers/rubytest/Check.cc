@@ -110,7 +110,7 @@ Check::initiatePrefetch()
     }
 
     // Prefetches are assumed to be 0 sized
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::make(
             m_address, 0, flags, m_tester_ptr->requestorId());
     req->setPC(m_pc);
     req->setContext(index);
@@ -149,7 +149,7 @@ Check::initiateFlush()
 
     Request::Flags flags;
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::make(
             m_address, CHECK_SIZE, flags, m_tester_ptr->requestorId());
     req->setPC(m_pc);
 
@@ -183,7 +183,7 @@ Check::initiateAction()
     Addr writeAddr(m_address + m_store_count);
 
     // Stores are assumed to be 1 byte-sized
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::make(
         writeAddr, 1, flags, m_tester_ptr->requestorId());
     req->setPC(m_pc);
 
@@ -248,7 +248,7 @@ Check::initiateCheck()
     }
 
     // Checks are sized depending on the number of bytes written
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::make(
             m_address, CHECK_SIZE, flags, m_tester_ptr->requestorId());
     req->setPC(m_pc);
 
@@ -57,8 +57,8 @@ AMDGPUMemoryManager::writeRequest(Addr addr, uint8_t *data, int size,
 
     ChunkGenerator gen(addr, size, cacheLineSize);
     for (; !gen.done(); gen.next()) {
-        RequestPtr req = std::make_shared<Request>(gen.addr(), gen.size(),
-                                                   flag, _requestorId);
+        RequestPtr req = Request::make(gen.addr(), gen.size(),
+                                       flag, _requestorId);
 
         PacketPtr pkt = Packet::createWrite(req);
         uint8_t *dataPtr = new uint8_t[gen.size()];
@@ -81,7 +81,7 @@ SMMUProcess::doRead(Yield &yield, Addr addr, void *ptr, size_t size)
     SMMUAction a;
     a.type = ACTION_SEND_REQ;
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::make(
         addr, size, 0, smmu.requestorId);
 
     req->taskId(context_switch_task_id::DMA);
@@ -114,7 +114,7 @@ SMMUProcess::doWrite(Yield &yield, Addr addr, const void *ptr, size_t size)
     SMMUAction a;
     a.type = ACTION_SEND_REQ;
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::make(
         addr, size, 0, smmu.requestorId);
 
     req->taskId(context_switch_task_id::DMA);
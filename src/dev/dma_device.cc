@@ -113,7 +113,7 @@ DmaPort::handleResp(DmaReqState *state, Addr addr, Addr size, Tick delay)
 PacketPtr
 DmaPort::DmaReqState::createPacket()
 {
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::make(
             gen.addr(), gen.size(), flags, id);
     req->setStreamId(sid);
     req->setSubstreamId(ssid);
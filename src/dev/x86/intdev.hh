@@ -88,7 +88,7 @@ template<class T>
 PacketPtr
 buildIntPacket(Addr addr, T payload)
 {
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::make(
         addr, sizeof(T), Request::UNCACHEABLE, Request::intRequestorId);
     PacketPtr pkt = new Packet(req, MemCmd::WriteReq);
     pkt->allocate();
@@ -1267,7 +1267,7 @@ ComputeUnit::injectGlobalMemFence(GPUDynInstPtr gpuDynInst,
     // Fences will never be issued to system memory, so we can mark the
     // requestor as a device memory ID here.
     if (!req) {
-        req = std::make_shared<Request>(
+        req = Request::make(
             0, 0, 0, vramRequestorId(), 0, gpuDynInst->wfDynId);
     } else {
         req->requestorId(vramRequestorId());
@@ -1531,7 +1531,7 @@ ComputeUnit::DTLBPort::recvTimingResp(PacketPtr pkt)
             if (!stride)
                 break;
 
-            RequestPtr prefetch_req = std::make_shared<Request>(
+            RequestPtr prefetch_req = Request::make(
                 vaddr + stride * pf * X86ISA::PageBytes,
                 sizeof(uint8_t), 0,
                 computeUnit->requestorId(),
@@ -2070,7 +2070,7 @@ ComputeUnit::sendToLds(GPUDynInstPtr gpuDynInst)
 {
     // this is just a request to carry the GPUDynInstPtr
     // back and forth
-    RequestPtr newRequest = std::make_shared<Request>();
+    RequestPtr newRequest = Request::make();
     newRequest->setPaddr(0x0);
 
     // ReadReq is not evaluted by the LDS but the Packet ctor requires this
@@ -202,9 +202,9 @@ Shader::prepareInvalidate(HSAQueueEntry *task) {
     for (int i_cu = 0; i_cu < n_cu; ++i_cu) {
         // create a request to hold INV info; the request's fields will
         // be updated in cu before use
-        auto req = std::make_shared<Request>(0, 0, 0,
-                                             cuList[i_cu]->requestorId(),
-                                             0, -1);
+        auto req = Request::make(0, 0, 0,
+                                 cuList[i_cu]->requestorId(),
+                                 0, -1);
 
         _dispatcher.updateInvCounter(kernId, +1);
         // all necessary INV flags are all set now, call cu to execute
@@ -381,7 +381,7 @@ Shader::AccessMem(uint64_t address, void *ptr, uint32_t size, int cu_id,
     for (ChunkGenerator gen(address, size, cuList.at(cu_id)->cacheLineSize());
          !gen.done(); gen.next()) {
 
-        RequestPtr req = std::make_shared<Request>(
+        RequestPtr req = Request::make(
             gen.addr(), gen.size(), 0,
             cuList[0]->requestorId(), 0, 0, nullptr);
 
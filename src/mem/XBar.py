@@ -144,6 +144,21 @@ class SnoopFilter(SimObject):
     # Sanity check on max capacity to track, adjust if needed.
     max_capacity = Param.MemorySize('8MiB', "Maximum capacity of snoop filter")
 
+    # By default the filter tracks any number of lines, and max_capacity
+    # is only used as a sanity check. With a non-zero associativity the
+    # filter instead holds max_capacity worth of lines in a
+    # set-associative structure, as real hardware would, and evicting a
+    # line still cached above back-invalidates it in those caches.
+    assoc = Param.Unsigned(0, "Associativity of the filter storage, 0 for "
+                           "unbounded storage")
+
+    # A counting Bloom filter of the tracked lines, consulted before the
+    # storage so that lookups for lines not cached above are cheap. Use
+    # more than one bit per entry, as saturated entries are never
+    # cleared.
+    bloom_filter = Param.BloomFilterMultiBitSel(NULL,
+        "Counting Bloom filter of the tracked lines")
+
 # We use a coherent crossbar to connect multiple requestors to the L2
 # caches. Normally this crossbar would be part of the cache itself.
 class L2XBar(CoherentXBar):
@@ -38,7 +38,9 @@
 
 from m5.params import *
 from m5.proxy import *
+from m5.proxy import isproxy
 from m5.SimObject import SimObject
+from m5.util import fatal
 
 from m5.objects.ClockedObject import ClockedObject
 from m5.objects.Compressors import BaseCacheCompressor
@@ -106,6 +108,23 @@ class BaseCache(ClockedObject):
     replacement_policy = Param.BaseReplacementPolicy(LRURP(),
         "Replacement policy")
 
+    # Each shadow tag store must have its own replacement policy, as the
+    # default is to share the cache's, which is a fatal error, e.g.:
+    #   shadow_tags = [ BaseSetAssoc(size='2MB', assoc=8,
+    #                                replacement_policy=BRRIPRP()) ]
+    shadow_tags = VectorParam.BaseTags([], "Tag stores that see the same "
+        "accesses as this cache, without affecting it, to evaluate other "
+        "tag configurations in the same simulation")
+
+    # With set sampling in the tags, the accesses to the sets that are
+    # not modeled are forwarded as misses, so the latency, the MSHR use
+    # and the traffic below are those of a much smaller cache. Only a
+    # last level cache may sample sets, and only once its timing results
+    # are declared invalid here.
+    set_sampling_stats_only = Param.Bool(False, "Only the set sampling "
+        "stats of this cache are valid, not its timing nor the traffic "
+        "below it")
+
     compressor = Param.BaseCacheCompressor(NULL, "Cache compressor.")
     replace_expansions = Param.Bool(True, "Apply replacement policy to " \
         "decide which blocks should be evicted on a data expansion")
@@ -126,6 +145,32 @@ class BaseCache(ClockedObject):
 
     system = Param.System(Parent.any, "System we belong to")
 
+    def _hasCacheBelow(self):
+        """Whether the requests of this cache can reach another cache."""
+        seen = set()
+        refs = [self.mem_side]
+        while refs:
+            peer = refs.pop().peer
+            if peer is None or isproxy(peer):
+                continue
+            obj = peer.simobj
+            if id(obj) in seen:
+                continue
+            seen.add(id(obj))
+            if isinstance(obj, BaseCache):
+                return True
+            for ref in obj._port_refs.values():
+                elements = getattr(ref, 'elements', [ref])
+                refs.extend(el for el in elements if el.is_source)
+        return False
+
+    def unproxyParams(self):
+        super().unproxyParams()
+
+        if int(self.tags.set_sampling) > 1 and self._hasCacheBelow():
+            fatal("%s samples sets of its tags, but it is not the last "
+                  "level cache" % self.path())
+
     # Determine if this cache sends out writebacks for clean lines, or
     # simply clean evicts. In cases where a downstream cache is mostly
     # exclusive with respect to this cache (acting as a victim cache),
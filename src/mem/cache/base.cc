@@ -57,6 +57,7 @@
 #include "mem/cache/mshr.hh"
 #include "mem/cache/prefetch/base.hh"
 #include "mem/cache/queue_entry.hh"
+#include "mem/cache/replacement_policies/base.hh"
 #include "mem/cache/tags/compressed_tags.hh"
 #include "mem/cache/tags/super_blk.hh"
 #include "params/BaseCache.hh"
@@ -124,6 +125,28 @@ BaseCache::BaseCache(const BaseCacheParams &p, unsigned blk_size)
     tempBlock = new TempCacheBlk(blkSize);
 
     tags->tagsInit();
+    // The sets that are not modeled forward all their accesses, so
+    // only the sampling stats of such a cache mean anything
+    fatal_if(tags->getSetSampling() > 1 && !p.set_sampling_stats_only,
+             "%s samples sets of its tags, which is only supported with "
+             "set_sampling_stats_only", name());
+    warn_if(tags->getSetSampling() > 1, "%s models one in %u sets: its "
+            "timing and the traffic below it are invalid", name(),
+            tags->getSetSampling());
+    for (auto *shadow : p.shadow_tags) {
+        fatal_if(shadow == tags, "The shadow tags of %s can't be its tags",
+                 name());
+        // A shadow must neither update the cache's replacement state nor
+        // draw from the random numbers the rest of the system uses
+        auto *shadow_rp = shadow->getReplacementPolicy();
+        fatal_if(shadow_rp && shadow_rp == p.replacement_policy,
+                 "The shadow tags of %s need their own replacement policy",
+                 name());
+        if (shadow_rp)
+            shadow_rp->usePrivateRandom();
+        shadow->tagsInit();
+        shadowTags.emplace_back(new ShadowTags(shadow));
+    }
     if (prefetcher)
         prefetcher->setCache(this);
 
@@ -245,8 +268,8 @@ BaseCache::handleTimingReqHit(PacketPtr pkt, CacheBlk *blk, Tick request_time)
             // Basically we need to get the MSHR in the same state as if
             // we had missed and just received the response.
             // Request *req2 = new Request(*(pkt->req));
-            RequestPtr req2 = std::make_shared<Request>(*(pkt->req));
-            PacketPtr pkt2 = new Packet(req2, pkt->cmd);
+            RequestPtr req2 = Request::make(*(pkt->req));
+            PacketPtr pkt2 = Packet::make(req2, pkt->cmd);
             MSHR *mshr = allocateMissBuffer(pkt2, curTick(), true);
             // Mark the MSHR "in service" (even though it's not) to prevent
             // the cache from sending out a request.
@@ -270,7 +293,7 @@ BaseCache::handleTimingReqHit(PacketPtr pkt, CacheBlk *blk, Tick request_time)
             // LockedRMWRead, to process any pending targets and clear
             // out the MSHR
             PacketPtr resp_pkt =
-                new Packet(pkt->req, MemCmd::LockedRMWWriteResp);
+                Packet::make(pkt->req, MemCmd::LockedRMWWriteResp);
             resp_pkt->senderState = mshr;
             recvTimingResp(resp_pkt);
         }
@@ -726,6 +749,12 @@ BaseCache::functionalAccess(PacketPtr pkt, bool from_cpu_side)
     // needs to be found.  As a result we always update the request if
     // we have it, but only declare it satisfied if we are the owner.
 
+    // A functional write may update the block's data, which must not
+    // affect the blocks it is shared with
+    if (pkt->isWrite() && blk && blk->isValid()) {
+        tags->makeDataWritable(blk);
+    }
+
     // see if we have data at all (owned or otherwise)
     bool have_data = blk && blk->isValid()
         && pkt->trySatisfyFunctional(&cbpw, blk_addr, is_secure, blkSize,
@@ -779,7 +808,14 @@ BaseCache::updateBlockData(CacheBlk *blk, const PacketPtr cpkt,
 
     // Actually perform the data update
     if (cpkt) {
+        tags->makeDataWritable(blk);
         cpkt->writeDataToBlock(blk->data, blkSize);
+
+        // Only whole lines are worth looking up, as partial writes
+        // mostly leave the contents unique
+        if (cpkt->getSize() == blkSize) {
+            tags->deduplicateData(blk);
+        }
     }
 
     if (ppDataUpdate->hasListeners()) {
@@ -801,6 +837,7 @@ BaseCache::cmpAndSwap(CacheBlk *blk, PacketPtr pkt)
     uint64_t condition_val64;
     uint32_t condition_val32;
 
+    tags->makeDataWritable(blk);
     int offset = pkt->getOffset(blkSize);
     uint8_t *blk_data = blk->data + offset;
 
@@ -1112,6 +1149,7 @@ BaseCache::satisfyRequest(PacketPtr pkt, CacheBlk *blk, bool, bool)
 
             // extract data from cache and save it into the data field in
             // the packet as a return value from this atomic op
+            tags->makeDataWritable(blk);
             int offset = tags->extractBlkOffset(pkt->getAddr());
             uint8_t *blk_data = blk->data + offset;
             pkt->setData(blk_data);
@@ -1242,6 +1280,9 @@ BaseCache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
     DPRINTF(Cache, "%s for %s %s\n", __func__, pkt->print(),
             blk ? "hit " + blk->print() : "miss");
 
+    if (!shadowTags.empty())
+        accessShadowTags(pkt);
+
     if (pkt->req->isCacheMaintenance()) {
         // A cache maintenance operation is always forwarded to the
         // memory below even if the block is found in dirty state.
@@ -1601,6 +1642,48 @@ BaseCache::handleFill(PacketPtr pkt, CacheBlk *blk, PacketList &writebacks,
     return blk;
 }
 
+void
+BaseCache::accessShadowTags(const PacketPtr pkt)
+{
+    // Cache maintenance never allocates, and leaves the block as is
+    if (pkt->req->isCacheMaintenance())
+        return;
+
+    for (auto &shadow : shadowTags) {
+        BaseTags *shadow_tags = shadow->tags;
+        Cycles lat(0);
+        const bool hit = shadow_tags->accessBlock(pkt, lat);
+        if (!pkt->isEviction()) {
+            if (hit)
+                shadow->hits++;
+            else
+                shadow->misses++;
+            shadow_tags->sampleAccess(pkt->getAddr(), hit);
+        }
+
+        if (hit)
+            continue;
+
+        // A clean eviction brings no data, so there is nothing to fill
+        if (pkt->cmd == MemCmd::CleanEvict)
+            continue;
+
+        // Shadow tags don't model compression, so insert the block at
+        // its full size
+        std::vector<CacheBlk*> evict_blks;
+        CacheBlk *victim = shadow_tags->findVictim(pkt->getAddr(),
+            pkt->isSecure(), blkSize * 8, evict_blks);
+        if (!victim)
+            continue;
+
+        for (auto *evict_blk : evict_blks) {
+            if (evict_blk->isValid())
+                shadow_tags->invalidate(evict_blk);
+        }
+        shadow_tags->insertBlock(pkt, victim);
+    }
+}
+
 CacheBlk*
 BaseCache::allocateBlock(const PacketPtr pkt, PacketList &writebacks)
 {
@@ -1697,7 +1780,7 @@ BaseCache::writebackBlk(CacheBlk *blk)
 
     stats.writebacks[Request::wbRequestorId]++;
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::make(
         regenerateBlkAddr(blk), blkSize, 0, Request::wbRequestorId);
 
     if (blk->isSecure())
@@ -1706,8 +1789,8 @@ BaseCache::writebackBlk(CacheBlk *blk)
     req->taskId(blk->getTaskId());
 
     PacketPtr pkt =
-        new Packet(req, blk->isSet(CacheBlk::DirtyBit) ?
-                   MemCmd::WritebackDirty : MemCmd::WritebackClean);
+        Packet::make(req, blk->isSet(CacheBlk::DirtyBit) ?
+                     MemCmd::WritebackDirty : MemCmd::WritebackClean);
 
     DPRINTF(Cache, "Create Writeback %s writable: %d, dirty: %d\n",
         pkt->print(), blk->isSet(CacheBlk::WritableBit),
@@ -1740,7 +1823,7 @@ BaseCache::writebackBlk(CacheBlk *blk)
 PacketPtr
 BaseCache::writecleanBlk(CacheBlk *blk, Request::Flags dest, PacketId id)
 {
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::make(
         regenerateBlkAddr(blk), blkSize, 0, Request::wbRequestorId);
 
     if (blk->isSecure()) {
@@ -1748,7 +1831,7 @@ BaseCache::writecleanBlk(CacheBlk *blk, Request::Flags dest, PacketId id)
     }
     req->taskId(blk->getTaskId());
 
-    PacketPtr pkt = new Packet(req, MemCmd::WriteClean, blkSize, id);
+    PacketPtr pkt = Packet::make(req, MemCmd::WriteClean, blkSize, id);
 
     if (dest) {
         req->setFlags(dest);
@@ -1814,7 +1897,7 @@ BaseCache::writebackVisitor(CacheBlk &blk)
     if (blk.isSet(CacheBlk::DirtyBit)) {
         assert(blk.isValid());
 
-        RequestPtr request = std::make_shared<Request>(
+        RequestPtr request = Request::make(
             regenerateBlkAddr(&blk), blkSize, 0, Request::funcRequestorId);
 
         request->taskId(blk.getTaskId());
@@ -1907,7 +1990,7 @@ BaseCache::sendMSHRQueuePacket(MSHR* mshr)
         // not a cache block request, but a response is expected
         // make copy of current packet to forward, keep current
         // copy for response handling
-        pkt = new Packet(tgt_pkt, false, true);
+        pkt = Packet::make(tgt_pkt, false, true);
         assert(!pkt->isWrite());
     }
 
@@ -2194,6 +2277,20 @@ BaseCache::CacheCmdStats::regStatsFromParent()
     }
 }
 
+BaseCache::ShadowTags::ShadowTags(BaseTags *_tags)
+    : statistics::Group(_tags, "shadow"), tags(_tags),
+      ADD_STAT(hits, statistics::units::Count::get(),
+               "number of accesses that hit in these shadow tags"),
+      ADD_STAT(misses, statistics::units::Count::get(),
+               "number of accesses that missed in these shadow tags"),
+      ADD_STAT(accesses, statistics::units::Count::get(),
+               "number of accesses seen by these shadow tags",
+               hits + misses),
+      ADD_STAT(missRate, statistics::units::Ratio::get(),
+               "miss rate of these shadow tags", misses / accesses)
+{
+}
+
 BaseCache::CacheStats::CacheStats(BaseCache &c)
     : statistics::Group(&c), cache(c),
 
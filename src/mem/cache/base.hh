@@ -48,7 +48,9 @@
 
 #include <cassert>
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "base/addr_range.hh"
 #include "base/compiler.hh"
@@ -352,6 +354,30 @@ class BaseCache : public ClockedObject
     /** Compression method being used. */
     compression::Base* compressor;
 
+    /**
+     * A tag store that sees the same accesses as this cache's, but has
+     * no effect on its contents or timing. Its hit and miss counts are
+     * in the "shadow" group of the shadow tags' stats.
+     */
+    struct ShadowTags : public statistics::Group
+    {
+        ShadowTags(BaseTags *_tags);
+
+        BaseTags *const tags;
+
+        /** Number of accesses that hit in the shadow tags. */
+        statistics::Scalar hits;
+        /** Number of accesses that missed in the shadow tags. */
+        statistics::Scalar misses;
+        /** Number of accesses seen by the shadow tags. */
+        statistics::Formula accesses;
+        /** The miss rate of the shadow tags. */
+        statistics::Formula missRate;
+    };
+
+    /** Tag stores evaluated alongside the real one. */
+    std::vector<std::unique_ptr<ShadowTags>> shadowTags;
+
     /** Prefetcher */
     prefetch::Base *prefetcher;
 
@@ -480,6 +506,15 @@ class BaseCache : public ClockedObject
     Cycles calculateAccessLatency(const CacheBlk* blk, const uint32_t delay,
                                   const Cycles lookup_lat) const;
 
+    /**
+     * Look up a request in the shadow tags, and allocate it on a miss.
+     * Shadow tags only see the requests that reach access(), so they
+     * ignore prefetch fills and snoop invalidations.
+     *
+     * @param pkt The request, as seen by access().
+     */
+    void accessShadowTags(const PacketPtr pkt);
+
     /**
      * Does all the processing necessary to perform the provided request.
      * @param pkt The memory request to perform.
@@ -1297,6 +1332,7 @@ class BaseCache : public ClockedObject
     {
         assert(pkt->req->requestorId() < system->maxRequestors());
         stats.cmdStats(pkt).misses[pkt->req->requestorId()]++;
+        tags->sampleAccess(pkt->getAddr(), false);
         pkt->req->incAccessDepth();
         if (missCount) {
             --missCount;
@@ -1308,6 +1344,7 @@ class BaseCache : public ClockedObject
     {
         assert(pkt->req->requestorId() < system->maxRequestors());
         stats.cmdStats(pkt).hits[pkt->req->requestorId()]++;
+        tags->sampleAccess(pkt->getAddr(), true);
     }
 
     /**
@@ -378,7 +378,7 @@ Cache::handleTimingReqMiss(PacketPtr pkt, CacheBlk *blk, Tick forward_time,
 
         if (!mshr) {
             // copy the request and create a new SoftPFReq packet
-            RequestPtr req = std::make_shared<Request>(pkt->req->getPaddr(),
+            RequestPtr req = Request::make(pkt->req->getPaddr(),
                                                     pkt->req->getSize(),
                                                     pkt->req->getFlags(),
                                                     pkt->req->requestorId());
@@ -963,7 +963,7 @@ Cache::cleanEvictBlk(CacheBlk *blk)
     assert(blk && blk->isValid() && !blk->isSet(CacheBlk::DirtyBit));
 
     // Creating a zero sized write, a message to the snoop filter
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::make(
         regenerateBlkAddr(blk), blkSize, 0, Request::wbRequestorId);
 
     if (blk->isSecure())
@@ -1230,7 +1230,10 @@ Cache::handleSnoop(PacketPtr pkt, CacheBlk *blk, bool is_timing,
     }
 
     if (!respond && is_deferred) {
-        assert(pkt->needsResponse());
+        // back-invalidations are the only deferred snoops that do
+        // not expect a response
+        assert(pkt->needsResponse() ||
+               pkt->cmd == MemCmd::BackInvalidateReq);
         delete pkt;
     }
 
@@ -1342,7 +1345,13 @@ Cache::recvTimingSnoopReq(PacketPtr pkt)
                                    false, false);
         }
 
-        if (invalidate && wb_pkt->cmd != MemCmd::WriteClean) {
+        // A back-invalidation gets no response, the writeback is what
+        // carries the dirty data below
+        const bool keep_wb = wb_pkt->cmd == MemCmd::WriteClean ||
+            (wb_pkt->cmd == MemCmd::WritebackDirty &&
+             pkt->cmd == MemCmd::BackInvalidateReq);
+
+        if (invalidate && !keep_wb) {
             // Invalidation trumps our writeback... discard here
             // Note: markInService will remove entry from writeback buffer.
             markInService(wb_entry);
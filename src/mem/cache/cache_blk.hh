@@ -62,6 +62,8 @@
 namespace gem5
 {
 
+struct DedupLine;
+
 /**
  * A Basic Cache block.
  * Contains information regarding its coherence, prefetching status, as
@@ -102,6 +104,12 @@ class CacheBlk : public TaggedEntry
      */
     uint8_t *data = nullptr;
 
+    /**
+     * Line holding the data if the tags deduplicate it, nullptr if the
+     * data is all zeros. Managed by the tags.
+     */
+    DedupLine *dedupLine = nullptr;
+
     /**
      * Which curTick() will this block be accessible. Its value is only
      * meaningful if the block is valid.
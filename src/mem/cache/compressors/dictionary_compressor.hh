@@ -168,6 +168,22 @@ class DictionaryCompressor : public BaseDictionaryCompressor
                                                     match_location);
             }
         }
+
+        /**
+         * Get the size of the pattern getPattern() would return, without
+         * allocating it. The pattern is only built on the stack.
+         */
+        static std::size_t
+        getPatternSizeBits(const DictionaryEntry& bytes,
+            const DictionaryEntry& dict_bytes, const int match_location)
+        {
+            if (Head::isPattern(bytes, dict_bytes, match_location)) {
+                return Head(bytes, match_location).getSizeBits();
+            } else {
+                return Factory<Tail...>::getPatternSizeBits(bytes,
+                    dict_bytes, match_location);
+            }
+        }
     };
 
     /**
@@ -189,6 +205,13 @@ class DictionaryCompressor : public BaseDictionaryCompressor
         {
             return std::unique_ptr<Pattern>(new Head(bytes, match_location));
         }
+
+        static std::size_t
+        getPatternSizeBits(const DictionaryEntry& bytes,
+            const DictionaryEntry& dict_bytes, const int match_location)
+        {
+            return Head(bytes, match_location).getSizeBits();
+        }
     };
 
     /** The dictionary. */
@@ -203,6 +226,19 @@ class DictionaryCompressor : public BaseDictionaryCompressor
     getPattern(const DictionaryEntry& bytes, const DictionaryEntry& dict_bytes,
         const int match_location) const = 0;
 
+    /**
+     * Get the size of the pattern getPattern() would return. Used to
+     * compare candidate matches without allocating each of them, so
+     * sub-classes should forward it to their factory's
+     * getPatternSizeBits.
+     */
+    virtual std::size_t
+    getPatternSizeBits(const DictionaryEntry& bytes,
+        const DictionaryEntry& dict_bytes, const int match_location) const
+    {
+        return getPattern(bytes, dict_bytes, match_location)->getSizeBits();
+    }
+
     /**
      * Compress data.
      *
@@ -99,22 +99,30 @@ DictionaryCompressor<T>::compressValue(const T data)
     const DictionaryEntry bytes = toDictionaryEntry(data);
 
     // Start as a no-match pattern. A negative match location is used so that
-    // patterns that depend on the dictionary entry don't match
-    std::unique_ptr<Pattern> pattern =
-        getPattern(bytes, toDictionaryEntry(0), -1);
+    // patterns that depend on the dictionary entry don't match. Only the
+    // sizes of the candidates are needed to pick the best one, so the
+    // pattern itself is only instantiated for the winner
+    int best_location = -1;
+    std::size_t best_size_bits =
+        getPatternSizeBits(bytes, toDictionaryEntry(0), -1);
 
     // Search for word on dictionary
     for (std::size_t i = 0; i < numEntries; i++) {
         // Try matching input with possible patterns
-        std::unique_ptr<Pattern> temp_pattern =
-            getPattern(bytes, dictionary[i], i);
+        const std::size_t size_bits =
+            getPatternSizeBits(bytes, dictionary[i], i);
 
         // Check if found pattern is better than previous
-        if (temp_pattern->getSizeBits() < pattern->getSizeBits()) {
-            pattern = std::move(temp_pattern);
+        if (size_bits < best_size_bits) {
+            best_location = i;
+            best_size_bits = size_bits;
         }
     }
 
+    std::unique_ptr<Pattern> pattern = (best_location < 0) ?
+        getPattern(bytes, toDictionaryEntry(0), -1) :
+        getPattern(bytes, dictionary[best_location], best_location);
+
     // Update stats
     dictionaryStats.patterns[pattern->getPatternNumber()]++;
 
@@ -138,6 +146,7 @@ DictionaryCompressor<T>::compress(const std::vector<Chunk>& chunks)
 
     // Compress every value sequentially
     CompData* const comp_data_ptr = static_cast<CompData*>(comp_data.get());
+    comp_data_ptr->entries.reserve(chunks.size());
     for (const auto& value : chunks) {
         std::unique_ptr<Pattern> pattern = compressValue(value);
         DPRINTF(CacheComp, "Compressed %016x to %s\n", value,
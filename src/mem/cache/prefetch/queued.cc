@@ -61,7 +61,7 @@ Queued::DeferredPacket::createPkt(Addr paddr, unsigned blk_size,
                                             bool tag_prefetch,
                                             Tick t) {
     /* Create a prefetch memory request */
-    RequestPtr req = std::make_shared<Request>(paddr, blk_size,
+    RequestPtr req = Request::make(paddr, blk_size,
                                                 0, requestor_id);
 
     if (pfInfo.isSecure()) {
@@ -98,8 +98,181 @@ Queued::DeferredPacket::finish(const Fault &fault,
     owner->translationComplete(this, failed);
 }
 
+Queued::DeferredQueue::DeferredQueue(const std::string &_name,
+                                     unsigned capacity)
+    : slots(capacity), head(None), tail(None), count(0), name(_name)
+{
+    freeSlots.reserve(capacity);
+    for (unsigned slot = capacity; slot > 0; --slot)
+        freeSlots.push_back(slot - 1);
+
+    // create all the index nodes up front
+    index.reserve(capacity);
+    spareIndexNodes.reserve(capacity);
+    for (unsigned slot = 0; slot < capacity; ++slot)
+        spareIndexNodes.push_back(index.extract(index.emplace(slot, slot)));
+}
+
+int
+Queued::DeferredQueue::slotOf(const DeferredPacket &dp) const
+{
+    return static_cast<const Entry &>(dp).indexIt->second;
+}
+
+void
+Queued::DeferredQueue::link(int slot, int before)
+{
+    Entry &e = entry(slot);
+    e.next = before;
+    e.prev = before == None ? tail : entry(before).prev;
+    if (e.prev == None)
+        head = slot;
+    else
+        entry(e.prev).next = slot;
+    if (before == None)
+        tail = slot;
+    else
+        entry(before).prev = slot;
+}
+
+void
+Queued::DeferredQueue::unlink(int slot)
+{
+    Entry &e = entry(slot);
+    if (e.prev == None)
+        head = e.next;
+    else
+        entry(e.prev).next = e.next;
+    if (e.next == None)
+        tail = e.prev;
+    else
+        entry(e.next).prev = e.prev;
+}
+
+void
+Queued::DeferredQueue::swap(int slot, int ahead)
+{
+    const int after = entry(slot).next;
+    const int ahead_next = entry(ahead).next;
+    if (ahead_next == slot) {
+        unlink(slot);
+        link(slot, ahead);
+    } else {
+        unlink(ahead);
+        unlink(slot);
+        link(slot, ahead_next);
+        link(ahead, after);
+    }
+}
+
+Queued::DeferredPacket &
+Queued::DeferredQueue::oldestLowest()
+{
+    assert(!empty());
+    int slot = tail;
+    while (entry(slot).prev != None &&
+           entry(entry(slot).prev).priority == entry(tail).priority) {
+        slot = entry(slot).prev;
+    }
+    return entry(slot);
+}
+
+Queued::DeferredPacket &
+Queued::DeferredQueue::insert(const DeferredPacket &dp)
+{
+    assert(!freeSlots.empty());
+    const int slot = freeSlots.back();
+    freeSlots.pop_back();
+    Entry &e = slots[slot].emplace(dp);
+
+    Index::node_type index_node = std::move(spareIndexNodes.back());
+    spareIndexNodes.pop_back();
+    index_node.key() = dp.pfInfo.getAddr();
+    index_node.mapped() = slot;
+    e.indexIt = index.insert(std::move(index_node));
+
+    if (empty() || dp <= entry(tail)) {
+        link(slot, None);
+    } else {
+        int pos = tail;
+        while (pos != head && dp > entry(pos))
+            pos = entry(pos).prev;
+        /* If we reach the head, we have to see if the new element is new
+         * head or not */
+        if (pos == head && dp <= entry(pos))
+            pos = entry(pos).next;
+        link(slot, pos);
+    }
+    count++;
+
+    return e;
+}
+
+void
+Queued::DeferredQueue::erase(DeferredPacket &dp)
+{
+    const int slot = slotOf(dp);
+    assert(&*slots[slot] == &dp);
+
+    unlink(slot);
+    spareIndexNodes.push_back(index.extract(entry(slot).indexIt));
+    slots[slot].reset();
+    freeSlots.push_back(slot);
+    count--;
+}
+
+Queued::DeferredPacket *
+Queued::DeferredQueue::find(Addr addr, bool is_secure)
+{
+    int found = None;
+    const auto range = index.equal_range(addr);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (entry(it->second).pfInfo.isSecure() != is_secure)
+            continue;
+        if (found != None) {
+            // Several packets for the address, which happens when
+            // translations complete, so look for the first one
+            for (int slot = head; slot != None; slot = entry(slot).next) {
+                const Entry &e = entry(slot);
+                if (e.pfInfo.getAddr() == addr &&
+                    e.pfInfo.isSecure() == is_secure) {
+                    return &entry(slot);
+                }
+            }
+        }
+        found = it->second;
+    }
+    return found == None ? nullptr : &entry(found);
+}
+
+Queued::DeferredPacket *
+Queued::DeferredQueue::next(DeferredPacket &dp)
+{
+    const int slot = entry(slotOf(dp)).next;
+    return slot == None ? nullptr : &entry(slot);
+}
+
+void
+Queued::DeferredQueue::setPriority(DeferredPacket &dp, int32_t priority)
+{
+    const int slot = slotOf(dp);
+    dp.priority = priority;
+
+    int pos = slot;
+    while (pos != head) {
+        pos = entry(pos).prev;
+        /* If the packet has higher priority, swap */
+        if (dp > entry(pos)) {
+            swap(slot, pos);
+            pos = slot;
+        }
+    }
+}
+
 Queued::Queued(const QueuedPrefetcherParams &p)
-    : Base(p), queueSize(p.queue_size),
+    : Base(p), pfq("PFQ", p.queue_size),
+      pfqMissingTranslation("PFTransQ", p.queue_size),
+      queueSize(p.queue_size),
       missingTranslationQueueSize(
         p.max_prefetch_requests_with_pending_translation),
       latency(p.latency), queueSquash(p.queue_squash),
@@ -112,31 +285,24 @@ Queued::Queued(const QueuedPrefetcherParams &p)
 Queued::~Queued()
 {
     // Delete the queued prefetch packets
-    for (DeferredPacket &p : pfq) {
+    pfq.forEach([](DeferredPacket &p) {
         delete p.pkt;
-    }
+        return true;
+    });
 }
 
 void
-Queued::printQueue(const std::list<DeferredPacket> &queue) const
+Queued::printQueue(const DeferredQueue &queue) const
 {
     int pos = 0;
-    std::string queue_name = "";
-    if (&queue == &pfq) {
-        queue_name = "PFQ";
-    } else {
-        assert(&queue == &pfqMissingTranslation);
-        queue_name = "PFTransQ";
-    }
-
-    for (const_iterator it = queue.cbegin(); it != queue.cend();
-                                                            it++, pos++) {
-        Addr vaddr = it->pfInfo.getAddr();
+    queue.forEach([this, &queue, &pos](const DeferredPacket &dp) {
+        Addr vaddr = dp.pfInfo.getAddr();
         /* Set paddr to 0 if not yet translated */
-        Addr paddr = it->pkt ? it->pkt->getAddr() : 0;
+        Addr paddr = dp.pkt ? dp.pkt->getAddr() : 0;
         DPRINTF(HWPrefetchQueue, "%s[%d]: Prefetch Req VA: %#x PA: %#x "
-                "prio: %3d\n", queue_name, pos, vaddr, paddr, it->priority);
-    }
+                "prio: %3d\n", queue.name, pos++, vaddr, paddr, dp.priority);
+        return true;
+    });
 }
 
 size_t
@@ -177,20 +343,14 @@ Queued::notify(const PacketPtr &pkt, const PrefetchInfo &pfi)
 
     // Squash queued prefetches if demand miss to same line
     if (queueSquash) {
-        auto itr = pfq.begin();
-        while (itr != pfq.end()) {
-            if (itr->pfInfo.getAddr() == blk_addr &&
-                itr->pfInfo.isSecure() == is_secure) {
-                DPRINTF(HWPrefetch, "Removing pf candidate addr: %#x "
-                        "(cl: %#x), demand request going to the same addr\n",
-                        itr->pfInfo.getAddr(),
-                        blockAddress(itr->pfInfo.getAddr()));
-                delete itr->pkt;
-                itr = pfq.erase(itr);
-                statsQueued.pfRemovedDemand++;
-            } else {
-                ++itr;
-            }
+        while (DeferredPacket *dp = pfq.find(blk_addr, is_secure)) {
+            DPRINTF(HWPrefetch, "Removing pf candidate addr: %#x "
+                    "(cl: %#x), demand request going to the same addr\n",
+                    dp->pfInfo.getAddr(),
+                    blockAddress(dp->pfInfo.getAddr()));
+            delete dp->pkt;
+            pfq.erase(*dp);
+            statsQueued.pfRemovedDemand++;
         }
     }
 
@@ -251,7 +411,7 @@ Queued::getPacket()
     }
 
     PacketPtr pkt = pfq.front().pkt;
-    pfq.pop_front();
+    pfq.erase(pfq.front());
 
     prefetchStats.pfIssued++;
     issuedPrefetches += 1;
@@ -287,79 +447,64 @@ void
 Queued::processMissingTranslations(unsigned max)
 {
     unsigned count = 0;
-    iterator it = pfqMissingTranslation.begin();
-    while (it != pfqMissingTranslation.end() && count < max) {
-        DeferredPacket &dp = *it;
-        // Increase the iterator first because dp.startTranslation can end up
-        // calling finishTranslation, which will erase "it"
-        it++;
+    // dp.startTranslation can end up calling finishTranslation, which
+    // will erase dp from the queue
+    pfqMissingTranslation.forEach([this, max, &count](DeferredPacket &dp) {
+        if (count == max)
+            return false;
         dp.startTranslation(tlb);
         count += 1;
-    }
+        return true;
+    });
 }
 
 void
 Queued::translationComplete(DeferredPacket *dp, bool failed)
 {
-    auto it = pfqMissingTranslation.begin();
-    while (it != pfqMissingTranslation.end()) {
-        if (&(*it) == dp) {
-            break;
-        }
-        it++;
-    }
-    assert(it != pfqMissingTranslation.end());
     if (!failed) {
         DPRINTF(HWPrefetch, "%s Translation of vaddr %#x succeeded: "
                 "paddr %#x \n", tlb->name(),
-                it->translationRequest->getVaddr(),
-                it->translationRequest->getPaddr());
-        Addr target_paddr = it->translationRequest->getPaddr();
+                dp->translationRequest->getVaddr(),
+                dp->translationRequest->getPaddr());
+        Addr target_paddr = dp->translationRequest->getPaddr();
         // check if this prefetch is already redundant
-        if (cacheSnoop && (inCache(target_paddr, it->pfInfo.isSecure()) ||
-                    inMissQueue(target_paddr, it->pfInfo.isSecure()))) {
+        if (cacheSnoop && (inCache(target_paddr, dp->pfInfo.isSecure()) ||
+                    inMissQueue(target_paddr, dp->pfInfo.isSecure()))) {
             statsQueued.pfInCache++;
             DPRINTF(HWPrefetch, "Dropping redundant in "
                     "cache/MSHR prefetch addr:%#x\n", target_paddr);
         } else {
             Tick pf_time = curTick() + clockPeriod() * latency;
-            it->createPkt(target_paddr, blkSize, requestorId, tagPrefetch,
+            dp->createPkt(target_paddr, blkSize, requestorId, tagPrefetch,
                           pf_time);
-            addToQueue(pfq, *it);
+            addToQueue(pfq, *dp);
         }
     } else {
         DPRINTF(HWPrefetch, "%s Translation of vaddr %#x failed, dropping "
                 "prefetch request %#x \n", tlb->name(),
-                it->translationRequest->getVaddr());
+                dp->translationRequest->getVaddr());
     }
-    pfqMissingTranslation.erase(it);
+    pfqMissingTranslation.erase(*dp);
 }
 
 bool
-Queued::alreadyInQueue(std::list<DeferredPacket> &queue,
-                                 const PrefetchInfo &pfi, int32_t priority)
+Queued::alreadyInQueue(DeferredQueue &queue, const PrefetchInfo &pfi,
+                       int32_t priority)
 {
-    bool found = false;
-    iterator it;
-    for (it = queue.begin(); it != queue.end() && !found; it++) {
-        found = it->pfInfo.sameAddr(pfi);
-    }
+    DeferredPacket *match = queue.find(pfi.getAddr(), pfi.isSecure());
+    if (!match)
+        return false;
+
+    /* As with the list this queue replaces, the search stops one packet
+     * past the match, and the update below applies to that packet */
+    DeferredPacket *dp = queue.next(*match);
 
     /* If the address is already in the queue, update priority and leave */
-    if (it != queue.end()) {
+    if (dp) {
         statsQueued.pfBufferHit++;
-        if (it->priority < priority) {
+        if (dp->priority < priority) {
             /* Update priority value and position in the queue */
-            it->priority = priority;
-            iterator prev = it;
-            while (prev != queue.begin()) {
-                prev--;
-                /* If the packet has higher priority, swap */
-                if (*it > *prev) {
-                    std::swap(*it, *prev);
-                    it = prev;
-                }
-            }
+            queue.setPriority(*dp, priority);
             DPRINTF(HWPrefetch, "Prefetch addr already in "
                 "prefetch queue, priority updated\n");
         } else {
@@ -367,14 +512,14 @@ Queued::alreadyInQueue(std::list<DeferredPacket> &queue,
                 "prefetch queue\n");
         }
     }
-    return found;
+    return true;
 }
 
 RequestPtr
 Queued::createPrefetchRequest(Addr addr, PrefetchInfo const &pfi,
                                         PacketPtr pkt)
 {
-    RequestPtr translation_req = std::make_shared<Request>(
+    RequestPtr translation_req = Request::make(
             addr, blkSize, pkt->req->getFlags(), requestorId, pfi.getPC(),
             pkt->req->contextId());
     translation_req->setFlags(Request::PREFETCH);
@@ -481,50 +626,23 @@ Queued::insert(const PacketPtr &pkt, PrefetchInfo &new_pfi,
 }
 
 void
-Queued::addToQueue(std::list<DeferredPacket> &queue,
-                             DeferredPacket &dpp)
+Queued::addToQueue(DeferredQueue &queue, DeferredPacket &dpp)
 {
     /* Verify prefetch buffer space for request */
     if (queue.size() == queueSize) {
         statsQueued.pfRemovedFull++;
-        /* Lowest priority packet */
-        iterator it = queue.end();
-        panic_if (it == queue.begin(),
-            "Prefetch queue is both full and empty!");
-        --it;
-        /* Look for oldest in that level of priority */
-        panic_if (it == queue.begin(),
+        panic_if(queue.size() == 1,
             "Prefetch queue is full with 1 element!");
-        iterator prev = it;
-        bool cont = true;
-        /* While not at the head of the queue */
-        while (cont && prev != queue.begin()) {
-            prev--;
-            /* While at the same level of priority */
-            cont = prev->priority == it->priority;
-            if (cont)
-                /* update pointer */
-                it = prev;
-        }
+        /* Look for oldest in the lowest level of priority */
+        DeferredPacket &victim = queue.oldestLowest();
         DPRINTF(HWPrefetch, "Prefetch queue full, removing lowest priority "
-                            "oldest packet, addr: %#x\n",it->pfInfo.getAddr());
-        delete it->pkt;
-        queue.erase(it);
+                            "oldest packet, addr: %#x\n",
+                            victim.pfInfo.getAddr());
+        delete victim.pkt;
+        queue.erase(victim);
     }
 
-    if ((queue.size() == 0) || (dpp <= queue.back())) {
-        queue.emplace_back(dpp);
-    } else {
-        iterator it = queue.end();
-        do {
-            --it;
-        } while (it != queue.begin() && dpp > *it);
-        /* If we reach the head, we have to see if the new element is new head
-         * or not */
-        if (it == queue.begin() && dpp <= *it)
-            it++;
-        queue.insert(it, dpp);
-    }
+    queue.insert(dpp);
 
     if (debug::HWPrefetchQueue)
         printQueue(queue);
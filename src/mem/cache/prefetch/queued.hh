@@ -39,8 +39,11 @@
 #define __MEM_CACHE_PREFETCH_QUEUED_HH__
 
 #include <cstdint>
-#include <list>
+#include <optional>
+#include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "arch/generic/mmu.hh"
 #include "base/statistics.hh"
@@ -140,11 +143,143 @@ class Queued : public Base
         void startTranslation(BaseTLB *tlb);
     };
 
-    std::list<DeferredPacket> pfq;
-    std::list<DeferredPacket> pfqMissingTranslation;
+    /**
+     * A bounded queue of deferred packets, ordered by decreasing priority.
+     * Packets are placed, evicted and moved on a priority update exactly
+     * as they were in the list this queue replaces, so the prefetches
+     * issued do not change.
+     *
+     * The packets live in a fixed pool so that they do not move while
+     * being translated. They are linked in queue order through their
+     * pool entries, and indexed by address to find the ones matching a
+     * prefetch. The index nodes are recycled, so the queue does not
+     * allocate memory once built.
+     */
+    class DeferredQueue
+    {
+      private:
+        using Index = std::unordered_multimap<Addr, unsigned>;
+
+        /** No pool entry, for the ends of the queue. */
+        static constexpr int None = -1;
+
+        struct Entry : public DeferredPacket
+        {
+            Entry(const DeferredPacket &dp) : DeferredPacket(dp) {}
+
+            /** Pool entries of the neighbours in the queue. */
+            int prev = None;
+            int next = None;
+            Index::iterator indexIt;
+        };
+
+        std::vector<std::optional<Entry>> slots;
+        std::vector<unsigned> freeSlots;
+
+        /** Pool entries of the first and last packets. */
+        int head;
+        int tail;
+        size_t count;
+
+        Index index;
+        /** Nodes of the index not in use. */
+        std::vector<Index::node_type> spareIndexNodes;
+
+        Entry &entry(int slot) { return *slots[slot]; }
+        const Entry &entry(int slot) const { return *slots[slot]; }
+        int slotOf(const DeferredPacket &dp) const;
+
+        /** Link a packet in front of another, or last for None. */
+        void link(int slot, int before);
+        void unlink(int slot);
+        /** Exchange the positions of a packet and one ahead of it. */
+        void swap(int slot, int ahead);
+
+      public:
+        /** Name of the queue, for debugging. */
+        const std::string name;
+
+        /**
+         * @param name Name of the queue, for debugging.
+         * @param capacity Maximum number of packets in the queue.
+         */
+        DeferredQueue(const std::string &name, unsigned capacity);
+
+        bool empty() const { return count == 0; }
+        size_t size() const { return count; }
+
+        /** The packet at the head of the queue. */
+        DeferredPacket &front() { return entry(head); }
+        const DeferredPacket &front() const { return entry(head); }
+
+        /**
+         * The oldest packet with the lowest priority, i.e., the first
+         * packet of the run at the tail that shares the priority of the
+         * last packet.
+         */
+        DeferredPacket &oldestLowest();
+
+        /**
+         * Add a copy of a packet. It goes before the packets of lower
+         * priority, as placed by a scan from the tail of the queue. The
+         * queue must not be full.
+         *
+         * @return The packet in the queue.
+         */
+        DeferredPacket &insert(const DeferredPacket &dp);
+
+        /** Remove a packet from the queue. */
+        void erase(DeferredPacket &dp);
+
+        /**
+         * Find the first packet in queue order for the given prefetch
+         * address.
+         *
+         * @return The packet, nullptr if there is none.
+         */
+        DeferredPacket *find(Addr addr, bool is_secure);
+
+        /** The packet after another one, nullptr if it is the last. */
+        DeferredPacket *next(DeferredPacket &dp);
+
+        /**
+         * Raise the priority of a packet. It then moves towards the head,
+         * exchanging places with each packet ahead of its position that
+         * has a lower priority.
+         */
+        void setPriority(DeferredPacket &dp, int32_t priority);
+
+        /**
+         * Visit the packets in order until the visitor returns false.
+         * The visitor may erase the packet it is given.
+         */
+        template <typename Visitor>
+        void
+        forEach(Visitor visitor)
+        {
+            for (int slot = head; slot != None;) {
+                DeferredPacket &dp = entry(slot);
+                slot = entry(slot).next;
+                if (!visitor(dp))
+                    break;
+            }
+        }
+
+        template <typename Visitor>
+        void
+        forEach(Visitor visitor) const
+        {
+            for (int slot = head; slot != None; slot = entry(slot).next) {
+                if (!visitor(static_cast<const DeferredPacket &>(
+                                entry(slot)))) {
+                    break;
+                }
+            }
+        }
+    };
 
-    using const_iterator = std::list<DeferredPacket>::const_iterator;
-    using iterator = std::list<DeferredPacket>::iterator;
+    DeferredQueue pfq;
+    DeferredQueue pfqMissingTranslation;
 
     // PARAMETERS
 
@@ -206,7 +341,7 @@ class Queued : public Base
         return pfq.empty() ? MaxTick : pfq.front().tick;
     }
 
-    void printQueue(const std::list<DeferredPacket> &queue) const;
+    void printQueue(const DeferredQueue &queue) const;
 
   private:
 
@@ -215,7 +350,7 @@ class Queued : public Base
      * @param queue selected queue to use
      * @param dpp DeferredPacket to add
      */
-    void addToQueue(std::list<DeferredPacket> &queue, DeferredPacket &dpp);
+    void addToQueue(DeferredQueue &queue, DeferredPacket &dpp);
 
     /**
      * Starts the translations of the queued prefetches with a
@@ -243,8 +378,8 @@ class Queued : public Base
      * @param priority priority of the prefetch request to be added
      * @return True if the prefetch request was found in the queue
      */
-    bool alreadyInQueue(std::list<DeferredPacket> &queue,
-                        const PrefetchInfo &pfi, int32_t priority);
+    bool alreadyInQueue(DeferredQueue &queue, const PrefetchInfo &pfi,
+                        int32_t priority);
 
     /**
      * Returns the maxmimum number of prefetch requests that are allowed
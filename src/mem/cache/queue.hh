@@ -48,6 +48,7 @@
 #include <cassert>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 
 #include "base/logging.hh"
 #include "base/named.hh"
@@ -101,6 +102,18 @@ class Queue : public Drainable, public Named
     /** Holds non allocated entries. */
     typename Entry::List freeList;
 
+    /**
+     * Allocated entries indexed by block address, so that lookups only
+     * visit the entries for the address rather than all of them.
+     */
+    std::unordered_multimap<Addr, Entry*> addrIndex;
+
+    typename Entry::Iterator addToAllocatedList(Entry* entry)
+    {
+        addrIndex.emplace(entry->blkAddr, entry);
+        return allocatedList.insert(allocatedList.end(), entry);
+    }
+
     typename Entry::Iterator addToReadyList(Entry* entry)
     {
         if (readyList.empty() ||
@@ -116,6 +129,42 @@ class Queue : public Drainable, public Named
         panic("Failed to add to ready list.");
     }
 
+    /**
+     * Find the first allocated entry that matches the provided
+     * address, searching all of them.
+     */
+    Entry* findFirstMatch(Addr blk_addr, bool is_secure,
+                          bool ignore_uncacheable) const
+    {
+        for (const auto& entry : allocatedList) {
+            // we ignore any entries allocated for uncacheable
+            // accesses and simply ignore them when matching, in the
+            // cache we never check for matches when adding new
+            // uncacheable entries, and we do not want normal
+            // cacheable accesses being added to an WriteQueueEntry
+            // serving an uncacheable access
+            if (!(ignore_uncacheable && entry->isUncacheable()) &&
+                entry->matchBlockAddr(blk_addr, is_secure)) {
+                return entry;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Find the earliest ready entry that overlaps the given entry,
+     * searching all of them.
+     */
+    Entry* findFirstPending(const QueueEntry* entry) const
+    {
+        for (const auto& ready_entry : readyList) {
+            if (ready_entry->conflictAddr(entry)) {
+                return ready_entry;
+            }
+        }
+        return nullptr;
+    }
+
     /** The number of entries that are in service. */
     int _numInService;
 
@@ -140,6 +189,7 @@ class Queue : public Drainable, public Named
         for (int i = 0; i < numEntries; ++i) {
             freeList.push_back(&entries[i]);
         }
+        addrIndex.reserve(numEntries);
     }
 
     bool isEmpty() const
@@ -168,19 +218,22 @@ class Queue : public Drainable, public Named
     Entry* findMatch(Addr blk_addr, bool is_secure,
                      bool ignore_uncacheable = true) const
     {
-        for (const auto& entry : allocatedList) {
-            // we ignore any entries allocated for uncacheable
-            // accesses and simply ignore them when matching, in the
-            // cache we never check for matches when adding new
-            // uncacheable entries, and we do not want normal
-            // cacheable accesses being added to an WriteQueueEntry
-            // serving an uncacheable access
+        Entry *match = nullptr;
+        const auto range = addrIndex.equal_range(blk_addr);
+        for (auto i = range.first; i != range.second; ++i) {
+            Entry *entry = i->second;
             if (!(ignore_uncacheable && entry->isUncacheable()) &&
                 entry->matchBlockAddr(blk_addr, is_secure)) {
-                return entry;
+                // the index does not keep the allocation order, so
+                // search the allocated list for the first of several
+                // matches
+                if (match)
+                    return findFirstMatch(blk_addr, is_secure,
+                                          ignore_uncacheable);
+                match = entry;
             }
         }
-        return nullptr;
+        return match;
     }
 
     bool trySatisfyFunctional(PacketPtr pkt)
@@ -206,12 +259,21 @@ class Queue : public Drainable, public Named
      */
     Entry* findPending(const QueueEntry* entry) const
     {
-        for (const auto& ready_entry : readyList) {
-            if (ready_entry->conflictAddr(entry)) {
-                return ready_entry;
+        // the entries that are not in service are the ones on the
+        // ready list
+        Entry *pending = nullptr;
+        const auto range = addrIndex.equal_range(entry->blkAddr);
+        for (auto i = range.first; i != range.second; ++i) {
+            Entry *ready_entry = i->second;
+            if (!ready_entry->inService && ready_entry->conflictAddr(entry)) {
+                // search the ready list for the earliest of several
+                // matches
+                if (pending)
+                    return findFirstPending(entry);
+                pending = ready_entry;
             }
         }
-        return nullptr;
+        return pending;
     }
 
     /**
@@ -240,6 +302,13 @@ class Queue : public Drainable, public Named
     virtual void
     deallocate(Entry *entry)
     {
+        const auto range = addrIndex.equal_range(entry->blkAddr);
+        for (auto i = range.first; i != range.second; ++i) {
+            if (i->second == entry) {
+                addrIndex.erase(i);
+                break;
+            }
+        }
         allocatedList.erase(entry->allocIter);
         freeList.push_front(entry);
         allocated--;
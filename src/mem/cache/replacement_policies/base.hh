@@ -29,9 +29,12 @@
 #ifndef __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
 #define __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
 
+#include <functional>
 #include <memory>
+#include <string>
 
 #include "base/compiler.hh"
+#include "base/random.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/packet.hh"
 #include "params/BaseReplacementPolicy.hh"
@@ -54,11 +57,31 @@ namespace replacement_policy
  */
 class Base : public SimObject
 {
+  protected:
+    /** Generator used by the policies that make random decisions. */
+    gem5::Random *rng;
+
+    /** Generator owned by this policy, if it doesn't use random_mt. */
+    std::unique_ptr<gem5::Random> privateRng;
+
   public:
     typedef BaseReplacementPolicyParams Params;
-    Base(const Params &p) : SimObject(p) {}
+    Base(const Params &p) : SimObject(p), rng(&random_mt) {}
     virtual ~Base() = default;
 
+    /**
+     * Make the random decisions of this policy come from a generator of
+     * its own, seeded from its name, instead of random_mt. A policy that
+     * must not perturb the rest of the simulation (e.g., one of a
+     * shadow tag store) uses this.
+     */
+    virtual void
+    usePrivateRandom()
+    {
+        privateRng.reset(new gem5::Random(std::hash<std::string>()(name())));
+        rng = privateRng.get();
+    }
+
     /**
      * Invalidate replacement data to set it as the next probable victim.
      *
@@ -47,6 +47,14 @@ Dueling::Dueling(const Params &p)
         "All replacement policies must be instantiated");
 }
 
+void
+Dueling::usePrivateRandom()
+{
+    Base::usePrivateRandom();
+    replPolicyA->usePrivateRandom();
+    replPolicyB->usePrivateRandom();
+}
+
 void
 Dueling::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 {
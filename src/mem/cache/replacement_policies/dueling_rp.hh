@@ -98,6 +98,7 @@ class Dueling : public Base
     Dueling(const Params &p);
     ~Dueling() = default;
 
+    void usePrivateRandom() override;
     void invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
                                                                     override;
     void touch(const std::shared_ptr<ReplacementData>& replacement_data,
@@ -72,6 +72,23 @@ class BaseTags(ClockedObject):
     entry_size = Param.Int(Parent.cache_line_size,
                            "Indexing entry size in bytes")
 
+    # Set sampling: only one in this many sets is modeled, and the
+    # outcome of the accesses to the others is predicted from them. The
+    # other sets never allocate, so the cache forwards their accesses as
+    # misses, and the sampling stats estimate the hits and misses of the
+    # whole cache. Since the timing of such a cache is that of a cache
+    # with fewer sets, only a last level cache with
+    # set_sampling_stats_only may use it. Only set associative tags
+    # support it.
+    set_sampling = Param.Unsigned(1, "Model only one in this many sets")
+
+    # Deduplicate the data of the blocks, so that the host memory used
+    # depends on the distinct data held rather than on the cache size.
+    # Blocks holding zeros use no memory at all. Only set associative
+    # tags support it.
+    dedup_data = Param.Bool(False, "Share the data of blocks with the "
+                            "same contents")
+
 class BaseSetAssoc(BaseTags):
     type = 'BaseSetAssoc'
     cxx_header = "mem/cache/tags/base_set_assoc.hh"
@@ -45,8 +45,11 @@
 
 #include "mem/cache/tags/base.hh"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 
+#include "base/intmath.hh"
 #include "base/types.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/indexing_policies/base.hh"
@@ -62,11 +65,22 @@ BaseTags::BaseTags(const Params &p)
     : ClockedObject(p), blkSize(p.block_size), blkMask(blkSize - 1),
       size(p.size), lookupLatency(p.tag_latency),
       system(p.system), indexingPolicy(p.indexing_policy),
-      warmupBound((p.warmup_percentage/100.0) * (p.size / p.block_size)),
-      warmedUp(false), numBlocks(p.size / p.block_size),
-      dataBlks(new uint8_t[p.size]), // Allocate data storage in one big chunk
+      warmupBound((p.warmup_percentage/100.0) *
+                  (p.size / p.block_size / p.set_sampling)),
+      warmedUp(false), setSampling(p.set_sampling), unsampledMask(0),
+      numSampledSets(0), numBlocks(p.size / p.block_size / setSampling),
+      // Allocate data storage in one big chunk, unless it is allocated
+      // line by line as the blocks are written
+      dataBlks(p.dedup_data ? nullptr : new uint8_t[numBlocks * blkSize]),
+      dataStore(p.dedup_data ? new DedupDataStore(blkSize) : nullptr),
       stats(*this)
 {
+    fatal_if(!isPowerOf2(setSampling),
+             "set_sampling must be non-zero and a power of 2");
+
+    if (dataStore)
+        dedupStats.reset(new DedupStats(*this));
+
     registerExitCallback([this]() { cleanupRefs(); });
 }
 
@@ -83,11 +97,10 @@ BaseTags::findBlock(Addr addr, bool is_secure) const
     Addr tag = extractTag(addr);
 
     // Find possible entries that may contain the given address
-    const std::vector<ReplaceableEntry*> entries =
-        indexingPolicy->getPossibleEntries(addr);
+    indexingPolicy->getPossibleEntries(addr, possibleEntries);
 
     // Search for block
-    for (const auto& location : entries) {
+    for (const auto& location : possibleEntries) {
         CacheBlk* blk = static_cast<CacheBlk*>(location);
         if (blk->matchTag(tag, is_secure)) {
             return blk;
@@ -139,6 +152,60 @@ BaseTags::moveBlock(CacheBlk *src_blk, CacheBlk *dest_blk)
     assert(!src_blk->isValid());
 }
 
+void
+BaseTags::makeDataWritable(CacheBlk *blk)
+{
+    if (!storesData(blk))
+        return;
+
+    DedupLine *line = dataStore->makeWritable(blk->dedupLine);
+    if (line != blk->dedupLine)
+        dedupStats->copies++;
+    blk->dedupLine = line;
+    blk->data = line->data();
+}
+
+void
+BaseTags::deduplicateData(CacheBlk *blk)
+{
+    if (!storesData(blk) || !blk->dedupLine)
+        return;
+
+    DedupLine *line = dataStore->deduplicate(blk->dedupLine);
+    if (!line) {
+        dedupStats->zeroWrites++;
+    } else if (line->refCount > 1) {
+        dedupStats->sharedWrites++;
+    }
+    blk->dedupLine = line;
+    blk->data = line ? line->data() : dataStore->zeroData();
+}
+
+void
+BaseTags::releaseData(CacheBlk *blk)
+{
+    if (!storesData(blk))
+        return;
+
+    dataStore->release(blk->dedupLine);
+    blk->dedupLine = nullptr;
+    blk->data = dataStore->zeroData();
+}
+
+void
+BaseTags::moveData(CacheBlk *src_blk, CacheBlk *dest_blk)
+{
+    if (!dataStore) {
+        std::memcpy(dest_blk->data, src_blk->data, blkSize);
+        return;
+    }
+
+    // The lines are not bound to the blocks, so just hand the line over
+    releaseData(dest_blk);
+    std::swap(src_blk->data, dest_blk->data);
+    std::swap(src_blk->dedupLine, dest_blk->dedupLine);
+}
+
 Addr
 BaseTags::extractTag(const Addr addr) const
 {
@@ -299,4 +366,84 @@ BaseTags::BaseTagStats::preDumpStats()
     tags.computeStats();
 }
 
+BaseTags::SetSamplingStats::SetSamplingStats(BaseTags &_tags)
+    : statistics::Group(&_tags, "sampling"),
+    tags(_tags), estimator(tags.numSampledSets, tags.setSampling),
+
+    ADD_STAT(sampledHits, statistics::units::Count::get(),
+             "Number of hits in the modeled sets"),
+    ADD_STAT(sampledMisses, statistics::units::Count::get(),
+             "Number of misses in the modeled sets"),
+    ADD_STAT(sampledMissRate, statistics::units::Ratio::get(),
+             "Miss rate of the modeled sets",
+             sampledMisses / (sampledHits + sampledMisses)),
+    ADD_STAT(missRateError, statistics::units::Ratio::get(),
+             "Half width of the 95% confidence interval of the miss rate"),
+    ADD_STAT(predictedHits, statistics::units::Count::get(),
+             "Number of predicted hits in the sets that are not modeled"),
+    ADD_STAT(predictedMisses, statistics::units::Count::get(),
+             "Number of predicted misses in the sets that are not modeled"),
+    ADD_STAT(estimatedHits, statistics::units::Count::get(),
+             "Estimated number of hits of the whole cache",
+             sampledHits + predictedHits),
+    ADD_STAT(estimatedMisses, statistics::units::Count::get(),
+             "Estimated number of misses of the whole cache",
+             sampledMisses + predictedMisses)
+{
+}
+
+void
+BaseTags::SetSamplingStats::access(Addr addr, bool hit)
+{
+    if (!tags.isSampled(addr)) {
+        if (estimator.predict())
+            predictedHits++;
+        else
+            predictedMisses++;
+        return;
+    }
+
+    const unsigned set = (addr >> floorLog2(tags.blkSize)) &
+        (tags.numSampledSets - 1);
+    estimator.sample(set, hit);
+    if (hit)
+        sampledHits++;
+    else
+        sampledMisses++;
+}
+
+void
+BaseTags::SetSamplingStats::preDumpStats()
+{
+    statistics::Group::preDumpStats();
+
+    missRateError = estimator.missRateError();
+}
+
+BaseTags::DedupStats::DedupStats(BaseTags &tags)
+    : statistics::Group(&tags, "dedup"),
+    ADD_STAT(lines, statistics::units::Count::get(),
+             "Number of distinct data lines allocated"),
+    ADD_STAT(hostBytes, statistics::units::Byte::get(),
+             "Host memory used by the data lines"),
+    ADD_STAT(zeroWrites, statistics::units::Count::get(),
+             "Number of whole line writes of zeros"),
+    ADD_STAT(sharedWrites, statistics::units::Count::get(),
+             "Number of whole line writes sharing an existing line"),
+    ADD_STAT(copies, statistics::units::Count::get(),
+             "Number of lines allocated to write to shared or zero data")
+{
+    DedupDataStore &store = *tags.dataStore;
+    lines.functor([&store]() { return store.numLines(); });
+    hostBytes.functor([&store]() { return store.hostBytes(); });
+}
+
+void
+BaseTags::SetSamplingStats::resetStats()
+{
+    statistics::Group::resetStats();
+
+    estimator.reset();
+}
+
 } // namespace gem5
@@ -49,13 +49,18 @@
 #include <cassert>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "base/callback.hh"
+#include "base/compiler.hh"
 #include "base/logging.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "mem/cache/cache_blk.hh"
+#include "mem/cache/tags/dedup_data_store.hh"
+#include "mem/cache/tags/set_sampling.hh"
 #include "mem/packet.hh"
 #include "params/BaseTags.hh"
 #include "sim/clocked_object.hh"
@@ -67,6 +72,12 @@ class System;
 class IndexingPolicy;
 class ReplaceableEntry;
 
+GEM5_DEPRECATED_NAMESPACE(ReplacementPolicy, replacement_policy);
+namespace replacement_policy
+{
+    class Base;
+}
+
 /**
  * A common base class of Cache tagstore objects.
  */
@@ -88,6 +99,12 @@ class BaseTags : public ClockedObject
     /** Indexing policy */
     BaseIndexingPolicy *indexingPolicy;
 
+    /**
+     * Storage for the possible entries of an address, reused across
+     * lookups and victim searches so that they don't allocate.
+     */
+    mutable std::vector<ReplaceableEntry*> possibleEntries;
+
     /**
      * The number of tags that need to be touched to meet the warmup
      * percentage.
@@ -96,12 +113,31 @@ class BaseTags : public ClockedObject
     /** Marked true when the cache is warmed up. */
     bool warmedUp;
 
+    /**
+     * Only one in this many sets is modeled. Accesses to the other sets
+     * always miss, and their outcome is predicted from the modeled ones.
+     */
+    const unsigned setSampling;
+
+    /**
+     * Address bits that select a set which is not modeled. An address
+     * maps to a modeled set if none of them are set. Tags that support
+     * set sampling must set this up, along with numSampledSets.
+     */
+    Addr unsampledMask;
+
+    /** The number of modeled sets. */
+    unsigned numSampledSets;
+
     /** the number of blocks in the cache */
     const unsigned numBlocks;
 
-    /** The data blocks, 1 per cache block. */
+    /** The data blocks, 1 per cache block, unless deduplicated. */
     std::unique_ptr<uint8_t[]> dataBlks;
 
+    /** Deduplicated storage of the data of the blocks, if enabled. */
+    std::unique_ptr<DedupDataStore> dataStore;
+
     /**
      * TODO: It would be good if these stats were acquired after warmup.
      */
@@ -157,6 +193,89 @@ class BaseTags : public ClockedObject
         statistics::Scalar dataAccesses;
     } stats;
 
+    /**
+     * Estimates of the hits and misses of the whole cache when only a
+     * sample of its sets is modeled.
+     */
+    struct SetSamplingStats : public statistics::Group
+    {
+        SetSamplingStats(BaseTags &tags);
+
+        void preDumpStats() override;
+        void resetStats() override;
+
+        /** Account for an access, either sampled or predicted. */
+        void access(Addr addr, bool hit);
+
+        BaseTags &tags;
+
+        /** Estimates the miss rate and predicts the unmodeled sets. */
+        SetSamplingEstimator estimator;
+
+        /** Hits in the modeled sets. */
+        statistics::Scalar sampledHits;
+        /** Misses in the modeled sets. */
+        statistics::Scalar sampledMisses;
+        /** Miss rate of the modeled sets. */
+        statistics::Formula sampledMissRate;
+        /** Half width of the 95% confidence interval of the miss rate. */
+        statistics::Scalar missRateError;
+        /** Predicted hits in the sets that are not modeled. */
+        statistics::Scalar predictedHits;
+        /** Predicted misses in the sets that are not modeled. */
+        statistics::Scalar predictedMisses;
+        /** Estimated hits of the whole cache. */
+        statistics::Formula estimatedHits;
+        /** Estimated misses of the whole cache. */
+        statistics::Formula estimatedMisses;
+    };
+
+    /** Set sampling estimates, only when not all sets are modeled. */
+    std::unique_ptr<SetSamplingStats> samplingStats;
+
+    /** Statistics of the deduplicated data store. */
+    struct DedupStats : public statistics::Group
+    {
+        DedupStats(BaseTags &tags);
+
+        /** Number of distinct lines allocated. */
+        statistics::Value lines;
+        /** Host memory used by the lines. */
+        statistics::Value hostBytes;
+        /** Whole line writes of zeros, which need no line. */
+        statistics::Scalar zeroWrites;
+        /** Whole line writes that found a line to share. */
+        statistics::Scalar sharedWrites;
+        /** Lines allocated to write to a shared or zero line. */
+        statistics::Scalar copies;
+    };
+
+    /** Deduplication stats, only when the data is deduplicated. */
+    std::unique_ptr<DedupStats> dedupStats;
+
+    /**
+     * Whether the data of a block comes from the deduplicated store,
+     * which is not the case of blocks that are not part of the tags.
+     */
+    bool
+    storesData(const CacheBlk *blk) const
+    {
+        return dataStore &&
+            (blk->dedupLine || blk->data == dataStore->zeroData());
+    }
+
+    /**
+     * Release the deduplicated data of a block, which is left holding
+     * zeros.
+     */
+    void releaseData(CacheBlk *blk);
+
+    /**
+     * Move the data of a block to an invalid one, e.g., after moving
+     * the block's metadata with moveBlock.
+     */
+    void moveData(CacheBlk *src_blk, CacheBlk *dest_blk);
+
   public:
     typedef BaseTagsParams Params;
     BaseTags(const Params &p);
@@ -173,6 +292,17 @@ class BaseTags : public ClockedObject
      */
     virtual void tagsInit() = 0;
 
+    /**
+     * Get the replacement policy of this tag store, if it has one.
+     *
+     * @return The replacement policy, or nullptr if there is none.
+     */
+    virtual replacement_policy::Base *
+    getReplacementPolicy() const
+    {
+        return nullptr;
+    }
+
     /**
      * Average in the reference count for valid blocks when the simulation
      * exits.
@@ -207,6 +337,53 @@ class BaseTags : public ClockedObject
      */
     virtual ReplaceableEntry* findBlockBySetAndWay(int set, int way) const;
 
+    /** @return One in how many sets is modeled, 1 if all of them are. */
+    unsigned getSetSampling() const { return setSampling; }
+
+    /**
+     * Check whether an address maps to a set that is modeled. Lookups of
+     * the other addresses always miss, and no block is allocated for
+     * them.
+     *
+     * @param addr The address to check.
+     * @return True if the address maps to a modeled set.
+     */
+    bool isSampled(Addr addr) const
+    {
+        return (addr & unsampledMask) == 0;
+    }
+
+    /**
+     * Account for an access in the set sampling estimates. Does
+     * nothing if all sets are modeled.
+     *
+     * @param addr The address accessed.
+     * @param hit Whether the access hit in the tags.
+     */
+    void sampleAccess(Addr addr, bool hit)
+    {
+        if (samplingStats)
+            samplingStats->access(addr, hit);
+    }
+
+    /**
+     * Make the data of a block private before writing to it, as it may
+     * be shared with other blocks when deduplicated. Does nothing
+     * otherwise.
+     *
+     * @param blk The block about to be written.
+     */
+    void makeDataWritable(CacheBlk *blk);
+
+    /**
+     * Share the data of a block with the blocks with the same contents,
+     * after writing a whole line to it. Does nothing if the data is not
+     * deduplicated.
+     *
+     * @param blk The block that was written.
+     */
+    void deduplicateData(CacheBlk *blk);
+
     /**
      * Align an address to the block size.
      * @param addr the address to align.
@@ -261,6 +438,7 @@ class BaseTags : public ClockedObject
         stats.sampledRefs++;
 
         blk->invalidate();
+        releaseData(blk);
     }
 
     /**
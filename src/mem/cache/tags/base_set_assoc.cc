@@ -45,17 +45,24 @@
 
 #include "mem/cache/tags/base_set_assoc.hh"
 
+#include <algorithm>
 #include <string>
+#include <utility>
 
 #include "base/intmath.hh"
+#include "mem/cache/tags/indexing_policies/set_associative.hh"
+#include "mem/cache/tags/indexing_policies/zcache.hh"
+#include "mem/cache/tags/indexing_policies/zcache_walk.hh"
 
 namespace gem5
 {
 
 BaseSetAssoc::BaseSetAssoc(const Params &p)
-    :BaseTags(p), allocAssoc(p.assoc), blks(p.size / p.block_size),
+    :BaseTags(p), allocAssoc(p.assoc), blks(numBlocks),
      sequentialAccess(p.sequential_access),
-     replacementPolicy(p.replacement_policy)
+     replacementPolicy(p.replacement_policy),
+     setIndexing(dynamic_cast<const SetAssociative*>(p.indexing_policy)),
+     zcache(dynamic_cast<const ZCache*>(p.indexing_policy))
 {
     // There must be a indexing policy
     fatal_if(!p.indexing_policy, "An indexing policy is required");
@@ -64,6 +71,34 @@ BaseSetAssoc::BaseSetAssoc(const Params &p)
     if (blkSize < 4 || !isPowerOf2(blkSize)) {
         fatal("Block size must be at least 4 and a power of 2");
     }
+
+    if (setSampling > 1) {
+        // The blocks are only linked to the first sets of the indexing
+        // policy, so an address must map to the same set in every way
+        fatal_if(!dynamic_cast<const SetAssociative*>(p.indexing_policy),
+                 "Set sampling requires a set associative indexing policy");
+
+        numSampledSets = numBlocks / p.assoc;
+        fatal_if(numSampledSets == 0, "set_sampling exceeds the number of "
+                 "sets");
+
+        // The modeled sets are those whose index has its upper bits
+        // clear, so the bits above them select the unsampled sets
+        unsampledMask = Addr(setSampling - 1) <<
+            (floorLog2(blkSize) + floorLog2(numSampledSets));
+        samplingStats.reset(new SetSamplingStats(*this));
+    }
+
+    if (zcache)
+        zcacheStats.reset(new ZCacheStats(*this));
+
+    // The packed tags hold the ways of a set side by side, which only
+    // works if an address maps to the same set in every way
+    if (setIndexing && p.assoc <= PackedTagArray::maxAssoc) {
+        packedTags.reset(new PackedTagArray(numBlocks / p.assoc, p.assoc));
+    } else {
+        setIndexing = nullptr;
+    }
 }
 
 void
@@ -77,8 +112,10 @@ BaseSetAssoc::tagsInit()
         // Link block to indexing policy
         indexingPolicy->setEntry(blk, blk_index);
 
-        // Associate a data chunk to the block
-        blk->data = &dataBlks[blkSize*blk_index];
+        // Associate a data chunk to the block. Deduplicated blocks start
+        // out as zeros and only get a line when written.
+        blk->data = dataStore ? dataStore->zeroData() :
+            &dataBlks[blkSize*blk_index];
 
         // Associate a replacement data entry to the block
         blk->replacementData = replacementPolicy->instantiateEntry();
@@ -95,6 +132,26 @@ BaseSetAssoc::invalidate(CacheBlk *blk)
 
     // Invalidate replacement data
     replacementPolicy->invalidate(blk->replacementData);
+
+    if (packedTags)
+        packedTags->invalidate(blk->getSet(), blk->getWay());
+}
+
+CacheBlk*
+BaseSetAssoc::findBlock(Addr addr, bool is_secure) const
+{
+    if (!isSampled(addr))
+        return nullptr;
+
+    if (!packedTags)
+        return BaseTags::findBlock(addr, is_secure);
+
+    const uint32_t set = setIndexing->extractSet(addr);
+    const int way = packedTags->findWay(set, extractTag(addr), is_secure);
+    if (way < 0)
+        return nullptr;
+
+    return static_cast<CacheBlk*>(indexingPolicy->getEntry(set, way));
 }
 
 void
@@ -107,6 +164,69 @@ BaseSetAssoc::moveBlock(CacheBlk *src_blk, CacheBlk *dest_blk)
     // the one that is being moved.
     replacementPolicy->invalidate(src_blk->replacementData);
     replacementPolicy->reset(dest_blk->replacementData);
+
+    if (packedTags) {
+        packedTags->invalidate(src_blk->getSet(), src_blk->getWay());
+        packedTags->insert(dest_blk->getSet(), dest_blk->getWay(),
+                           dest_blk->getTag(), dest_blk->isSecure());
+    }
+}
+
+BaseSetAssoc::ZCacheStats::ZCacheStats(BaseSetAssoc &tags)
+    : statistics::Group(&tags, "zcache"),
+    ADD_STAT(relocations, statistics::units::Count::get(),
+             "Number of blocks moved to make room for an insertion")
+{
+}
+
+CacheBlk*
+BaseSetAssoc::findZCacheVictim(Addr addr, std::vector<CacheBlk*>& evict_blks)
+{
+    zcache->getCandidates(addr,
+        [this](const ReplaceableEntry *entry, Addr &blk_addr) {
+            const CacheBlk *blk = static_cast<const CacheBlk*>(entry);
+            if (!blk->isValid())
+                return false;
+            blk_addr = regenerateBlkAddr(blk);
+            return true;
+        }, possibleEntries, walkParents);
+
+    CacheBlk* victim = static_cast<CacheBlk*>(
+        replacementPolicy->getVictim(possibleEntries));
+    evict_blks.push_back(victim);
+
+    int index = std::find(possibleEntries.begin(), possibleEntries.end(),
+                          victim) - possibleEntries.begin();
+    zcachePath(possibleEntries, walkParents, index, relocations);
+    if (relocations.empty())
+        return victim;
+
+    return relocations.front();
+}
+
+void
+BaseSetAssoc::relocate(CacheBlk *blk)
+{
+    // The relocations are stale if the insertion is not the one they
+    // were found for, e.g., because the eviction of the victim failed
+    if (relocations.front() != blk || relocations.back()->isValid()) {
+        relocations.clear();
+        return;
+    }
+
+    // Move each block one step down the path, starting next to the
+    // evicted victim. The replacement data moves along with the block,
+    // so relocations do not look like accesses to the replacement policy.
+    for (size_t i = relocations.size() - 1; i > 0; --i) {
+        CacheBlk *src_blk = relocations[i - 1];
+        CacheBlk *dest_blk = relocations[i];
+        BaseTags::moveBlock(src_blk, dest_blk);
+        moveData(src_blk, dest_blk);
+        std::swap(src_blk->replacementData, dest_blk->replacementData);
+        replacementPolicy->invalidate(src_blk->replacementData);
+        zcacheStats->relocations++;
+    }
+    relocations.clear();
 }
 
 } // namespace gem5
@@ -48,6 +48,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -59,12 +60,16 @@
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/base.hh"
 #include "mem/cache/tags/indexing_policies/base.hh"
+#include "mem/cache/tags/packed_tag_array.hh"
 #include "mem/packet.hh"
 #include "params/BaseSetAssoc.hh"
 
 namespace gem5
 {
 
+class SetAssociative;
+class ZCache;
+
 /**
  * A basic cache tag store.
  * @sa  \ref gem5MemorySystem "gem5 Memory System"
@@ -87,6 +92,56 @@ class BaseSetAssoc : public BaseTags
     /** Replacement policy */
     replacement_policy::Base *replacementPolicy;
 
+    /**
+     * The indexing policy, if it places each address in a single set
+     * (i.e., it is a SetAssociative policy), and nullptr otherwise.
+     */
+    const SetAssociative *setIndexing;
+
+    /**
+     * Packed copy of the tags used to search a set in one go. Only
+     * used with setIndexing, and nullptr otherwise.
+     */
+    std::unique_ptr<PackedTagArray> packedTags;
+
+    /** The indexing policy, if it is a ZCache, and nullptr otherwise. */
+    const ZCache *zcache;
+
+    /** Storage for the parents of the candidates of a zcache walk. */
+    std::vector<int> walkParents;
+
+    /**
+     * The zcache entries whose blocks must move one step down before
+     * the next insertion, from the entry the new block goes to down to
+     * the victim's.
+     */
+    std::vector<CacheBlk*> relocations;
+
+    /** Statistics of the zcache relocations. */
+    struct ZCacheStats : public statistics::Group
+    {
+        ZCacheStats(BaseSetAssoc &tags);
+
+        /** Blocks moved to make room for an insertion. */
+        statistics::Scalar relocations;
+    };
+
+    /** Zcache stats, only when the indexing policy is a ZCache. */
+    std::unique_ptr<ZCacheStats> zcacheStats;
+
+    /**
+     * Find a victim with a zcache walk. If it is not an entry of the
+     * address, remember the relocations needed to reach it, and return
+     * the entry of the address at the start of them.
+     */
+    CacheBlk* findZCacheVictim(Addr addr, std::vector<CacheBlk*>& evict_blks);
+
+    /**
+     * Move the blocks of the pending relocations down towards the
+     * evicted victim, freeing the entry of blk.
+     */
+    void relocate(CacheBlk *blk);
+
   public:
     /** Convenience typedef. */
      typedef BaseSetAssocParams Params;
@@ -106,6 +161,12 @@ class BaseSetAssoc : public BaseTags
      */
     void tagsInit() override;
 
+    replacement_policy::Base *
+    getReplacementPolicy() const override
+    {
+        return replacementPolicy;
+    }
+
     /**
      * This function updates the tags when a block is invalidated. It also
      * updates the replacement data.
@@ -114,6 +175,16 @@ class BaseSetAssoc : public BaseTags
      */
     void invalidate(CacheBlk *blk) override;
 
+    /**
+     * Finds the given address in the cache, without updating replacement
+     * data. Searches the packed tags if available.
+     *
+     * @param addr The address to find.
+     * @param is_secure True if the target memory space is secure.
+     * @return Pointer to the cache block if found.
+     */
+    CacheBlk* findBlock(Addr addr, bool is_secure) const override;
+
     /**
      * Access block and update replacement data. May not succeed, in which case
      * nullptr is returned. This has all the implications of a cache access and
@@ -169,13 +240,19 @@ class BaseSetAssoc : public BaseTags
                          const std::size_t size,
                          std::vector<CacheBlk*>& evict_blks) override
     {
+        // Blocks of the sets that are not modeled are never allocated
+        if (!isSampled(addr))
+            return nullptr;
+
+        if (zcache)
+            return findZCacheVictim(addr, evict_blks);
+
         // Get possible entries to be victimized
-        const std::vector<ReplaceableEntry*> entries =
-            indexingPolicy->getPossibleEntries(addr);
+        indexingPolicy->getPossibleEntries(addr, possibleEntries);
 
         // Choose replacement victim from replacement candidates
         CacheBlk* victim = static_cast<CacheBlk*>(replacementPolicy->getVictim(
-                                entries));
+                                possibleEntries));
 
         // There is only one eviction for this replacement
         evict_blks.push_back(victim);
@@ -191,6 +268,11 @@ class BaseSetAssoc : public BaseTags
      */
     void insertBlock(const PacketPtr pkt, CacheBlk *blk) override
     {
+        // Make room for the block if its victim was found deeper in a
+        // zcache walk
+        if (!relocations.empty())
+            relocate(blk);
+
         // Insert block
         BaseTags::insertBlock(pkt, blk);
 
@@ -199,6 +281,11 @@ class BaseSetAssoc : public BaseTags
 
         // Update replacement policy
         replacementPolicy->reset(blk->replacementData, pkt);
+
+        if (packedTags) {
+            packedTags->insert(blk->getSet(), blk->getWay(), blk->getTag(),
+                               blk->isSecure());
+        }
     }
 
     void moveBlock(CacheBlk *src_blk, CacheBlk *dest_blk) override;
@@ -107,8 +107,9 @@ CompressedTags::findVictim(Addr addr, const bool is_secure,
                            std::vector<CacheBlk*>& evict_blks)
 {
     // Get all possible locations of this superblock
-    const std::vector<ReplaceableEntry*> superblock_entries =
-        indexingPolicy->getPossibleEntries(addr);
+    indexingPolicy->getPossibleEntries(addr, possibleEntries);
+    const std::vector<ReplaceableEntry*> &superblock_entries =
+        possibleEntries;
 
     // Check if the superblock this address belongs to has been allocated. If
     // so, try co-allocating
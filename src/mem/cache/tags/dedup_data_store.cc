@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/tags/dedup_data_store.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string_view>
+
+namespace gem5
+{
+
+DedupDataStore::DedupDataStore(unsigned blk_size)
+    : blkSize(blk_size), zeros(new uint8_t[blk_size]()), lines(0)
+{
+}
+
+DedupLine *
+DedupDataStore::allocate()
+{
+    void *mem = ::operator new(sizeof(DedupLine) + blkSize);
+    DedupLine *line = new (mem) DedupLine{1, false, 0};
+    lines++;
+    return line;
+}
+
+void
+DedupDataStore::free(DedupLine *line)
+{
+    line->~DedupLine();
+    ::operator delete(line);
+    lines--;
+}
+
+void
+DedupDataStore::unindex(DedupLine *line)
+{
+    assert(line->indexed);
+    auto range = index.equal_range(line->hash);
+    auto it = std::find_if(range.first, range.second,
+        [line](const auto &entry) { return entry.second == line; });
+    assert(it != range.second);
+    index.erase(it);
+    line->indexed = false;
+}
+
+DedupLine *
+DedupDataStore::makeWritable(DedupLine *line)
+{
+    if (line && line->refCount == 1) {
+        // The only user can write in place, once the line leaves the
+        // index as its contents will change
+        if (line->indexed) {
+            unindex(line);
+        }
+        return line;
+    }
+
+    DedupLine *copy = allocate();
+    if (line) {
+        std::memcpy(copy->data(), line->data(), blkSize);
+        line->refCount--;
+    } else {
+        std::memset(copy->data(), 0, blkSize);
+    }
+    return copy;
+}
+
+DedupLine *
+DedupDataStore::deduplicate(DedupLine *line)
+{
+    if (!line) {
+        return nullptr;
+    }
+    assert(line->refCount == 1 && !line->indexed);
+
+    if (std::memcmp(line->data(), zeros.get(), blkSize) == 0) {
+        free(line);
+        return nullptr;
+    }
+
+    const size_t hash = std::hash<std::string_view>()(std::string_view(
+        reinterpret_cast<const char *>(line->data()), blkSize));
+    auto range = index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        DedupLine *other = it->second;
+        if (std::memcmp(other->data(), line->data(), blkSize) == 0) {
+            other->refCount++;
+            free(line);
+            return other;
+        }
+    }
+
+    line->indexed = true;
+    line->hash = hash;
+    index.emplace(hash, line);
+    return line;
+}
+
+void
+DedupDataStore::release(DedupLine *line)
+{
+    if (!line) {
+        return;
+    }
+    assert(line->refCount > 0);
+
+    if (--line->refCount == 0) {
+        if (line->indexed) {
+            unindex(line);
+        }
+        free(line);
+    }
+}
+
+} // namespace gem5
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_CACHE_TAGS_DEDUP_DATA_STORE_HH__
+#define __MEM_CACHE_TAGS_DEDUP_DATA_STORE_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+namespace gem5
+{
+
+/**
+ * A line of data shared by all the blocks with the same contents. The
+ * data follows the header in the same allocation.
+ */
+struct DedupLine
+{
+    /** Number of blocks using the line. */
+    unsigned refCount;
+
+    /** Whether the line is in the content index, and thus read-only. */
+    bool indexed;
+
+    /** Hash of the contents, only valid if indexed. */
+    size_t hash;
+
+    uint8_t *data() { return reinterpret_cast<uint8_t *>(this + 1); }
+    const uint8_t *
+    data() const
+    {
+        return reinterpret_cast<const uint8_t *>(this + 1);
+    }
+};
+
+/**
+ * Content deduplicated storage for the data of cache blocks, so that
+ * the host memory used by large caches depends on how much distinct
+ * data they hold rather than on their size.
+ *
+ * Lines are allocated lazily, and blocks holding only zeros use no line
+ * at all, but a shared zero buffer instead. Whole lines written to a
+ * block are looked up in an index of their contents, and share an
+ * existing line if there is one. Shared lines are copied on write, so
+ * a block must be made writable before writing to its data. Partially
+ * written lines are private and not deduplicated until the next whole
+ * line write, to keep the hashing off the store path.
+ */
+class DedupDataStore
+{
+  public:
+    DedupDataStore(unsigned blk_size);
+
+    DedupDataStore(const DedupDataStore &) = delete;
+    DedupDataStore &operator=(const DedupDataStore &) = delete;
+
+    /**
+     * Data of the blocks without a line. It must not be written to.
+     */
+    uint8_t *zeroData() const { return zeros.get(); }
+
+    /**
+     * Get a line that can be written to without affecting other
+     * blocks, with the contents of the given one.
+     *
+     * @param line The current line of a block, nullptr for zeros.
+     * @return The line itself if it is private, or a private copy.
+     */
+    DedupLine *makeWritable(DedupLine *line);
+
+    /**
+     * Share a private line with the other blocks with the same
+     * contents, if any.
+     *
+     * @param line A private line of a block.
+     * @return The line to use instead, nullptr for zeros.
+     */
+    DedupLine *deduplicate(DedupLine *line);
+
+    /**
+     * Drop a block's reference to a line.
+     *
+     * @param line The line, nullptr for zeros.
+     */
+    void release(DedupLine *line);
+
+    /** Number of lines allocated. */
+    size_t numLines() const { return lines; }
+
+    /** Host memory used by the lines, in bytes. */
+    size_t
+    hostBytes() const
+    {
+        return lines * (sizeof(DedupLine) + blkSize);
+    }
+
+  private:
+    DedupLine *allocate();
+    void free(DedupLine *line);
+
+    /** Remove a line from the content index. */
+    void unindex(DedupLine *line);
+
+    const unsigned blkSize;
+
+    /** Data of all the lines holding only zeros. */
+    const std::unique_ptr<uint8_t[]> zeros;
+
+    /** Read-only lines, indexed by the hash of their contents. */
+    std::unordered_multimap<size_t, DedupLine *> index;
+
+    /** Number of lines allocated. */
+    size_t lines;
+};
+
+} // namespace gem5
+
+#endif // __MEM_CACHE_TAGS_DEDUP_DATA_STORE_HH__
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "mem/cache/tags/dedup_data_store.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+const unsigned blkSize = 64;
+
+/** Write a whole line of the given byte, as a fill would. */
+DedupLine *
+fill(DedupDataStore &store, DedupLine *line, uint8_t value)
+{
+    line = store.makeWritable(line);
+    std::memset(line->data(), value, blkSize);
+    return store.deduplicate(line);
+}
+
+} // anonymous namespace
+
+/** Test that zero lines use no storage. */
+TEST(DedupDataStoreTest, Zeros)
+{
+    DedupDataStore store(blkSize);
+
+    for (unsigned i = 0; i < blkSize; i++) {
+        ASSERT_EQ(store.zeroData()[i], 0);
+    }
+
+    DedupLine *line = fill(store, nullptr, 0);
+    ASSERT_EQ(line, nullptr);
+    ASSERT_EQ(store.numLines(), 0);
+
+    // Writing to a zero line makes a private copy of zeros
+    line = store.makeWritable(nullptr);
+    ASSERT_EQ(store.numLines(), 1);
+    ASSERT_EQ(std::memcmp(line->data(), store.zeroData(), blkSize), 0);
+    store.release(line);
+    ASSERT_EQ(store.numLines(), 0);
+}
+
+/** Test that lines with the same contents are shared. */
+TEST(DedupDataStoreTest, Share)
+{
+    DedupDataStore store(blkSize);
+
+    DedupLine *a = fill(store, nullptr, 1);
+    DedupLine *b = fill(store, nullptr, 1);
+    DedupLine *c = fill(store, nullptr, 2);
+    ASSERT_NE(a, nullptr);
+    ASSERT_EQ(a, b);
+    ASSERT_NE(a, c);
+    ASSERT_EQ(a->refCount, 2);
+    ASSERT_EQ(store.numLines(), 2);
+
+    store.release(a);
+    ASSERT_EQ(store.numLines(), 2);
+    store.release(b);
+    ASSERT_EQ(store.numLines(), 1);
+
+    // The released contents are no longer found
+    DedupLine *d = fill(store, nullptr, 1);
+    ASSERT_EQ(d->refCount, 1);
+    ASSERT_EQ(store.numLines(), 2);
+}
+
+/** Test that writing to a shared line does not affect the others. */
+TEST(DedupDataStoreTest, CopyOnWrite)
+{
+    DedupDataStore store(blkSize);
+
+    DedupLine *a = fill(store, nullptr, 3);
+    DedupLine *b = fill(store, nullptr, 3);
+    ASSERT_EQ(a, b);
+
+    b = store.makeWritable(b);
+    ASSERT_NE(a, b);
+    ASSERT_EQ(a->refCount, 1);
+    ASSERT_EQ(std::memcmp(a->data(), b->data(), blkSize), 0);
+
+    b->data()[5] = 4;
+    ASSERT_EQ(a->data()[5], 3);
+
+    // A partially written line is private, and the line it was copied
+    // from can be written in place by its only user
+    ASSERT_EQ(store.makeWritable(b), b);
+    ASSERT_EQ(store.makeWritable(a), a);
+    ASSERT_EQ(store.numLines(), 2);
+
+    // Writing a line in place removes it from the index
+    a->data()[0] = 7;
+    DedupLine *c = fill(store, nullptr, 3);
+    ASSERT_NE(c, a);
+    ASSERT_EQ(c->refCount, 1);
+}
+
+/** Test that rewriting a whole line makes it shareable again. */
+TEST(DedupDataStoreTest, Rewrite)
+{
+    DedupDataStore store(blkSize);
+
+    DedupLine *a = fill(store, nullptr, 5);
+    DedupLine *b = fill(store, nullptr, 6);
+    ASSERT_NE(a, b);
+
+    b = fill(store, b, 5);
+    ASSERT_EQ(a, b);
+    ASSERT_EQ(store.numLines(), 1);
+
+    b = fill(store, b, 0);
+    ASSERT_EQ(b, nullptr);
+    ASSERT_EQ(a->refCount, 1);
+    ASSERT_EQ(store.numLines(), 1);
+}
@@ -74,6 +74,9 @@ FALRU::FALRU(const Params &p)
               blkSize);
     if (!isPowerOf2(size))
         fatal("Cache Size must be power of 2 for now");
+    if (setSampling != 1)
+        fatal("A fully associative cache has a single set to sample");
+    fatal_if(dataStore, "FALRU doesn't support data deduplication");
 
     blks = new FALRUBlk[numBlocks];
 }
@@ -52,3 +52,14 @@ class SkewedAssociative(BaseIndexingPolicy):
     type = 'SkewedAssociative'
     cxx_class = 'gem5::SkewedAssociative'
     cxx_header = "mem/cache/tags/indexing_policies/skewed_associative.hh"
+
+class ZCache(SkewedAssociative):
+    type = 'ZCache'
+    cxx_class = 'gem5::ZCache'
+    cxx_header = "mem/cache/tags/indexing_policies/zcache.hh"
+
+    # The 4-way zcache with 52 candidates evaluated in the original paper
+    # walks three levels deep. Only BaseSetAssoc tags can relocate blocks,
+    # and the relocations are assumed to take no time.
+    max_candidates = Param.Unsigned(52,
+        "Maximum number of replacement candidates of a relocation walk")
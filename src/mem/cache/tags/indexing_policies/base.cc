@@ -101,4 +101,12 @@ BaseIndexingPolicy::extractTag(const Addr addr) const
     return (addr >> tagShift);
 }
 
+void
+BaseIndexingPolicy::getPossibleEntries(const Addr addr,
+                                       std::vector<ReplaceableEntry*> &entries)
+                                                                        const
+{
+    entries = getPossibleEntries(addr);
+}
+
 } // namespace gem5
@@ -149,6 +149,19 @@ class BaseIndexingPolicy : public SimObject
     virtual std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr)
                                                                     const = 0;
 
+    /**
+     * Find all possible entries for insertion and replacement of an
+     * address, without allocating a new vector. The entries are stored
+     * in the vector provided, which is cleared first, so that callers
+     * can keep reusing its storage.
+     *
+     * @param addr The addr to a find possible entries for.
+     * @param entries The possible entries.
+     */
+    virtual void getPossibleEntries(const Addr addr,
+                                    std::vector<ReplaceableEntry*> &entries)
+                                                                    const;
+
     /**
      * Regenerate an entry's address from its tag and assigned indexing bits.
      *
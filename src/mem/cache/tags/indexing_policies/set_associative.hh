@@ -81,7 +81,12 @@ class ReplaceableEntry;
  */
 class SetAssociative : public BaseIndexingPolicy
 {
-  protected:
+  public:
+    /**
+     * Convenience typedef.
+     */
+    typedef SetAssociativeParams Params;
+
     /**
      * Apply a hash function to calculate address set.
      *
@@ -90,12 +95,6 @@ class SetAssociative : public BaseIndexingPolicy
      */
     virtual uint32_t extractSet(const Addr addr) const;
 
-  public:
-    /**
-     * Convenience typedef.
-     */
-    typedef SetAssociativeParams Params;
-
     /**
      * Construct and initialize this policy.
      */
@@ -118,6 +117,17 @@ class SetAssociative : public BaseIndexingPolicy
     std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr) const
                                                                      override;
 
+    /**
+     * Find all possible entries for insertion and replacement of an
+     * address, storing them in the given vector.
+     *
+     * @param addr The addr to a find possible entries for.
+     * @param entries The possible entries.
+     */
+    void getPossibleEntries(const Addr addr,
+                            std::vector<ReplaceableEntry*> &entries) const
+                                                                   override;
+
     /**
      * Regenerate an entry's address from its tag and assigned set and way.
      *
@@ -210,14 +210,22 @@ std::vector<ReplaceableEntry*>
 SkewedAssociative::getPossibleEntries(const Addr addr) const
 {
     std::vector<ReplaceableEntry*> entries;
+    getPossibleEntries(addr, entries);
+    return entries;
+}
+
+void
+SkewedAssociative::getPossibleEntries(const Addr addr,
+                                      std::vector<ReplaceableEntry*> &entries)
+                                                                        const
+{
+    entries.clear();
 
     // Parse all ways
     for (uint32_t way = 0; way < assoc; ++way) {
         // Apply hash to get set, and get way entry in it
         entries.push_back(sets[extractSet(addr, way)][way]);
     }
-
-    return entries;
 }
 
 } // namespace gem5
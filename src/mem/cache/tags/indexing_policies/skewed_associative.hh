@@ -71,7 +71,7 @@ class ReplaceableEntry;
  */
 class SkewedAssociative : public BaseIndexingPolicy
 {
-  private:
+  protected:
     /**
      * The number of skewing functions implemented. Should be updated if more
      * functions are added. If more than this number of skewing functions are
@@ -163,6 +163,17 @@ class SkewedAssociative : public BaseIndexingPolicy
     std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr) const
                                                                    override;
 
+    /**
+     * Find all possible entries for insertion and replacement of an
+     * address, storing them in the given vector.
+     *
+     * @param addr The addr to a find possible entries for.
+     * @param entries The possible entries.
+     */
+    void getPossibleEntries(const Addr addr,
+                            std::vector<ReplaceableEntry*> &entries) const
+                                                                   override;
+
     /**
      * Regenerate an entry's address from its tag and assigned set and way.
      * Uses the inverse of the skewing function.
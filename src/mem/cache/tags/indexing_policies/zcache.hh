@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a zcache indexing policy.
+ */
+
+#ifndef __MEM_CACHE_INDEXING_POLICIES_ZCACHE_HH__
+#define __MEM_CACHE_INDEXING_POLICIES_ZCACHE_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
+#include "mem/cache/tags/indexing_policies/skewed_associative.hh"
+#include "mem/cache/tags/indexing_policies/zcache_walk.hh"
+#include "params/ZCache.hh"
+
+namespace gem5
+{
+
+/**
+ * A zcache indexing policy (Sanchez and Kozyrakis, MICRO'10).
+ * @sa  \ref gem5MemorySystem "gem5 Memory System"
+ *
+ * An address is placed as in a skewed associative cache, so it can
+ * only live in one entry per way. However, when looking for a victim
+ * the blocks in those entries are also considered for relocation to
+ * their own entries in the other ways, and so on, breadth first. This
+ * yields many more replacement candidates than ways. Evicting a
+ * candidate found deeper in the walk means moving each block on the
+ * path to it one step down, which frees an entry of the new address.
+ *
+ * Lookups only need to check the entries of the address itself, as
+ * with a skewed associative cache.
+ *
+ * The relocations take no time. As in the paper, they are assumed to
+ * be done while the miss that caused them is served from below.
+ */
+class ZCache : public SkewedAssociative
+{
+  protected:
+    /** Maximum number of replacement candidates of a walk. */
+    const unsigned maxCandidates;
+
+  public:
+    /** Convenience typedef. */
+    typedef ZCacheParams Params;
+
+    /**
+     * Construct and initialize this policy.
+     */
+    ZCache(const Params &p);
+
+    /**
+     * Destructor.
+     */
+    ~ZCache() {};
+
+    /**
+     * Find the replacement candidates of an address with a bounded
+     * breadth-first walk. The first candidates are the possible
+     * entries of the address; every valid candidate then adds the
+     * entries its own block could move to in the other ways, until
+     * there are maxCandidates of them. An entry is never added twice.
+     *
+     * @param addr The address to find a victim for.
+     * @param get_addr Callable taking a candidate and a reference to
+     *        an address. If the candidate holds a block, it stores the
+     *        address of the block and returns true.
+     * @param candidates The replacement candidates. Cleared first.
+     * @param parents The index of the candidate each candidate was
+     *        reached from, whose block would be relocated into it, or
+     *        -1 for the entries of the address. Cleared first.
+     */
+    template <typename GetAddr>
+    void
+    getCandidates(const Addr addr, GetAddr &&get_addr,
+                  std::vector<ReplaceableEntry*> &candidates,
+                  std::vector<int> &parents) const
+    {
+        zcacheWalk(addr, assoc, maxCandidates,
+            [this](Addr entry_addr, uint32_t way) {
+                return sets[extractSet(entry_addr, way)][way];
+            }, get_addr, candidates, parents);
+    }
+};
+
+} // namespace gem5
+
+#endif //__MEM_CACHE_INDEXING_POLICIES_ZCACHE_HH__
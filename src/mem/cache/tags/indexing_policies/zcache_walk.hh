@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * The replacement candidate walk of a zcache, apart from the indexing
+ * policy and the tags so that it can be tested on its own.
+ */
+
+#ifndef __MEM_CACHE_INDEXING_POLICIES_ZCACHE_WALK_HH__
+#define __MEM_CACHE_INDEXING_POLICIES_ZCACHE_WALK_HH__
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
+
+namespace gem5
+{
+
+/**
+ * Find the replacement candidates of an address with a bounded
+ * breadth-first walk. The first candidates are the entries of the
+ * address in each way; every valid candidate then adds the entries its
+ * own block could move to in the other ways, until there are
+ * max_candidates of them. An entry is never added twice.
+ *
+ * @param addr The address to find a victim for.
+ * @param assoc The number of ways.
+ * @param max_candidates The maximum number of candidates.
+ * @param entry_of Callable taking an address and a way, and returning
+ *        the entry of the address in that way.
+ * @param get_addr Callable taking a candidate and a reference to an
+ *        address. If the candidate holds a block, it stores the address
+ *        of the block and returns true.
+ * @param candidates The replacement candidates. Cleared first.
+ * @param parents The index of the candidate each candidate was reached
+ *        from, whose block would be relocated into it, or -1 for the
+ *        entries of the address. Cleared first.
+ */
+template <typename EntryOf, typename GetAddr>
+void
+zcacheWalk(const Addr addr, const uint32_t assoc,
+           const size_t max_candidates, EntryOf &&entry_of,
+           GetAddr &&get_addr, std::vector<ReplaceableEntry*> &candidates,
+           std::vector<int> &parents)
+{
+    candidates.clear();
+    for (uint32_t way = 0; way < assoc; ++way)
+        candidates.push_back(entry_of(addr, way));
+    parents.assign(candidates.size(), -1);
+
+    for (size_t i = 0; i < candidates.size() &&
+             candidates.size() < max_candidates; ++i) {
+        // An invalid entry is already free, so nothing needs to move
+        // out of it
+        Addr blk_addr = 0;
+        if (!get_addr(candidates[i], blk_addr))
+            continue;
+
+        const uint32_t blk_way = candidates[i]->getWay();
+        for (uint32_t way = 0; way < assoc &&
+                 candidates.size() < max_candidates; ++way) {
+            if (way == blk_way)
+                continue;
+
+            ReplaceableEntry *entry = entry_of(blk_addr, way);
+            if (std::find(candidates.begin(), candidates.end(), entry) ==
+                candidates.end()) {
+                candidates.push_back(entry);
+                parents.push_back(i);
+            }
+        }
+    }
+}
+
+/**
+ * Find the relocations needed to evict a candidate of a zcache walk.
+ * Each block on the path moves one step down, towards the evicted
+ * candidate, which frees the entry of the address at its top.
+ *
+ * @param candidates The candidates of the walk.
+ * @param parents The parents of the candidates.
+ * @param victim The index of the candidate to evict.
+ * @param path The entries of the path, from the entry of the address
+ *        down to the victim. Cleared first, and left empty if the
+ *        victim is an entry of the address, as nothing needs to move.
+ */
+template <typename Entry>
+void
+zcachePath(const std::vector<ReplaceableEntry*> &candidates,
+           const std::vector<int> &parents, int victim,
+           std::vector<Entry*> &path)
+{
+    path.clear();
+    if (parents[victim] < 0)
+        return;
+
+    for (int index = victim; index >= 0; index = parents[index])
+        path.push_back(static_cast<Entry*>(candidates[index]));
+    std::reverse(path.begin(), path.end());
+}
+
+} // namespace gem5
+
+#endif //__MEM_CACHE_INDEXING_POLICIES_ZCACHE_WALK_HH__
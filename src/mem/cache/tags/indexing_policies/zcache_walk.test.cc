@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <vector>
+
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
+#include "mem/cache/tags/indexing_policies/zcache_walk.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/**
+ * A 2-way zcache of 4 entries per way. Way 0 indexes with the two
+ * lowest bits of the address, and way 1 with the two bits above them.
+ */
+class ZCacheWalkTest : public ::testing::Test
+{
+  protected:
+    static constexpr uint32_t assoc = 2;
+    static constexpr uint32_t numSets = 4;
+
+    ReplaceableEntry entries[assoc][numSets];
+    /** The address of the block in each valid entry. */
+    std::map<const ReplaceableEntry*, Addr> blocks;
+
+    std::vector<ReplaceableEntry*> candidates;
+    std::vector<int> parents;
+
+    ZCacheWalkTest()
+    {
+        for (uint32_t way = 0; way < assoc; way++)
+            for (uint32_t set = 0; set < numSets; set++)
+                entries[way][set].setPosition(set, way);
+    }
+
+    ReplaceableEntry *
+    entryOf(Addr addr, uint32_t way)
+    {
+        return &entries[way][(way ? addr / numSets : addr) % numSets];
+    }
+
+    ReplaceableEntry *
+    e(uint32_t way, uint32_t set)
+    {
+        return &entries[way][set];
+    }
+
+    void
+    walk(Addr addr, size_t max_candidates)
+    {
+        zcacheWalk(addr, assoc, max_candidates,
+            [this](Addr entry_addr, uint32_t way) {
+                return entryOf(entry_addr, way);
+            },
+            [this](const ReplaceableEntry *entry, Addr &blk_addr) {
+                auto it = blocks.find(entry);
+                if (it == blocks.end())
+                    return false;
+                blk_addr = it->second;
+                return true;
+            }, candidates, parents);
+    }
+
+    /** Insert an address by evicting a candidate, as the tags do. */
+    void
+    insert(Addr addr, int victim)
+    {
+        blocks.erase(candidates[victim]);
+        std::vector<ReplaceableEntry*> path;
+        zcachePath(candidates, parents, victim, path);
+        for (size_t i = path.size() ? path.size() - 1 : 0; i > 0; --i) {
+            blocks[path[i]] = blocks.at(path[i - 1]);
+            blocks.erase(path[i - 1]);
+        }
+        ReplaceableEntry *entry = path.empty() ? candidates[victim] :
+            path.front();
+        ASSERT_EQ(blocks.count(entry), 0);
+        blocks[entry] = addr;
+    }
+
+    /** Check that every block is in one of its own entries. */
+    void
+    checkPlacement()
+    {
+        for (const auto &[entry, addr] : blocks)
+            EXPECT_EQ(entryOf(addr, entry->getWay()), entry);
+    }
+};
+
+} // anonymous namespace
+
+/** The walk visits the entries of the blocks breadth first. */
+TEST_F(ZCacheWalkTest, Candidates)
+{
+    blocks = {{e(0, 0), 4}, {e(1, 0), 1}, {e(1, 1), 6}, {e(0, 1), 9}};
+    checkPlacement();
+
+    walk(0, 6);
+    // The invalid entries at the bottom of the walk are not followed
+    EXPECT_EQ(candidates, (std::vector<ReplaceableEntry*>{
+        e(0, 0), e(1, 0), e(1, 1), e(0, 1), e(0, 2), e(1, 2)}));
+    EXPECT_EQ(parents, (std::vector<int>{-1, -1, 0, 1, 2, 3}));
+
+    // Stopping at the first level gives the skewed associative entries
+    walk(0, 2);
+    EXPECT_EQ(candidates, (std::vector<ReplaceableEntry*>{
+        e(0, 0), e(1, 0)}));
+    EXPECT_EQ(parents, (std::vector<int>{-1, -1}));
+}
+
+/** An entry reached through two blocks is only a candidate once. */
+TEST_F(ZCacheWalkTest, NoDuplicates)
+{
+    blocks = {{e(0, 0), 4}, {e(1, 0), 1}, {e(1, 1), 5}, {e(0, 1), 9}};
+    checkPlacement();
+
+    // 5 could move to e(0, 1), which was already reached through 1
+    walk(0, 8);
+    EXPECT_EQ(candidates, (std::vector<ReplaceableEntry*>{
+        e(0, 0), e(1, 0), e(1, 1), e(0, 1), e(1, 2)}));
+    EXPECT_EQ(parents, (std::vector<int>{-1, -1, 0, 1, 3}));
+
+    walk(0, 3);
+    EXPECT_EQ(candidates, (std::vector<ReplaceableEntry*>{
+        e(0, 0), e(1, 0), e(1, 1)}));
+}
+
+/** Evicting a deep candidate moves the blocks on its path down. */
+TEST_F(ZCacheWalkTest, Relocation)
+{
+    blocks = {{e(0, 0), 4}, {e(1, 0), 1}, {e(1, 1), 6}, {e(0, 1), 9}};
+    walk(0, 6);
+
+    std::vector<ReplaceableEntry*> path;
+    zcachePath(candidates, parents, 4, path);
+    EXPECT_EQ(path, (std::vector<ReplaceableEntry*>{
+        e(0, 0), e(1, 1), e(0, 2)}));
+
+    // Using the free e(0, 2) keeps every block: 6 moves into it, and 4
+    // takes the place of 6
+    insert(0, 4);
+    EXPECT_EQ(blocks, (std::map<const ReplaceableEntry*, Addr>{
+        {e(0, 0), 0}, {e(1, 0), 1}, {e(1, 1), 4}, {e(0, 1), 9},
+        {e(0, 2), 6}}));
+    checkPlacement();
+
+    // Evicting an entry of the address moves nothing
+    walk(8, 6);
+    zcachePath(candidates, parents, 0, path);
+    EXPECT_TRUE(path.empty());
+    insert(8, 0);
+    EXPECT_EQ(blocks.at(e(0, 0)), 8);
+    checkPlacement();
+
+    // Evicting 9 from the second level moves 1 into its entry
+    walk(16, 6);
+    EXPECT_EQ(candidates[1], e(1, 0));
+    EXPECT_EQ(candidates[3], e(0, 1));
+    insert(16, 3);
+    EXPECT_EQ(blocks, (std::map<const ReplaceableEntry*, Addr>{
+        {e(0, 0), 8}, {e(1, 0), 16}, {e(1, 1), 4}, {e(0, 1), 1},
+        {e(0, 2), 6}}));
+    checkPlacement();
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_CACHE_TAGS_PACKED_TAG_ARRAY_HH__
+#define __MEM_CACHE_TAGS_PACKED_TAG_ARRAY_HH__
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "base/bitfield.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/**
+ * A copy of the tag, valid and secure bits of every entry of a set
+ * associative tag store, kept as a structure of arrays so that all ways
+ * of a set can be matched at once instead of visiting each entry.
+ *
+ * The tags of a set are contiguous and padded to a multiple of four
+ * ways, and the valid and secure bits of a set are bit masks, which
+ * limits the associativity to 64. Lookups compare the tags with AVX2 or
+ * NEON when the compiler targets them, and with a plain loop otherwise.
+ */
+class PackedTagArray
+{
+  public:
+    /** The largest associativity supported. */
+    static constexpr unsigned maxAssoc = 64;
+
+    /**
+     * @param num_sets Number of sets.
+     * @param assoc Number of ways per set.
+     */
+    PackedTagArray(uint32_t num_sets, unsigned assoc);
+
+    /** Record that a way now holds a valid tag. */
+    void
+    insert(uint32_t set, unsigned way, Addr tag, bool is_secure)
+    {
+        assert(set < numSets && way < assoc);
+        const uint64_t bit = 1ULL << way;
+        tags[set * stride + way] = tag;
+        valid[set] |= bit;
+        if (is_secure)
+            secure[set] |= bit;
+        else
+            secure[set] &= ~bit;
+    }
+
+    /** Record that a way no longer holds a valid tag. */
+    void
+    invalidate(uint32_t set, unsigned way)
+    {
+        assert(set < numSets && way < assoc);
+        const uint64_t bit = 1ULL << way;
+        tags[set * stride + way] = MaxAddr;
+        valid[set] &= ~bit;
+        secure[set] &= ~bit;
+    }
+
+    /**
+     * Find the way of a set holding a tag.
+     *
+     * @param set The set to search.
+     * @param tag The tag to match.
+     * @param is_secure Whether the tag is in the secure address space.
+     * @return The lowest matching way, or -1 if none matches.
+     */
+    int
+    findWay(uint32_t set, Addr tag, bool is_secure) const
+    {
+        assert(set < numSets);
+        const Addr *row = &tags[set * stride];
+        uint64_t match = 0;
+
+#if defined(__AVX2__)
+        const __m256i key = _mm256_set1_epi64x(tag);
+        for (unsigned way = 0; way < stride; way += 4) {
+            const __m256i row_tags = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i *>(row + way));
+            const __m256i eq = _mm256_cmpeq_epi64(row_tags, key);
+            match |= uint64_t(_mm256_movemask_pd(_mm256_castsi256_pd(eq)))
+                << way;
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        const uint64x2_t key = vdupq_n_u64(tag);
+        for (unsigned way = 0; way < stride; way += 2) {
+            const uint64x2_t eq = vceqq_u64(vld1q_u64(row + way), key);
+            match |= (vgetq_lane_u64(eq, 0) & 1) << way;
+            match |= (vgetq_lane_u64(eq, 1) & 1) << (way + 1);
+        }
+#else
+        for (unsigned way = 0; way < assoc; ++way)
+            match |= uint64_t(row[way] == tag) << way;
+#endif
+
+        match &= valid[set] & (is_secure ? secure[set] : ~secure[set]);
+        return match ? ctz64(match) : -1;
+    }
+
+  private:
+    const uint32_t numSets;
+    const unsigned assoc;
+
+    /** Number of tags per set, including the padding. */
+    const unsigned stride;
+
+    /** Tags of all sets, stride entries per set. */
+    std::vector<Addr> tags;
+
+    /** Per-set masks of the ways that are valid. */
+    std::vector<uint64_t> valid;
+
+    /** Per-set masks of the ways that are secure. */
+    std::vector<uint64_t> secure;
+};
+
+} // namespace gem5
+
+#endif //__MEM_CACHE_TAGS_PACKED_TAG_ARRAY_HH__
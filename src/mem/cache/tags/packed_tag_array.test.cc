@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "mem/cache/tags/packed_tag_array.hh"
+
+using namespace gem5;
+
+/** Test that lookups only match valid tags of the searched set. */
+TEST(PackedTagArrayTest, FindWay)
+{
+    PackedTagArray tags(4, 8);
+
+    // Nothing matches initially, not even the tag of invalid entries
+    ASSERT_EQ(tags.findWay(0, 0x10, false), -1);
+    ASSERT_EQ(tags.findWay(0, MaxAddr, false), -1);
+
+    tags.insert(1, 3, 0x10, false);
+    tags.insert(1, 7, 0x20, false);
+    ASSERT_EQ(tags.findWay(1, 0x10, false), 3);
+    ASSERT_EQ(tags.findWay(1, 0x20, false), 7);
+    ASSERT_EQ(tags.findWay(1, 0x30, false), -1);
+    ASSERT_EQ(tags.findWay(0, 0x10, false), -1);
+    ASSERT_EQ(tags.findWay(2, 0x10, false), -1);
+
+    tags.invalidate(1, 3);
+    ASSERT_EQ(tags.findWay(1, 0x10, false), -1);
+    ASSERT_EQ(tags.findWay(1, 0x20, false), 7);
+}
+
+/** Test that the secure bit must match. */
+TEST(PackedTagArrayTest, Secure)
+{
+    PackedTagArray tags(2, 4);
+
+    tags.insert(0, 1, 0x10, true);
+    ASSERT_EQ(tags.findWay(0, 0x10, true), 1);
+    ASSERT_EQ(tags.findWay(0, 0x10, false), -1);
+
+    tags.insert(0, 2, 0x10, false);
+    ASSERT_EQ(tags.findWay(0, 0x10, true), 1);
+    ASSERT_EQ(tags.findWay(0, 0x10, false), 2);
+
+    // Reusing an entry for a non-secure tag clears its secure bit
+    tags.invalidate(0, 1);
+    tags.insert(0, 1, 0x30, false);
+    ASSERT_EQ(tags.findWay(0, 0x30, false), 1);
+    ASSERT_EQ(tags.findWay(0, 0x30, true), -1);
+}
+
+/** Test every way of associativities that do and don't need padding. */
+TEST(PackedTagArrayTest, AllWays)
+{
+    for (unsigned assoc : { 1u, 3u, 4u, 13u, 16u, 32u, 63u, 64u }) {
+        PackedTagArray tags(3, assoc);
+        for (unsigned way = 0; way < assoc; ++way)
+            tags.insert(2, way, 0x100 + way, false);
+
+        for (unsigned way = 0; way < assoc; ++way) {
+            ASSERT_EQ(tags.findWay(2, 0x100 + way, false), (int)way)
+                << "assoc " << assoc;
+            ASSERT_EQ(tags.findWay(1, 0x100 + way, false), -1)
+                << "assoc " << assoc;
+        }
+        ASSERT_EQ(tags.findWay(2, 0x100 + assoc, false), -1);
+    }
+}
+
+/** Test that the lowest way is returned if several match. */
+TEST(PackedTagArrayTest, LowestWay)
+{
+    PackedTagArray tags(1, 16);
+    tags.insert(0, 12, 0x10, false);
+    tags.insert(0, 5, 0x10, false);
+    ASSERT_EQ(tags.findWay(0, 0x10, false), 5);
+}
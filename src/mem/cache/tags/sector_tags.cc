@@ -44,6 +44,7 @@
 #include "mem/cache/replacement_policies/base.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/indexing_policies/base.hh"
+#include "mem/cache/tags/indexing_policies/zcache.hh"
 
 namespace gem5
 {
@@ -65,6 +66,11 @@ SectorTags::SectorTags(const SectorTagsParams &p)
              "Block size must be at least 4 and a power of 2");
     fatal_if(!isPowerOf2(numBlocksPerSector),
              "# of blocks per sector must be non-zero and a power of 2");
+    fatal_if(setSampling != 1, "Sector tags don't support set sampling");
+    fatal_if(dataStore, "Sector tags don't support data deduplication");
+    // Sector and compressed tags would have to relocate whole sectors
+    fatal_if(dynamic_cast<const ZCache*>(p.indexing_policy),
+             "Sector tags don't support zcache indexing");
 }
 
 void
@@ -257,11 +263,10 @@ SectorTags::findBlock(Addr addr, bool is_secure) const
     const Addr offset = extractSectorOffset(addr);
 
     // Find all possible sector entries that may contain the given address
-    const std::vector<ReplaceableEntry*> entries =
-        indexingPolicy->getPossibleEntries(addr);
+    indexingPolicy->getPossibleEntries(addr, possibleEntries);
 
     // Search for block
-    for (const auto& sector : entries) {
+    for (const auto& sector : possibleEntries) {
         auto blk = static_cast<SectorBlk*>(sector)->blks[offset];
         if (blk->matchTag(tag, is_secure)) {
             return blk;
@@ -277,8 +282,8 @@ SectorTags::findVictim(Addr addr, const bool is_secure, const std::size_t size,
                        std::vector<CacheBlk*>& evict_blks)
 {
     // Get possible entries to be victimized
-    const std::vector<ReplaceableEntry*> sector_entries =
-        indexingPolicy->getPossibleEntries(addr);
+    indexingPolicy->getPossibleEntries(addr, possibleEntries);
+    const std::vector<ReplaceableEntry*> &sector_entries = possibleEntries;
 
     // Check if the sector this address belongs to has been allocated
     Addr tag = extractTag(addr);
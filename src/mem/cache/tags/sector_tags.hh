@@ -125,6 +125,12 @@ class SectorTags : public BaseTags
      */
     void tagsInit() override;
 
+    replacement_policy::Base *
+    getReplacementPolicy() const override
+    {
+        return replacementPolicy;
+    }
+
     /**
      * This function updates the tags when a block is invalidated but does
      * not invalidate the block itself. It also updates the replacement data.
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/tags/set_sampling.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace gem5
+{
+
+SetSamplingEstimator::SetSamplingEstimator(unsigned num_sampled_sets,
+                                           unsigned _sampling)
+    : sampling(_sampling), setAccesses(num_sampled_sets, 0),
+      setMisses(num_sampled_sets, 0), recentHits(0), recentAccesses(0),
+      hitCredit(0)
+{
+    assert(sampling > 0);
+}
+
+void
+SetSamplingEstimator::sample(unsigned set, bool hit)
+{
+    assert(set < setAccesses.size());
+    setAccesses[set]++;
+    if (hit)
+        recentHits++;
+    else
+        setMisses[set]++;
+
+    if (++recentAccesses >= predictorWindow) {
+        recentHits /= 2;
+        recentAccesses /= 2;
+    }
+}
+
+bool
+SetSamplingEstimator::predict()
+{
+    if (recentAccesses > 0)
+        hitCredit += recentHits / recentAccesses;
+    if (hitCredit >= 1) {
+        hitCredit -= 1;
+        return true;
+    }
+    return false;
+}
+
+double
+SetSamplingEstimator::missRate() const
+{
+    uint64_t accesses = 0;
+    uint64_t misses = 0;
+    for (size_t i = 0; i < setAccesses.size(); i++) {
+        accesses += setAccesses[i];
+        misses += setMisses[i];
+    }
+    return accesses ? double(misses) / accesses : 0;
+}
+
+double
+SetSamplingEstimator::missRateError() const
+{
+    // The variance of a ratio estimator over a sample of clusters is
+    // computed from the deviation of each set from the ratio, with the
+    // finite population correction for the fraction of sets modeled
+    const size_t n = setAccesses.size();
+    double accesses = 0;
+    for (size_t i = 0; i < n; i++)
+        accesses += setAccesses[i];
+    if (n < 2 || accesses == 0)
+        return 0;
+
+    const double miss_rate = missRate();
+    double squares = 0;
+    for (size_t i = 0; i < n; i++) {
+        const double deviation = setMisses[i] - miss_rate * setAccesses[i];
+        squares += deviation * deviation;
+    }
+
+    const double mean = accesses / n;
+    const double variance = (1.0 - 1.0 / sampling) * squares /
+        ((n - 1) * n * mean * mean);
+    return 1.96 * std::sqrt(variance);
+}
+
+void
+SetSamplingEstimator::reset()
+{
+    std::fill(setAccesses.begin(), setAccesses.end(), 0);
+    std::fill(setMisses.begin(), setMisses.end(), 0);
+}
+
+} // namespace gem5
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_CACHE_TAGS_SET_SAMPLING_HH__
+#define __MEM_CACHE_TAGS_SET_SAMPLING_HH__
+
+#include <cstdint>
+#include <vector>
+
+namespace gem5
+{
+
+/**
+ * Estimates the hit and miss rates of a whole cache from a sample of
+ * its sets. The accesses to the modeled sets are counted per set, as
+ * clusters of a cluster sample, so that the confidence interval of the
+ * miss rate (a ratio estimator) accounts for the variation between
+ * sets. They also train a hit rate predictor over a decaying window of
+ * recent accesses, which decides the outcome of the accesses to the
+ * sets that are not modeled.
+ */
+class SetSamplingEstimator
+{
+  public:
+    /** Number of recent accesses the predictor follows. */
+    static constexpr double predictorWindow = 4096;
+
+    /**
+     * @param num_sampled_sets Number of modeled sets.
+     * @param sampling One in this many sets is modeled.
+     */
+    SetSamplingEstimator(unsigned num_sampled_sets, unsigned sampling);
+
+    /**
+     * Account for an access to a modeled set.
+     *
+     * @param set The index of the set among the modeled ones.
+     * @param hit Whether the access hit.
+     */
+    void sample(unsigned set, bool hit);
+
+    /**
+     * Predict the outcome of an access to a set that is not modeled.
+     * A hit is predicted each time the recent hit rate adds up to a
+     * whole hit, so the prediction is deterministic.
+     *
+     * @return Whether the access is predicted to hit.
+     */
+    bool predict();
+
+    /** Miss rate of the modeled sets. */
+    double missRate() const;
+
+    /** Half width of the 95% confidence interval of missRate(). */
+    double missRateError() const;
+
+    /** Forget the per set counts, but keep training the predictor. */
+    void reset();
+
+  private:
+    /** One in this many sets is modeled. */
+    const unsigned sampling;
+
+    /** Number of sampled accesses to each modeled set. */
+    std::vector<uint64_t> setAccesses;
+    /** Number of sampled misses in each modeled set. */
+    std::vector<uint64_t> setMisses;
+
+    /**
+     * Hits and accesses of the modeled sets, both halved every
+     * predictorWindow accesses so that the predictor follows program
+     * phases.
+     */
+    double recentHits;
+    double recentAccesses;
+
+    /** Fraction of a hit carried over between predictions. */
+    double hitCredit;
+};
+
+} // namespace gem5
+
+#endif //__MEM_CACHE_TAGS_SET_SAMPLING_HH__
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "mem/cache/tags/set_sampling.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** A set associative LRU cache, modeling all of its sets. */
+class LRUCache
+{
+  public:
+    LRUCache(unsigned num_sets, unsigned assoc)
+        : numSets(num_sets), assoc(assoc), sets(num_sets)
+    {}
+
+    /** Access a line, returning whether it hit. */
+    bool
+    access(uint64_t line)
+    {
+        auto &set = sets[line % numSets];
+        auto it = std::find(set.begin(), set.end(), line);
+        const bool hit = it != set.end();
+        if (hit)
+            set.erase(it);
+        else if (set.size() == assoc)
+            set.erase(set.begin());
+        set.push_back(line);
+        return hit;
+    }
+
+    const unsigned numSets;
+    const unsigned assoc;
+
+  private:
+    /** The lines of each set, from least to most recently used. */
+    std::vector<std::vector<uint64_t>> sets;
+};
+
+/** A trace of lines with a hot and a cold region, and some streaming. */
+std::vector<uint64_t>
+makeTrace(unsigned seed, size_t length)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint64_t> trace;
+    for (size_t i = 0; i < length; i++) {
+        switch (rng() % 4) {
+          case 0:
+          case 1:
+            trace.push_back(rng() % 512);
+            break;
+          case 2:
+            trace.push_back(rng() % 8192);
+            break;
+          default:
+            trace.push_back(1000000 + i);
+        }
+    }
+    return trace;
+}
+
+} // anonymous namespace
+
+/** Sets that all behave the same give the exact miss rate. */
+TEST(SetSamplingEstimatorTest, UniformSets)
+{
+    SetSamplingEstimator estimator(4, 8);
+    for (int i = 0; i < 100; i++) {
+        for (unsigned set = 0; set < 4; set++)
+            estimator.sample(set, i % 4 != 0);
+    }
+    EXPECT_DOUBLE_EQ(estimator.missRate(), 0.25);
+    EXPECT_DOUBLE_EQ(estimator.missRateError(), 0);
+
+    estimator.reset();
+    EXPECT_EQ(estimator.missRate(), 0);
+    EXPECT_EQ(estimator.missRateError(), 0);
+}
+
+/** The predictor hits at the recent hit rate of the modeled sets. */
+TEST(SetSamplingEstimatorTest, Predict)
+{
+    SetSamplingEstimator estimator(2, 4);
+
+    // Nothing is predicted to hit before anything was sampled
+    EXPECT_FALSE(estimator.predict());
+
+    for (int i = 0; i < 1000; i++)
+        estimator.sample(i % 2, i % 4 == 0);
+    int hits = 0;
+    for (int i = 0; i < 1000; i++)
+        hits += estimator.predict();
+    EXPECT_EQ(hits, 250);
+}
+
+/**
+ * The miss rate estimated from one in eight sets of a cache running a
+ * known trace is within its confidence interval of the miss rate of a
+ * full run of the same trace, for most traces.
+ */
+TEST(SetSamplingEstimatorTest, MatchesFullRun)
+{
+    const unsigned sampling = 8;
+    const int num_traces = 20;
+    int covered = 0;
+
+    for (int seed = 1; seed <= num_traces; seed++) {
+        LRUCache cache(256, 4);
+        const unsigned num_sampled_sets = cache.numSets / sampling;
+        SetSamplingEstimator estimator(num_sampled_sets, sampling);
+
+        uint64_t misses = 0;
+        const auto trace = makeTrace(seed, 200000);
+        for (auto line : trace) {
+            const bool hit = cache.access(line);
+            misses += !hit;
+
+            // The modeled sets are those with the upper index bits clear
+            const unsigned set = line % cache.numSets;
+            if (set < num_sampled_sets)
+                estimator.sample(set, hit);
+        }
+
+        const double full_miss_rate = double(misses) / trace.size();
+        const double error = estimator.missRateError();
+        EXPECT_GT(error, 0) << seed;
+        EXPECT_LT(error, 0.02) << seed;
+        if (std::abs(estimator.missRate() - full_miss_rate) <= error)
+            covered++;
+    }
+
+    // A 95% confidence interval may miss now and then
+    EXPECT_GE(covered, num_traces - 3);
+}
@@ -305,6 +305,9 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
     if (snoopFilter && snoop_caches) {
         // Let the snoop filter know about the success of the send operation
         snoopFilter->finishRequest(!success, addr, pkt->isSecure());
+
+        // the lookup may have replaced lines, even if we retry
+        sendBackInvalidations(true);
     }
 
     // check if we were successful in sending the packet onwards
@@ -724,6 +727,38 @@ CoherentXBar::forwardTiming(PacketPtr pkt, PortID exclude_cpu_side_port_id,
     snoopFanout.sample(fanout);
 }
 
+void
+CoherentXBar::sendBackInvalidations(bool is_timing)
+{
+    for (const auto &back_inv : snoopFilter->takeBackInvalidations()) {
+        Request::Flags flags = Request::CLEAN | Request::INVALIDATE;
+        if (back_inv.isSecure)
+            flags.set(Request::SECURE);
+        RequestPtr req = Request::make(
+            back_inv.addr, system->cacheLineSize(), flags,
+            snoopFilter->backInvalidateRequestorId());
+
+        // the caches do not respond, dirty lines are written back
+        // below as WriteCleans, and anything they defer is copied
+        Packet pkt(req, MemCmd::BackInvalidateReq);
+        pkt.setExpressSnoop();
+
+        DPRINTF(CoherentXBar, "%s: %s to %d ports\n", __func__,
+                pkt.print(), back_inv.ports.size());
+
+        for (const auto &p : back_inv.ports) {
+            if (is_timing)
+                p->sendTimingSnoopReq(&pkt);
+            else
+                p->sendAtomicSnoop(&pkt);
+            assert(!pkt.cacheResponding());
+        }
+
+        snoops += back_inv.ports.size();
+        transDist[pkt.cmdToIndex()]++;
+    }
+}
+
 void
 CoherentXBar::recvReqRetry(PortID mem_side_port_id)
 {
@@ -772,6 +807,7 @@ CoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
             // avoid situations where atomic upward snoops sneak in
             // between and change the filter state
             snoopFilter->finishRequest(false, pkt->getAddr(), pkt->isSecure());
+            sendBackInvalidations(false);
 
             if (pkt->isEviction()) {
                 // for block-evicting packets, i.e. writebacks and
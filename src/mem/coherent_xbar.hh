@@ -370,6 +370,14 @@ class CoherentXBar : public BaseXBar
                                           const std::vector<QueuedResponsePort*>&
                                           dests);
 
+    /**
+     * Clean and invalidate the lines replaced by the snoop filter in
+     * the caches above that may still hold them.
+     *
+     * @param is_timing Whether to send timing or atomic snoops
+     */
+    void sendBackInvalidations(bool is_timing);
+
     /** Function called by the port when the crossbar is receiving a Functional
         transaction.*/
     void recvFunctional(PacketPtr pkt, PortID cpu_side_port_id);
@@ -233,6 +233,11 @@ MemCmd::commandInfo[] =
     { {IsRead, IsResponse}, InvalidCmd, "HTMReqResp" },
     { {IsRead, IsRequest}, InvalidCmd, "HTMAbort" },
     { {IsRequest}, InvalidCmd, "TlbiExtSync" },
+    /* Back-invalidation -- Clean and invalidate all copies above a
+       snoop filter that stopped tracking the block. Unlike a
+       CleanInvalidReq it is never responded to, dirty data is written
+       back below instead. */
+    { {IsRequest, IsInvalidate, IsClean}, InvalidCmd, "BackInvalidateReq" },
 };
 
 AddrRange
@@ -51,12 +51,15 @@
 #include <cassert>
 #include <initializer_list>
 #include <list>
+#include <new>
+#include <utility>
 
 #include "base/addr_range.hh"
 #include "base/cast.hh"
 #include "base/compiler.hh"
 #include "base/flags.hh"
 #include "base/logging.hh"
+#include "base/pool_alloc.hh"
 #include "base/printable.hh"
 #include "base/types.hh"
 #include "mem/htm.hh"
@@ -146,6 +149,8 @@ class MemCmd
         HTMAbort,
         // Tlb shootdown
         TlbiExtSync,
+        // Snoop filter back-invalidation
+        BackInvalidateReq,
         NUM_MEM_CMDS
     };
 
@@ -350,6 +355,9 @@ class Packet : public Printable
         /// the packet is destroyed. The pointer is assumed to be pointing
         /// to an array, and delete [] is consequently called
         DYNAMIC_DATA           = 0x00002000,
+        /// The dynamic data was allocated by allocate() from the
+        /// packet data buffer pool, and is returned to it instead
+        POOLED_DATA            = 0x00004000,
 
         /// suppress the error if this packet encounters a functional
         /// access failure.
@@ -1019,15 +1027,52 @@ class Packet : public Printable
     static PacketPtr
     createRead(const RequestPtr &req)
     {
-        return new Packet(req, makeReadCmd(req));
+        return make(req, makeReadCmd(req));
     }
 
     static PacketPtr
     createWrite(const RequestPtr &req)
     {
-        return new Packet(req, makeWriteCmd(req));
+        return make(req, makeWriteCmd(req));
     }
 
+    /**
+     * Create a new packet, forwarding the arguments to one of the
+     * constructors. This is equivalent to new Packet(...), packets
+     * being allocated from a per-thread pool in either case, and the
+     * packet is freed with delete as usual.
+     */
+    template <typename... Args>
+    static PacketPtr
+    make(Args&&... args)
+    {
+        return new Packet(std::forward<Args>(args)...);
+    }
+
+    /** @{ */
+    /**
+     * Packets are allocated and freed at a very high rate, so they are
+     * recycled through a per-thread pool rather than going through the
+     * general purpose allocator every time.
+     */
+    static void *
+    operator new(std::size_t size)
+    {
+        if (size != sizeof(Packet))
+            return ::operator new(size);
+        return FixedSizePool<sizeof(Packet)>::allocate();
+    }
+
+    static void
+    operator delete(void *p, std::size_t size)
+    {
+        if (size != sizeof(Packet))
+            ::operator delete(p);
+        else
+            FixedSizePool<sizeof(Packet)>::deallocate(p);
+    }
+    /** @} */
+
     /**
      * clean up packet variables
      */
@@ -1327,10 +1372,12 @@ class Packet : public Printable
     void
     deleteData()
     {
-        if (flags.isSet(DYNAMIC_DATA))
+        if (flags.isSet(POOLED_DATA))
+            buffer_pool::deallocate(data, getSize());
+        else if (flags.isSet(DYNAMIC_DATA))
             delete [] data;
 
-        flags.clear(STATIC_DATA|DYNAMIC_DATA);
+        flags.clear(STATIC_DATA|DYNAMIC_DATA|POOLED_DATA);
         data = NULL;
     }
 
@@ -1342,8 +1389,9 @@ class Packet : public Printable
         // payload, actually allocate space
         if (hasData() || hasRespData()) {
             assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
-            flags.set(DYNAMIC_DATA);
-            data = new uint8_t[getSize()];
+            flags.set(DYNAMIC_DATA|POOLED_DATA);
+            data = static_cast<PacketDataPtr>(
+                buffer_pool::allocate(getSize()));
         }
     }
 
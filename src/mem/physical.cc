@@ -39,17 +39,22 @@
 
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/user.h>
 #include <unistd.h>
 #include <zlib.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <climits>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 
+#include "base/atomicio.hh"
 #include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
@@ -76,14 +81,41 @@ namespace gem5
 namespace memory
 {
 
+namespace
+{
+
+/**
+ * Get the absolute path of a checkpoint directory, so that references
+ * to it don't depend on the directory gem5 was run from.
+ */
+std::string
+canonicalDir(const std::string &dir)
+{
+    char *path = realpath(dir.c_str(), nullptr);
+    if (path == nullptr)
+        fatal("Can't resolve checkpoint directory '%s': %s\n",
+              dir, strerror(errno));
+    std::string canonical(path);
+    free(path);
+    return canonical;
+}
+
+} // anonymous namespace
+
 PhysicalMemory::PhysicalMemory(const std::string& _name,
                                const std::vector<AbstractMemory*>& _memories,
                                bool mmap_using_noreserve,
                                const std::string& shared_backstore,
-                               bool auto_unlink_shared_backstore) :
+                               bool auto_unlink_shared_backstore,
+                               bool incremental_checkpoints,
+                               unsigned full_checkpoint_interval,
+                               bool mappable_checkpoints) :
     _name(_name), size(0), mmapUsingNoReserve(mmap_using_noreserve),
     sharedBackstore(shared_backstore), sharedBackstoreSize(0),
-    pageSize(sysconf(_SC_PAGE_SIZE))
+    pageSize(sysconf(_SC_PAGE_SIZE)),
+    incrementalCheckpoints(incremental_checkpoints),
+    fullCheckpointInterval(full_checkpoint_interval),
+    deltaCheckpoints(0), mappableCheckpoints(mappable_checkpoints)
 {
     // Register cleanup callback if requested.
     if (auto_unlink_shared_backstore && !sharedBackstore.empty()) {
@@ -267,6 +299,11 @@ PhysicalMemory::~PhysicalMemory()
     // unmap the backing store
     for (auto& s : backingStore)
         munmap((char*)s.pmem, s.range.size());
+
+    for (unsigned int i = 0; i < baseImages.size(); ++i) {
+        if (baseImages[i])
+            munmap(baseImages[i], backingStore[i].range.size());
+    }
 }
 
 bool
@@ -351,11 +388,31 @@ PhysicalMemory::serialize(CheckpointOut &cp) const
     unsigned int nbr_of_stores = backingStore.size();
     SERIALIZE_SCALAR(nbr_of_stores);
 
+    // only write the pages that changed if we know the checkpoint the
+    // memory was last written to, and the chain of deltas needed to
+    // restore it is not getting too long
+    const std::string cpt_dir = canonicalDir(CheckpointIn::dir());
+    const bool delta = incrementalCheckpoints &&
+        !parentCheckpoint.empty() && parentCheckpoint != cpt_dir &&
+        (fullCheckpointInterval == 0 ||
+         deltaCheckpoints < fullCheckpointInterval);
+
+    unsigned int delta_checkpoints = delta ? deltaCheckpoints + 1 : 0;
+    SERIALIZE_SCALAR(delta_checkpoints);
+
     unsigned int store_id = 0;
     // store each backing store memory segment in a file
     for (auto& s : backingStore) {
         ScopedCheckpointSection sec(cp, csprintf("store%d", store_id));
-        serializeStore(cp, store_id++, s.range, s.pmem);
+        if (delta)
+            serializeStoreDelta(cp, store_id++, s.range, s.pmem);
+        else
+            serializeStore(cp, store_id++, s.range, s.pmem);
+    }
+
+    if (incrementalCheckpoints) {
+        parentCheckpoint = cpt_dir;
+        deltaCheckpoints = delta_checkpoints;
     }
 }
 
@@ -365,9 +422,10 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
 {
     // we cannot use the address range for the name as the
     // memories that are not part of the address map can overlap
-    std::string filename =
-        name() + ".store" + std::to_string(store_id) + ".pmem";
+    std::string filename = name() + ".store" + std::to_string(store_id) +
+        (mappableCheckpoints ? ".img" : ".pmem");
     long range_size = range.size();
+    bool mappable = mappableCheckpoints;
 
     DPRINTF(Checkpoint, "Serializing physical memory %s with size %d\n",
             filename, range_size);
@@ -375,9 +433,17 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
     SERIALIZE_SCALAR(store_id);
     SERIALIZE_SCALAR(filename);
     SERIALIZE_SCALAR(range_size);
+    SERIALIZE_SCALAR(mappable);
 
     // write memory file
     std::string filepath = CheckpointIn::dir() + "/" + filename.c_str();
+    if (mappable) {
+        writeStoreImage(filename, filepath, range, pmem);
+        if (incrementalCheckpoints)
+            copyBaseImage(store_id);
+        return;
+    }
+
     gzFile compressed_mem = gzopen(filepath.c_str(), "wb");
     if (compressed_mem == NULL)
         fatal("Can't open physical memory checkpoint file '%s'\n",
@@ -404,6 +470,144 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
         fatal("Close failed on physical memory checkpoint file '%s'\n",
               filename);
 
+    // this image is the baseline for the next delta
+    if (incrementalCheckpoints)
+        copyBaseImage(store_id);
+}
+
+void
+PhysicalMemory::serializeStoreDelta(CheckpointOut &cp, unsigned int store_id,
+                                    AddrRange range, uint8_t* pmem) const
+{
+    assert(store_id < baseImages.size() && baseImages[store_id]);
+    uint8_t *base = baseImages[store_id];
+
+    std::string filename =
+        name() + ".store" + std::to_string(store_id) + ".delta";
+    long range_size = range.size();
+    uint64_t page_size = pageSize;
+
+    // refer to the parent relative to this checkpoint if they are
+    // in the same directory so that the pair can be moved together,
+    // and by its absolute path otherwise
+    const std::string cpt_dir = canonicalDir(CheckpointIn::dir());
+    const auto cpt_sep = cpt_dir.rfind('/') + 1;
+    const auto parent_sep = parentCheckpoint.rfind('/') + 1;
+    std::string parent = parentCheckpoint;
+    if (cpt_dir.compare(0, cpt_sep, parentCheckpoint, 0, parent_sep) == 0)
+        parent = "../" + parentCheckpoint.substr(parent_sep);
+
+    DPRINTF(Checkpoint, "Serializing physical memory %s as a delta of %s\n",
+            filename, parent);
+
+    SERIALIZE_SCALAR(store_id);
+    SERIALIZE_SCALAR(filename);
+    SERIALIZE_SCALAR(range_size);
+    SERIALIZE_SCALAR(parent);
+    SERIALIZE_SCALAR(page_size);
+
+    // write the changed pages, each preceded by its index
+    std::string filepath = CheckpointIn::dir() + "/" + filename.c_str();
+    gzFile compressed_mem = gzopen(filepath.c_str(), "wb");
+    if (compressed_mem == NULL)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filename);
+
+    const uint64_t num_pages = divCeil(range.size(), page_size);
+    uint64_t dirty_pages = 0;
+    for (uint64_t page = 0; page < num_pages; ++page) {
+        const uint64_t offset = page * page_size;
+        const unsigned int size =
+            std::min<uint64_t>(page_size, range.size() - offset);
+        if (std::memcmp(pmem + offset, base + offset, size) == 0)
+            continue;
+
+        std::memcpy(base + offset, pmem + offset, size);
+        ++dirty_pages;
+        if (gzwrite(compressed_mem, &page,
+                    sizeof(page)) != (int)sizeof(page) ||
+            gzwrite(compressed_mem, pmem + offset, size) != (int)size) {
+            fatal("Write failed on physical memory checkpoint file '%s'\n",
+                  filename);
+        }
+    }
+
+    if (gzclose(compressed_mem))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filename);
+
+    DPRINTF(Checkpoint, "Wrote %d of %d pages\n", dirty_pages, num_pages);
+    SERIALIZE_SCALAR(dirty_pages);
+}
+
+void
+PhysicalMemory::writeStoreImage(const std::string &filename,
+                                const std::string &filepath,
+                                AddrRange range, const uint8_t* pmem) const
+{
+    // the image might be the one the store is mapped from when
+    // checkpointing into the directory that was restored, so write a
+    // new file and rename it over the old one rather than truncating
+    // the mapped file
+    const std::string tmppath = filepath + ".tmp";
+    int fd = open(tmppath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0664);
+    if (fd == -1)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filename);
+
+    // skip the pages that are all zeros, which most file systems then
+    // store as holes, as a sparse memory would otherwise make a file
+    // as large as the memory itself
+    for (uint64_t offset = 0; offset < range.size(); offset += pageSize) {
+        const size_t size = std::min<uint64_t>(pageSize,
+                                               range.size() - offset);
+        const uint8_t *page = pmem + offset;
+        if (page[0] == 0 && std::memcmp(page, page + 1, size - 1) == 0)
+            continue;
+
+        if (lseek(fd, offset, SEEK_SET) == (off_t)-1 ||
+            atomic_write(fd, page, size) != (ssize_t)size) {
+            fatal("Write failed on physical memory checkpoint file '%s'\n",
+                  filename);
+        }
+    }
+
+    if (ftruncate(fd, range.size()) == -1 || close(fd) == -1)
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filename);
+
+    if (std::rename(tmppath.c_str(), filepath.c_str()) == -1)
+        fatal("Can't rename physical memory checkpoint file '%s': %s\n",
+              filename, strerror(errno));
+}
+
+void
+PhysicalMemory::copyBaseImage(unsigned int store_id) const
+{
+    const BackingStoreEntry &s = backingStore[store_id];
+    const uint64_t store_size = s.range.size();
+
+    baseImages.resize(backingStore.size(), nullptr);
+    uint8_t *&base = baseImages[store_id];
+    if (!base) {
+        base = (uint8_t*)mmap(NULL, store_size, PROT_READ | PROT_WRITE,
+                              MAP_ANON | MAP_PRIVATE | MAP_NORESERVE,
+                              -1, 0);
+        if (base == (uint8_t*)MAP_FAILED) {
+            base = nullptr;
+            fatal("Could not map %d bytes for the delta checkpoints of %s: "
+                  "%s\n", store_size, name(), strerror(errno));
+        }
+    }
+
+    // only write the pages that differ, so that the pages that stay
+    // all zeros are never backed by host memory
+    for (uint64_t offset = 0; offset < store_size; offset += pageSize) {
+        const size_t size = std::min<uint64_t>(pageSize,
+                                               store_size - offset);
+        if (std::memcmp(s.pmem + offset, base + offset, size) != 0)
+            std::memcpy(base + offset, s.pmem + offset, size);
+    }
 }
 
 void
@@ -429,6 +633,16 @@ PhysicalMemory::unserialize(CheckpointIn &cp)
         unserializeStore(cp);
     }
 
+    // the restored checkpoint is the parent of the next delta
+    if (incrementalCheckpoints) {
+        unsigned int delta_checkpoints = 0;
+        UNSERIALIZE_OPT_SCALAR(delta_checkpoints);
+
+        parentCheckpoint = canonicalDir(cp.getCptDir());
+        deltaCheckpoints = delta_checkpoints;
+        for (unsigned int i = 0; i < backingStore.size(); ++i)
+            copyBaseImage(i);
+    }
 }
 
 void
@@ -443,6 +657,41 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(filename);
     std::string filepath = cp.getCptDir() + "/" + filename;
 
+    // a delta only holds the pages that changed since its parent,
+    // so restore the parent first
+    std::string parent;
+    if (UNSERIALIZE_OPT_SCALAR(parent) && !parent.empty()) {
+        std::string parent_dir = parent.front() == '/' ?
+            parent : cp.getCptDir() + "/" + parent;
+        DPRINTF(Checkpoint, "Restoring parent checkpoint %s of %s\n",
+                parent_dir, filename);
+
+        // opening a checkpoint changes the current checkpoint
+        // directory, which other objects may still rely on
+        const std::string cpt_dir = CheckpointIn::dir();
+        {
+            CheckpointIn parent_cp(parent_dir);
+            unserializeStore(parent_cp);
+        }
+        CheckpointIn::setDir(cpt_dir);
+
+        unserializeStoreDelta(cp, store_id, filename);
+        return;
+    }
+
+    bool mappable = false;
+    UNSERIALIZE_OPT_SCALAR(mappable);
+    if (mappable) {
+        long range_size;
+        UNSERIALIZE_SCALAR(range_size);
+        if (range_size != backingStore[store_id].range.size())
+            fatal("Memory range size has changed! Saw %lld, expected %lld\n",
+                  range_size, backingStore[store_id].range.size());
+
+        unserializeStoreImage(store_id, filename, filepath);
+        return;
+    }
+
     // mmap memoryfile
     gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
     if (compressed_mem == NULL)
@@ -491,5 +740,102 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
               filename);
 }
 
+void
+PhysicalMemory::unserializeStoreImage(unsigned int store_id,
+                                      const std::string &filename,
+                                      const std::string &filepath)
+{
+    const BackingStoreEntry &s = backingStore[store_id];
+
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd == -1)
+        fatal("Can't open physical memory checkpoint file '%s'", filename);
+
+    // touching a mapped page past the end of the file faults, so make
+    // sure the image covers the whole store
+    struct stat st;
+    if (fstat(fd, &st) == -1 || st.st_size != (off_t)s.range.size())
+        fatal("Physical memory checkpoint file '%s' does not match the "
+              "size of the memory\n", filename);
+
+    if (s.shmFd != -1) {
+        // other processes expect to see this memory in the shared
+        // backstore, so copy the image into it instead
+        DPRINTF(Checkpoint, "Reading physical memory %s into the shared "
+                "backstore\n", filename);
+        if (atomic_read(fd, s.pmem, s.range.size()) !=
+            (ssize_t)s.range.size()) {
+            fatal("Read failed on physical memory checkpoint file '%s'\n",
+                  filename);
+        }
+    } else {
+        DPRINTF(Checkpoint, "Mapping physical memory %s\n", filename);
+
+        // replace the anonymous mapping at the same address so that
+        // the memories and any KVM slots still point to the store
+        int map_flags = MAP_PRIVATE | MAP_FIXED;
+        if (mmapUsingNoReserve)
+            map_flags |= MAP_NORESERVE;
+
+        if (mmap(s.pmem, s.range.size(), PROT_READ | PROT_WRITE, map_flags,
+                 fd, 0) == (void *)MAP_FAILED) {
+            fatal("Could not map physical memory checkpoint file '%s': %s\n",
+                  filename, strerror(errno));
+        }
+    }
+
+    // the mapping holds its own reference to the file
+    close(fd);
+}
+
+void
+PhysicalMemory::unserializeStoreDelta(CheckpointIn &cp, unsigned int store_id,
+                                      const std::string &filename)
+{
+    uint8_t* pmem = backingStore[store_id].pmem;
+    AddrRange range = backingStore[store_id].range;
+
+    long range_size;
+    UNSERIALIZE_SCALAR(range_size);
+    uint64_t page_size;
+    UNSERIALIZE_SCALAR(page_size);
+    uint64_t dirty_pages;
+    UNSERIALIZE_SCALAR(dirty_pages);
+
+    DPRINTF(Checkpoint, "Unserializing %d pages of physical memory %s\n",
+            dirty_pages, filename);
+
+    if (range_size != range.size())
+        fatal("Memory range size has changed! Saw %lld, expected %lld\n",
+              range_size, range.size());
+
+    std::string filepath = cp.getCptDir() + "/" + filename;
+    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
+    if (compressed_mem == NULL)
+        fatal("Can't open physical memory checkpoint file '%s'", filename);
+
+    for (uint64_t i = 0; i < dirty_pages; ++i) {
+        uint64_t page;
+        if (gzread(compressed_mem, &page, sizeof(page)) != (int)sizeof(page))
+            fatal("Read failed on physical memory checkpoint file '%s'\n",
+                  filename);
+
+        const uint64_t offset = page * page_size;
+        if (offset >= range.size())
+            fatal("Page %d out of range in checkpoint file '%s'\n",
+                  page, filename);
+
+        const unsigned int size =
+            std::min<uint64_t>(page_size, range.size() - offset);
+        if (gzread(compressed_mem, pmem + offset, size) != (int)size)
+            fatal("Read failed on physical memory checkpoint file '%s'\n",
+                  filename);
+    }
+
+    if (gzclose(compressed_mem))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filename);
+}
+
 } // namespace memory
 } // namespace gem5
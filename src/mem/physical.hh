@@ -162,6 +162,33 @@ class PhysicalMemory : public Serializable
     // system
     std::vector<BackingStoreEntry> backingStore;
 
+    // Write checkpoints of the backing store as deltas that only
+    // hold the pages changed since the previous checkpoint
+    const bool incrementalCheckpoints;
+
+    // Write a full image after this many delta checkpoints, 0 to
+    // only write a full image the first time
+    const unsigned fullCheckpointInterval;
+
+    // Absolute path of the checkpoint the backing store was last
+    // written to or restored from, used as the parent of the next
+    // delta checkpoint
+    mutable std::string parentCheckpoint;
+
+    // Number of delta checkpoints since the last full image
+    mutable unsigned deltaCheckpoints;
+
+    // Write full checkpoints of the backing store as uncompressed
+    // images that are mapped copy-on-write when restoring
+    const bool mappableCheckpoints;
+
+    // Copy of each backing store at the time of the parent
+    // checkpoint, compared page by page with the store to find the
+    // pages that changed. The copies are mapped without reserving
+    // swap and the pages that are all zeros are never written, so
+    // they only take host memory for the pages that are not
+    mutable std::vector<uint8_t*> baseImages;
+
     // Prevent copying
     PhysicalMemory(const PhysicalMemory&);
 
@@ -191,7 +218,10 @@ class PhysicalMemory : public Serializable
                    const std::vector<AbstractMemory*>& _memories,
                    bool mmap_using_noreserve,
                    const std::string& shared_backstore,
-                   bool auto_unlink_shared_backstore);
+                   bool auto_unlink_shared_backstore,
+                   bool incremental_checkpoints = false,
+                   unsigned full_checkpoint_interval = 0,
+                   bool mappable_checkpoints = false);
 
     /**
      * Unmap all the backing store we have used.
@@ -284,6 +314,17 @@ class PhysicalMemory : public Serializable
     void serializeStore(CheckpointOut &cp, unsigned int store_id,
                         AddrRange range, uint8_t* pmem) const;
 
+    /**
+     * Serialize the pages of a specific store that changed since the
+     * parent checkpoint, along with a reference to the parent.
+     *
+     * @param store_id Unique identifier of this backing store
+     * @param range The address range of this backing store
+     * @param pmem The host pointer to this backing store
+     */
+    void serializeStoreDelta(CheckpointOut &cp, unsigned int store_id,
+                             AddrRange range, uint8_t* pmem) const;
+
     /**
      * Unserialize the memories in the system. As with the
      * serialization, this action is independent of how the address
@@ -293,9 +334,42 @@ class PhysicalMemory : public Serializable
 
     /**
      * Unserialize a specific backing store, identified by a section.
+     * If the store was checkpointed as a delta, the parent
+     * checkpoints are restored first.
      */
     void unserializeStore(CheckpointIn &cp);
 
+    /**
+     * Apply the pages of a delta checkpoint of a specific store on
+     * top of its restored parent.
+     */
+    void unserializeStoreDelta(CheckpointIn &cp, unsigned int store_id,
+                               const std::string &filename);
+
+    /**
+     * Map an uncompressed image of a specific store copy-on-write in
+     * place of its backing store, so that pages are only read from
+     * the image when first touched.
+     */
+    void unserializeStoreImage(unsigned int store_id,
+                               const std::string &filename,
+                               const std::string &filepath);
+
+  private:
+    /**
+     * Write an uncompressed image of a store, leaving holes for the
+     * pages that are all zeros.
+     */
+    void writeStoreImage(const std::string &filename,
+                         const std::string &filepath,
+                         AddrRange range, const uint8_t* pmem) const;
+
+    /**
+     * Copy a store as the baseline for the next delta checkpoint,
+     * only writing the pages of the copy that differ.
+     */
+    void copyBaseImage(unsigned int store_id) const;
+
 };
 
 } // namespace memory
@@ -61,7 +61,7 @@ PortProxy::readBlobPhys(Addr addr, Request::Flags flags,
     for (ChunkGenerator gen(addr, size, _cacheLineSize); !gen.done();
          gen.next()) {
 
-        auto req = std::make_shared<Request>(
+        auto req = Request::make(
             gen.addr(), gen.size(), flags, Request::funcRequestorId);
 
         Packet pkt(req, MemCmd::ReadReq);
@@ -78,7 +78,7 @@ PortProxy::writeBlobPhys(Addr addr, Request::Flags flags,
     for (ChunkGenerator gen(addr, size, _cacheLineSize); !gen.done();
          gen.next()) {
 
-        auto req = std::make_shared<Request>(
+        auto req = Request::make(
             gen.addr(), gen.size(), flags, Request::funcRequestorId);
 
         Packet pkt(req, MemCmd::WriteReq);
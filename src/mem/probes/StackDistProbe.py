@@ -60,3 +60,14 @@ class StackDistProbe(BaseMemProbe):
     # logarithmic histogram bins and enable/disable
     log_hist_bins = Param.Unsigned('32', "Bins in logarithmic histograms")
     disable_log_hists = Param.Bool(False, "Disable logarithmic histograms")
+
+    # Track only one line in 2^sample_shift, as in SHARDS, to bound the
+    # time and memory spent at the cost of accuracy
+    sample_shift = Param.Unsigned(0, "Log2 of the line sampling ratio")
+
+    # Miss ratio curves, for LRU caches of 1 to 2^(mrc_sizes - 1) lines
+    mrc_sizes = Param.Unsigned(24, "Number of cache sizes in the miss ratio "
+                               "curves")
+    mrc_assoc = VectorParam.Unsigned([], "Associativities for which to "
+                                     "approximate set associative miss "
+                                     "ratio curves")
@@ -37,6 +37,11 @@
 
 #include "mem/probes/stack_dist.hh"
 
+#include <algorithm>
+#include <string>
+
+#include "base/cprintf.hh"
+#include "base/intmath.hh"
 #include "params/StackDistProbe.hh"
 #include "sim/system.hh"
 
@@ -48,17 +53,26 @@ StackDistProbe::StackDistProbe(const StackDistProbeParams &p)
       lineSize(p.line_size),
       disableLinearHists(p.disable_linear_hists),
       disableLogHists(p.disable_log_hists),
+      verify(p.verify),
       calc(p.verify),
+      counter(p.sample_shift),
       stats(this)
 {
     fatal_if(p.system->cacheLineSize() > p.line_size,
              "The stack distance probe must use a cache line size that is "
              "larger or equal to the system's cahce line size.");
+    fatal_if(p.verify && p.sample_shift,
+             "The stack distance probe can't verify sampled distances.");
+    fatal_if(p.sample_shift >= 32,
+             "The stack distance probe can sample at most 1 in 2^31 lines.");
 }
 
 StackDistProbe::StackDistProbeStats::StackDistProbeStats(
     StackDistProbe *parent)
     : statistics::Group(parent),
+      mrcAssoc(dynamic_cast<const StackDistProbeParams &>(
+                   parent->params()).mrc_assoc),
+      distCounts(65, 0), infiniteCount(0),
       ADD_STAT(readLinearHist, statistics::units::Count::get(),
                "Reads linear distribution"),
       ADD_STAT(readLogHist, statistics::units::Ratio::get(),
@@ -68,13 +82,20 @@ StackDistProbe::StackDistProbeStats::StackDistProbeStats(
       ADD_STAT(writeLogHist, statistics::units::Ratio::get(),
                "Writes logarithmic distribution"),
       ADD_STAT(infiniteSD, statistics::units::Count::get(),
-               "Number of requests with infinite stack distance")
+               "Number of requests with infinite stack distance"),
+      ADD_STAT(missRatio, statistics::units::Ratio::get(),
+               "Miss ratio of fully-associative LRU caches, by size in "
+               "bytes")
 {
     using namespace statistics;
 
     const StackDistProbeParams &p =
         dynamic_cast<const StackDistProbeParams &>(parent->params());
 
+    fatal_if(p.mrc_sizes == 0 || p.mrc_sizes >= 64,
+             "The stack distance probe needs between 1 and 63 miss ratio "
+             "curve sizes.");
+
     readLinearHist
         .init(p.linear_hist_bins)
         .flags(parent->disableLinearHists ? nozero : pdf);
@@ -93,6 +114,87 @@ StackDistProbe::StackDistProbeStats::StackDistProbeStats(
 
     infiniteSD
         .flags(nozero);
+
+    missRatio.init(p.mrc_sizes);
+    for (unsigned i = 0; i < p.mrc_sizes; ++i)
+        missRatio.subname(i, std::to_string(uint64_t(p.line_size) << i));
+
+    for (auto assoc : mrcAssoc) {
+        fatal_if(assoc == 0, "Miss ratio curves need a non-zero "
+                 "associativity.");
+        assocMissRatio.emplace_back(new Vector(this,
+            csprintf("missRatio%dWay", assoc).c_str(), units::Ratio::get(),
+            csprintf("Approximate miss ratio of %d-way set associative "
+                     "LRU caches, by size in bytes", assoc).c_str()));
+        assocMissRatio.back()->init(p.mrc_sizes);
+        for (unsigned i = 0; i < p.mrc_sizes; ++i) {
+            assocMissRatio.back()->subname(i,
+                std::to_string(uint64_t(p.line_size) << i));
+        }
+    }
+}
+
+void
+StackDistProbe::StackDistProbeStats::sampleMissRatio(uint64_t stack_dist)
+{
+    if (stack_dist == StackDistCounter::Infinity)
+        ++infiniteCount;
+    else if (stack_dist == 0)
+        ++distCounts[0];
+    else
+        ++distCounts[floorLog2(stack_dist) + 1];
+}
+
+void
+StackDistProbe::StackDistProbeStats::resetStats()
+{
+    statistics::Group::resetStats();
+
+    std::fill(distCounts.begin(), distCounts.end(), 0);
+    infiniteCount = 0;
+}
+
+void
+StackDistProbe::StackDistProbeStats::preDumpStats()
+{
+    statistics::Group::preDumpStats();
+
+    uint64_t total = infiniteCount;
+    for (auto count : distCounts)
+        total += count;
+    if (total == 0)
+        return;
+
+    for (unsigned i = 0; i < missRatio.size(); ++i) {
+        // A fully-associative LRU cache of 2^i lines misses on the
+        // stack distances of at least 2^i
+        const uint64_t lines = 1ULL << i;
+        uint64_t misses = infiniteCount;
+        for (unsigned b = i + 1; b < distCounts.size(); ++b)
+            misses += distCounts[b];
+        missRatio[i] = double(misses) / total;
+
+        for (unsigned n = 0; n < mrcAssoc.size(); ++n) {
+            const unsigned assoc = mrcAssoc[n];
+            if (lines <= assoc) {
+                // A single set
+                (*assocMissRatio[n])[i] = double(misses) / total;
+                continue;
+            }
+
+            // Only the range of each stack distance is known, so use
+            // the middle of its range
+            double assoc_misses = infiniteCount;
+            for (unsigned b = 1; b < distCounts.size(); ++b) {
+                const double stack_dist =
+                    b == 1 ? 1 : 1.5 * (1ULL << (b - 1));
+                assoc_misses += distCounts[b] *
+                    StackDistCounter::setAssocMissProb(
+                        stack_dist, assoc, lines / assoc);
+            }
+            (*assocMissRatio[n])[i] = assoc_misses / total;
+        }
+    }
 }
 
 void
@@ -106,9 +208,21 @@ StackDistProbe::handleRequest(const probing::PacketInfo &pkt_info)
     // Align the address to a cache line size
     const Addr aligned_addr(roundDown(pkt_info.addr, lineSize));
 
+    // When sampling, only a subset of the lines is tracked
+    if (!counter.sampled(aligned_addr))
+        return;
+
     // Calculate the stack distance
-    const uint64_t sd(calc.calcStackDistAndUpdate(aligned_addr).first);
-    if (sd == StackDistCalc::Infinity) {
+    const uint64_t sd(counter.access(aligned_addr));
+    if (verify) {
+        const uint64_t ref_sd(
+            calc.calcStackDistAndUpdate(aligned_addr).first);
+        panic_if(sd != ref_sd, "Stack distance of %#x is %d, expected %d",
+                 aligned_addr, sd, ref_sd);
+    }
+
+    stats.sampleMissRatio(sd);
+    if (sd == StackDistCounter::Infinity) {
         stats.infiniteSD++;
         return;
     }
@@ -38,9 +38,13 @@
 #ifndef __MEM_PROBES_STACK_DIST_HH__
 #define __MEM_PROBES_STACK_DIST_HH__
 
+#include <memory>
+#include <vector>
+
 #include "mem/packet.hh"
 #include "mem/probes/base.hh"
 #include "mem/stack_dist_calc.hh"
+#include "mem/stack_dist_counter.hh"
 #include "sim/stats.hh"
 
 namespace gem5
@@ -66,13 +70,35 @@ class StackDistProbe : public BaseMemProbe
     // Disable the logarithmic histograms
     const bool disableLogHists;
 
+    // Check the stack distances against the reference calculator
+    const bool verify;
+
   protected:
+    // Reference calculator, only used when verifying
     StackDistCalc calc;
 
+    StackDistCounter counter;
+
     struct StackDistProbeStats : public statistics::Group
     {
         StackDistProbeStats(StackDistProbe* parent);
 
+        void resetStats() override;
+        void preDumpStats() override;
+
+        /** Count an access for the miss ratio curves. */
+        void sampleMissRatio(uint64_t stack_dist);
+
+        // Associativities of the set-associative miss ratio curves
+        const std::vector<unsigned> mrcAssoc;
+
+        // Accesses by stack distance: 0 and then powers of two, so
+        // entry i > 0 counts the distances in [2^(i-1), 2^i)
+        std::vector<uint64_t> distCounts;
+
+        // Accesses with an infinite stack distance
+        uint64_t infiniteCount;
+
         // Reads linear histogram
         statistics::Histogram readLinearHist;
 
@@ -87,6 +113,13 @@ class StackDistProbe : public BaseMemProbe
 
         // Writes logarithmic histogram
         statistics::Scalar infiniteSD;
+
+        // Miss ratio of fully-associative LRU caches of 2^i lines
+        statistics::Vector missRatio;
+
+        // Approximate miss ratios of set-associative LRU caches, one
+        // per associativity in mrcAssoc
+        std::vector<std::unique_ptr<statistics::Vector>> assocMissRatio;
     } stats;
 };
 
@@ -54,12 +54,15 @@
 #include <functional>
 #include <limits>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "base/amo.hh"
 #include "base/compiler.hh"
 #include "base/flags.hh"
+#include "base/pool_alloc.hh"
 #include "base/types.hh"
+#include "config/use_nonatomic_request_refcount.hh"
 #include "cpu/inst_seq.hh"
 #include "mem/htm.hh"
 #include "sim/cur_tick.hh"
@@ -91,7 +94,19 @@ class Packet;
 class Request;
 class ThreadContext;
 
+/**
+ * Requests are shared by all the packets and objects involved in a
+ * memory access. Single-threaded builds can drop the atomic updates of
+ * the reference counts with the USE_NONATOMIC_REQUEST_REFCOUNT option,
+ * which relies on the lock policies of libstdc++. A RequestPtr must
+ * then be created with Request::make() rather than std::make_shared().
+ */
+#if USE_NONATOMIC_REQUEST_REFCOUNT && defined(__GLIBCXX__)
+#define GEM5_NONATOMIC_REQUEST_REFCOUNT 1
+typedef std::__shared_ptr<Request, __gnu_cxx::_S_single> RequestPtr;
+#else
 typedef std::shared_ptr<Request> RequestPtr;
+#endif
 typedef uint16_t RequestorID;
 
 class Request
@@ -522,6 +537,24 @@ class Request
 
     ~Request() {}
 
+    /**
+     * Create a new request. The request and its reference counts are
+     * allocated as a single block from a per-thread pool, and the
+     * block is recycled when the last reference goes away.
+     */
+    template <typename... Args>
+    static RequestPtr
+    make(Args&&... args)
+    {
+#ifdef GEM5_NONATOMIC_REQUEST_REFCOUNT
+        return std::__allocate_shared<Request, __gnu_cxx::_S_single>(
+            PoolAllocator<Request>(), std::forward<Args>(args)...);
+#else
+        return std::allocate_shared<Request>(
+            PoolAllocator<Request>(), std::forward<Args>(args)...);
+#endif
+    }
+
     /**
      * Factory method for creating memory management requests, with
      * unspecified addr and size.
@@ -529,7 +562,7 @@ class Request
     static RequestPtr
     createMemManagement(Flags flags, RequestorID id)
     {
-        auto mgmt_req = std::make_shared<Request>();
+        auto mgmt_req = Request::make();
         mgmt_req->_flags.set(flags);
         mgmt_req->_requestorId = id;
         mgmt_req->_time = curTick();
@@ -611,8 +644,8 @@ class Request
         assert(hasVaddr());
         assert(!hasPaddr());
         assert(split_addr > _vaddr && split_addr < _vaddr + _size);
-        req1 = std::make_shared<Request>(*this);
-        req2 = std::make_shared<Request>(*this);
+        req1 = Request::make(*this);
+        req2 = Request::make(*this);
         req1->_size = split_addr - _vaddr;
         req2->_vaddr = split_addr;
         req2->_size = _size - req1->_size;
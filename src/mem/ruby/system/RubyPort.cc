@@ -500,7 +500,7 @@ RubyPort::ruby_stale_translation_callback(Addr txnId)
     // Allocate the invalidate request and packet on the stack, as it is
     // assumed they will not be modified or deleted by receivers.
     // TODO: should this really be using funcRequestorId?
-    auto request = std::make_shared<Request>(
+    auto request = Request::make(
         0, RubySystem::getBlockSizeBytes(), Request::TLBI_EXT_SYNC,
         Request::funcRequestorId);
     // Store the txnId in extraData instead of the address
@@ -704,7 +704,7 @@ RubyPort::ruby_eviction_callback(Addr address)
     // Allocate the invalidate request and packet on the stack, as it is
     // assumed they will not be modified or deleted by receivers.
     // TODO: should this really be using funcRequestorId?
-    auto request = std::make_shared<Request>(
+    auto request = Request::make(
         address, RubySystem::getBlockSizeBytes(), 0,
         Request::funcRequestorId);
 
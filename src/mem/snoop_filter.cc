@@ -52,15 +52,106 @@ namespace gem5
 
 const int SnoopFilter::SNOOP_MASK_SIZE;
 
-void
-SnoopFilter::eraseIfNullEntry(SnoopFilterCache::iterator& sf_it)
+SnoopFilter::SnoopFilter(const SnoopFilterParams &p) :
+    SimObject(p), linesize(p.system->cacheLineSize()),
+    lookupLatency(p.lookup_latency),
+    maxEntryCount(p.max_capacity / p.system->cacheLineSize()),
+    assoc(p.assoc), numSets(assoc ? maxEntryCount / assoc : 0),
+    sets(numSets, assoc, linesize), bloomFilter(p.bloom_filter),
+    backInvalidateId(assoc ? p.system->getRequestorId(this) :
+                     Request::invldRequestorId),
+    stats(this)
+{
+    fatal_if(assoc && (numSets == 0 || maxEntryCount % assoc),
+             "%s: capacity of %d lines is not a multiple of the "
+             "associativity %d\n", name(), maxEntryCount, assoc);
+}
+
+SnoopFilter::SnoopItem *
+SnoopFilter::findItem(Addr line_addr)
+{
+    if (bloomFilter && !bloomFilter->isSet(line_addr)) {
+        stats.bloomFiltered++;
+        return nullptr;
+    }
+
+    SnoopItem *sf_item = assoc ? sets.find(line_addr) : nullptr;
+
+    if (!sf_item && !cachedLocations.empty()) {
+        auto sf_it = cachedLocations.find(line_addr);
+        if (sf_it != cachedLocations.end())
+            sf_item = &sf_it->second;
+    }
+
+    if (bloomFilter && !sf_item)
+        stats.bloomFalsePositives++;
+
+    return sf_item;
+}
+
+SnoopFilter::SnoopItem *
+SnoopFilter::allocateItem(Addr line_addr)
 {
-    SnoopItem& sf_item = sf_it->second;
-    if ((sf_item.requested | sf_item.holder).none()) {
-        cachedLocations.erase(sf_it);
-        DPRINTF(SnoopFilter, "%s:   Removed SF entry.\n",
-                __func__);
+    if (bloomFilter)
+        bloomFilter->set(line_addr);
+
+    if (assoc) {
+        // Prefer an invalid way, and otherwise replace the least
+        // recently used line without requests in flight, as the
+        // responses still need to find their line
+        auto *victim = sets.findVictim(line_addr,
+            [](const SnoopItem &item) { return item.requested.none(); });
+
+        if (victim) {
+            if (victim->valid) {
+                DPRINTF(SnoopFilter, "%s:   replacing %#x SF value %x.%x\n",
+                        __func__, victim->lineAddr, victim->item.requested,
+                        victim->item.holder);
+                stats.replacements++;
+                if (victim->item.holder.any()) {
+                    stats.backInvalidations++;
+                    backInvalidations.push_back({
+                        victim->lineAddr & ~Addr(LineSecure),
+                        bool(victim->lineAddr & LineSecure),
+                        maskToPortList(victim->item.holder)});
+                }
+                if (bloomFilter)
+                    bloomFilter->unset(victim->lineAddr);
+            }
+
+            return sets.insert(victim, line_addr);
+        }
+
+        // All lines in the set have requests in flight
+        DPRINTF(SnoopFilter, "%s:   set full, overflowing\n", __func__);
+        stats.overflows++;
     }
+
+    return &cachedLocations.emplace(line_addr, SnoopItem()).first->second;
+}
+
+void
+SnoopFilter::eraseIfNullEntry(Addr line_addr, const SnoopItem *sf_item)
+{
+    if ((sf_item->requested | sf_item->holder).any())
+        return;
+
+    if (!assoc || !sets.erase(line_addr, sf_item))
+        cachedLocations.erase(line_addr);
+
+    if (bloomFilter)
+        bloomFilter->unset(line_addr);
+
+    DPRINTF(SnoopFilter, "%s:   Removed SF entry.\n",
+            __func__);
+}
+
+std::vector<SnoopFilter::BackInvalidation>
+SnoopFilter::takeBackInvalidations()
+{
+    std::vector<BackInvalidation> back_invalidations;
+    back_invalidations.swap(backInvalidations);
+    return back_invalidations;
 }
 
 std::pair<SnoopFilter::SnoopList, Cycles>
@@ -78,8 +169,9 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
         line_addr |= LineSecure;
     }
     SnoopMask req_port = portToMask(cpu_side_port);
-    reqLookupResult.it = cachedLocations.find(line_addr);
-    bool is_hit = (reqLookupResult.it != cachedLocations.end());
+    reqLookupResult.item = findItem(line_addr);
+    reqLookupResult.lineAddr = line_addr;
+    bool is_hit = (reqLookupResult.item != nullptr);
 
     // If the snoop filter has no entry, and we should not allocate,
     // do not create a new snoop filter entry, simply return a NULL
@@ -87,12 +179,19 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
     if (!is_hit && !allocate)
         return snoopDown(lookupLatency);
 
-    // If no hit in snoop filter create a new element and update iterator
+    // Evictions only miss if the line was back-invalidated after the
+    // sender had already evicted it, and there is nothing to track
+    if (!is_hit && cpkt->isEviction()) {
+        panic_if(!assoc, "requestor %x is not a holder :( no SF entry\n",
+                 req_port);
+        return snoopDown(lookupLatency);
+    }
+
+    // If no hit in snoop filter create a new element
     if (!is_hit) {
-        reqLookupResult.it =
-            cachedLocations.emplace(line_addr, SnoopItem()).first;
+        reqLookupResult.item = allocateItem(line_addr);
     }
-    SnoopItem& sf_item = reqLookupResult.it->second;
+    SnoopItem& sf_item = *reqLookupResult.item;
     SnoopMask interested = sf_item.holder | sf_item.requested;
 
     // Store unmodified value of snoop filter item in temp storage in
@@ -140,8 +239,10 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
         }
     } else { // if (!cpkt->needsResponse())
         assert(cpkt->isEviction());
-        // make sure that the sender actually had the line
-        panic_if((sf_item.holder & req_port).none(), "requestor %x is not a " \
+        // make sure that the sender actually had the line, unless it
+        // was back-invalidated and the line allocated again since
+        panic_if(!assoc && (sf_item.holder & req_port).none(),
+                 "requestor %x is not a " \
                  "holder :( SF value %x.%x\n", req_port,
                  sf_item.requested, sf_item.holder);
         // CleanEvicts and Writebacks -> the sender and all caches above
@@ -159,26 +260,27 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
 void
 SnoopFilter::finishRequest(bool will_retry, Addr addr, bool is_secure)
 {
-    if (reqLookupResult.it != cachedLocations.end()) {
+    if (reqLookupResult.item) {
         // since we rely on the caller, do a basic check to ensure
         // that finishRequest is being called following lookupRequest
         Addr line_addr = (addr & ~(Addr(linesize - 1)));
         if (is_secure) {
             line_addr |= LineSecure;
         }
-        assert(reqLookupResult.it->first == line_addr);
+        assert(reqLookupResult.lineAddr == line_addr);
         if (will_retry) {
             SnoopItem retry_item = reqLookupResult.retryItem;
             // Undo any changes made in lookupRequest to the snoop filter
             // entry if the request will come again. retryItem holds
             // the previous value of the snoopfilter entry.
-            reqLookupResult.it->second = retry_item;
+            *reqLookupResult.item = retry_item;
 
             DPRINTF(SnoopFilter, "%s:   restored SF value %x.%x\n",
                     __func__,  retry_item.requested, retry_item.holder);
         }
 
-        eraseIfNullEntry(reqLookupResult.it);
+        eraseIfNullEntry(line_addr, reqLookupResult.item);
+        reqLookupResult.item = nullptr;
     }
 }
 
@@ -193,8 +295,8 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = (sf_it != cachedLocations.end());
+    SnoopItem *sf_item = findItem(line_addr);
+    bool is_hit = (sf_item != nullptr);
 
     panic_if(!is_hit && (cachedLocations.size() >= maxEntryCount),
              "snoop filter exceeded capacity of %d cache blocks\n",
@@ -206,9 +308,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (!is_hit)
         return snoopDown(lookupLatency);
 
-    SnoopItem& sf_item = sf_it->second;
-
-    SnoopMask interested = (sf_item.holder | sf_item.requested);
+    SnoopMask interested = (sf_item->holder | sf_item->requested);
 
     stats.totSnoops++;
 
@@ -227,16 +327,16 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     assert(cpkt->isWriteback() || cpkt->req->isUncacheable() ||
            (cpkt->isInvalidate() == cpkt->needsWritable()) ||
            cpkt->req->isCacheMaintenance());
-    if (cpkt->isInvalidate() && sf_item.requested.none()) {
+    if (cpkt->isInvalidate() && sf_item->requested.none()) {
         // Early clear of the holder, if no other request is currently going on
         // @todo: This should possibly be updated even though we do not filter
         // upward snoops
         DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
-                __func__, sf_item.requested, sf_item.holder);
-        sf_item.holder = 0;
+                __func__, sf_item->requested, sf_item->holder);
+        sf_item->holder = 0;
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
-                __func__, sf_item.requested, sf_item.holder);
-        eraseIfNullEntry(sf_it);
+                __func__, sf_item->requested, sf_item->holder);
+        eraseIfNullEntry(line_addr, sf_item);
     }
 
     return snoopSelected(maskToPortList(interested), lookupLatency);
@@ -266,7 +366,11 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     }
     SnoopMask rsp_mask = portToMask(rsp_port);
     SnoopMask req_mask = portToMask(req_port);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    SnoopItem *sf_item_ptr = findItem(line_addr);
+    // The line has a request in flight and cannot have been replaced
+    panic_if(!sf_item_ptr, "SF missing line %#x for snoop response\n",
+             line_addr);
+    SnoopItem& sf_item = *sf_item_ptr;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -313,8 +417,8 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = sf_it != cachedLocations.end();
+    SnoopItem *sf_item = findItem(line_addr);
+    bool is_hit = sf_item != nullptr;
 
     // Nothing to do if it is not a hit
     if (!is_hit)
@@ -324,15 +428,13 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     // Modified state, and we know that there are no other copies, or
     // they will all be invalidated imminently
     if (!cpkt->hasSharers()) {
-        SnoopItem& sf_item = sf_it->second;
-
         DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
-                __func__, sf_item.requested, sf_item.holder);
-        sf_item.holder = 0;
+                __func__, sf_item->requested, sf_item->holder);
+        sf_item->holder = 0;
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
-                __func__, sf_item.requested, sf_item.holder);
+                __func__, sf_item->requested, sf_item->holder);
 
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_item);
     }
 }
 
@@ -355,12 +457,12 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    if (sf_it == cachedLocations.end())
+    SnoopItem *sf_item_ptr = findItem(line_addr);
+    if (!sf_item_ptr)
         return;
 
     SnoopMask response_mask = portToMask(cpu_side_port);
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = *sf_item_ptr;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -379,7 +481,7 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
         if (cpkt->isInvalidate()) {
             sf_item.holder &= ~response_mask;
         }
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, &sf_item);
     } else {
         // Any other response implies that a cache above will have the
         // block.
@@ -407,7 +509,19 @@ SnoopFilter::SnoopFilterStats::SnoopFilterStats(statistics::Group *parent)
                "holder of the requested data."),
       ADD_STAT(hitMultiSnoops, statistics::units::Count::get(),
                "Number of snoops hitting in the snoop filter with multiple "
-               "(>1) holders of the requested data.")
+               "(>1) holders of the requested data."),
+      ADD_STAT(replacements, statistics::units::Count::get(),
+               "Number of lines replaced in the set-associative storage."),
+      ADD_STAT(backInvalidations, statistics::units::Count::get(),
+               "Number of replaced lines back-invalidated in the caches "
+               "above."),
+      ADD_STAT(overflows, statistics::units::Count::get(),
+               "Number of lines that overflowed a set with all lines in "
+               "flight."),
+      ADD_STAT(bloomFiltered, statistics::units::Count::get(),
+               "Number of lookups the Bloom filter showed to miss."),
+      ADD_STAT(bloomFalsePositives, statistics::units::Count::get(),
+               "Number of lookups that passed the Bloom filter and missed.")
 {}
 
 void
@@ -46,10 +46,13 @@
 #include <bitset>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "base/filters/multi_bit_sel_bloom_filter.hh"
 #include "mem/packet.hh"
 #include "mem/port.hh"
 #include "mem/qport.hh"
+#include "mem/snoop_filter_sets.hh"
 #include "params/SnoopFilter.hh"
 #include "sim/sim_object.hh"
 #include "sim/system.hh"
@@ -85,6 +88,16 @@ namespace gem5
  *     upper cache dropped a line, making the snoop filter pessimistic for now
  * (4) ordering: there is no single point of order in the system.  Instead,
  *     requesting MSHRs track order between local requests and remote snoops
+ *
+ * By default the lines are tracked in a hash map of unbounded size. The
+ * filter can instead hold a finite number of lines in a set-associative
+ * structure. Replacing a line that is still cached above then requires
+ * a back-invalidation of the caches holding it, which the snoop filter
+ * queues for the crossbar to send. Lines with requests in flight are
+ * never replaced, and if a whole set is in flight the new line
+ * overflows into the hash map. An optional counting Bloom filter of
+ * the tracked lines lets lookups for lines that are not cached above
+ * skip the storage altogether.
  */
 class SnoopFilter : public SimObject
 {
@@ -95,13 +108,16 @@ class SnoopFilter : public SimObject
 
     typedef std::vector<QueuedResponsePort*> SnoopList;
 
-    SnoopFilter (const SnoopFilterParams &p) :
-        SimObject(p), reqLookupResult(cachedLocations.end()),
-        linesize(p.system->cacheLineSize()), lookupLatency(p.lookup_latency),
-        maxEntryCount(p.max_capacity / p.system->cacheLineSize()),
-        stats(this)
+    SnoopFilter(const SnoopFilterParams &p);
+
+    /** A replaced line that may still be cached above. */
+    struct BackInvalidation
     {
-    }
+        Addr addr;
+        bool isSecure;
+        /** Ports that may hold the line. */
+        SnoopList ports;
+    };
 
     /**
      * Init a new snoop filter and tell it about all the cpu_sideports
@@ -200,6 +216,18 @@ class SnoopFilter : public SimObject
      */
     void updateResponse(const Packet *cpkt, const ResponsePort& cpu_side_port);
 
+    /**
+     * Hand over the back-invalidations caused by replacing lines in
+     * lookupRequest. The caller is responsible for invalidating the
+     * lines in the caches above.
+     *
+     * @return The lines replaced since the last call.
+     */
+    std::vector<BackInvalidation> takeBackInvalidations();
+
+    /** Requestor id to use for back-invalidations. */
+    RequestorID backInvalidateRequestorId() const { return backInvalidateId; }
+
     virtual void regStats();
 
   protected:
@@ -258,12 +286,33 @@ class SnoopFilter : public SimObject
 
   private:
 
+    /**
+     * Find the item tracking a line, checking the Bloom filter first.
+     *
+     * @param line_addr Line address, including the status bits.
+     * @return The item, or nullptr if the line is not tracked.
+     */
+    SnoopItem *findItem(Addr line_addr);
+
+    /**
+     * Allocate an item for a line that is not tracked yet, replacing
+     * another line if the set-associative storage is full.
+     *
+     * @param line_addr Line address, including the status bits.
+     * @return The new, empty, item.
+     */
+    SnoopItem *allocateItem(Addr line_addr);
+
     /**
      * Removes snoop filter items which have no requestors and no holders.
      */
-    void eraseIfNullEntry(SnoopFilterCache::iterator& sf_it);
+    void eraseIfNullEntry(Addr line_addr, const SnoopItem *sf_item);
 
-    /** Simple hash set of cached addresses. */
+    /**
+     * Simple hash set of cached addresses. Holds all the lines when
+     * the storage is unbounded, and otherwise only those that
+     * overflowed their set.
+     */
     SnoopFilterCache cachedLocations;
 
     /**
@@ -274,27 +323,18 @@ class SnoopFilter : public SimObject
      */
     struct ReqLookupResult
     {
-        /** Iterator used to store the result from lookupRequest. */
-        SnoopFilterCache::iterator it;
+        /** Item found or allocated by lookupRequest, if any. */
+        SnoopItem *item = nullptr;
+
+        /** Line address of the item. */
+        Addr lineAddr = 0;
 
         /**
          * Variable to temporarily store value of snoopfilter entry
          * in case finishRequest needs to undo changes made in lookupRequest
          * (because of crossbar retry)
          */
-        SnoopItem retryItem;
-
-        /**
-         * The constructor must be informed of the internal cache's end
-         * iterator, so do not allow the compiler to implictly define it.
-         *
-         * @param end_it Iterator to the end of the internal cache.
-         */
-        ReqLookupResult(SnoopFilterCache::iterator end_it)
-            : it(end_it), retryItem{0, 0}
-        {
-        }
-        ReqLookupResult() = delete;
+        SnoopItem retryItem{0, 0};
     } reqLookupResult;
 
     /** List of all attached snooping CPU-side ports. */
@@ -308,6 +348,21 @@ class SnoopFilter : public SimObject
     /** Max capacity in terms of cache blocks tracked, for sanity checking */
     const unsigned maxEntryCount;
 
+    /** Associativity of the storage, 0 if unbounded. */
+    const unsigned assoc;
+    /** Number of sets of the set-associative storage. */
+    const unsigned numSets;
+    /** The set-associative storage, empty if unbounded. */
+    SnoopFilterSets<SnoopItem> sets;
+
+    /** Optional counting Bloom filter of the tracked lines. */
+    bloom_filter::MultiBitSel *bloomFilter;
+
+    /** Replaced lines waiting to be back-invalidated. */
+    std::vector<BackInvalidation> backInvalidations;
+    /** Requestor id of the back-invalidations. */
+    const RequestorID backInvalidateId;
+
     /**
      * Use the lower bits of the address to keep track of the line status
      */
@@ -329,6 +384,13 @@ class SnoopFilter : public SimObject
         statistics::Scalar totSnoops;
         statistics::Scalar hitSingleSnoops;
         statistics::Scalar hitMultiSnoops;
+
+        statistics::Scalar replacements;
+        statistics::Scalar backInvalidations;
+        statistics::Scalar overflows;
+
+        statistics::Scalar bloomFiltered;
+        statistics::Scalar bloomFalsePositives;
     } stats;
 };
 
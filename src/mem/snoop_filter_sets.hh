@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_SNOOP_FILTER_SETS_HH__
+#define __MEM_SNOOP_FILTER_SETS_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/**
+ * Set-associative storage of the lines tracked by a bounded snoop
+ * filter, with LRU replacement. The snoop filter decides which lines
+ * may be replaced, and what to do with the ones that are.
+ *
+ * @tparam Item The per line tracking information.
+ */
+template <typename Item>
+class SnoopFilterSets
+{
+  public:
+    /** A way of the storage. */
+    struct Way
+    {
+        /** Line address, including any status bits. */
+        Addr lineAddr = 0;
+        bool valid = false;
+        /** Time stamp of the last use, for LRU replacement. */
+        uint64_t lastUse = 0;
+        Item item;
+    };
+
+    /**
+     * @param num_sets Number of sets.
+     * @param assoc Number of ways per set.
+     * @param line_size Size of the lines, to find the set of an address.
+     */
+    SnoopFilterSets(unsigned num_sets, unsigned assoc, unsigned line_size)
+        : numSets(num_sets), assoc(assoc), lineSize(line_size),
+          ways(num_sets * assoc)
+    {
+    }
+
+    /**
+     * Find the item of a line and mark the line as most recently used.
+     *
+     * @param line_addr Line address, including the status bits.
+     * @return The item, or nullptr if the line is not in its set.
+     */
+    Item *
+    find(Addr line_addr)
+    {
+        Way *set = getSet(line_addr);
+        for (unsigned way = 0; way < assoc; way++) {
+            if (set[way].valid && set[way].lineAddr == line_addr) {
+                set[way].lastUse = ++useCounter;
+                return &set[way].item;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Choose the way to allocate a line in: an invalid way if there is
+     * one, and otherwise the least recently used way whose item may be
+     * replaced.
+     *
+     * @param line_addr Line address, including the status bits.
+     * @param replaceable Whether an item may be replaced.
+     * @return The way, or nullptr if no way of the set may be replaced.
+     */
+    template <typename Replaceable>
+    Way *
+    findVictim(Addr line_addr, Replaceable replaceable)
+    {
+        Way *set = getSet(line_addr);
+        Way *victim = nullptr;
+        for (unsigned way = 0; way < assoc; way++) {
+            if (!set[way].valid)
+                return &set[way];
+            if (replaceable(set[way].item) &&
+                (!victim || set[way].lastUse < victim->lastUse)) {
+                victim = &set[way];
+            }
+        }
+        return victim;
+    }
+
+    /**
+     * Allocate a line in a way returned by findVictim, as the most
+     * recently used line of its set.
+     *
+     * @return The new, empty, item.
+     */
+    Item *
+    insert(Way *way, Addr line_addr)
+    {
+        way->lineAddr = line_addr;
+        way->valid = true;
+        way->lastUse = ++useCounter;
+        way->item = Item();
+        return &way->item;
+    }
+
+    /**
+     * Invalidate the way holding an item.
+     *
+     * @return Whether the item was held in the line's set.
+     */
+    bool
+    erase(Addr line_addr, const Item *item)
+    {
+        Way *set = getSet(line_addr);
+        for (unsigned way = 0; way < assoc; way++) {
+            if (&set[way].item == item) {
+                set[way].valid = false;
+                return true;
+            }
+        }
+        return false;
+    }
+
+  private:
+    /** Set a line maps to. */
+    Way *
+    getSet(Addr line_addr)
+    {
+        return &ways[(line_addr / lineSize) % numSets * assoc];
+    }
+
+    const unsigned numSets;
+    const unsigned assoc;
+    const unsigned lineSize;
+    std::vector<Way> ways;
+    /** Counter used to time stamp the uses of the ways. */
+    uint64_t useCounter = 0;
+};
+
+} // namespace gem5
+
+#endif // __MEM_SNOOP_FILTER_SETS_HH__
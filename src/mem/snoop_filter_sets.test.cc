@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "mem/snoop_filter_sets.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+struct TestItem
+{
+    bool inFlight = false;
+    int holders = 0;
+};
+
+bool
+replaceable(const TestItem &item)
+{
+    return !item.inFlight;
+}
+
+/** Allocate a line as the snoop filter does. */
+TestItem *
+allocate(SnoopFilterSets<TestItem> &sets, Addr addr)
+{
+    auto *way = sets.findVictim(addr, replaceable);
+    return way ? sets.insert(way, addr) : nullptr;
+}
+
+} // anonymous namespace
+
+/** Lines are found in their own set only. */
+TEST(SnoopFilterSetsTest, FindInsert)
+{
+    SnoopFilterSets<TestItem> sets(2, 2, 64);
+
+    EXPECT_EQ(sets.find(0x0), nullptr);
+    TestItem *item = allocate(sets, 0x0);
+    ASSERT_NE(item, nullptr);
+    item->holders = 1;
+    EXPECT_EQ(sets.find(0x0), item);
+    EXPECT_EQ(sets.find(0x40), nullptr);
+    EXPECT_EQ(sets.find(0x80), nullptr);
+
+    // The status bits are part of the line address
+    EXPECT_EQ(sets.find(0x1), nullptr);
+    TestItem *secure = allocate(sets, 0x1);
+    EXPECT_NE(secure, item);
+    EXPECT_EQ(sets.find(0x1), secure);
+    EXPECT_EQ(sets.find(0x0)->holders, 1);
+}
+
+/** Invalid ways are filled first, then the LRU way is replaced. */
+TEST(SnoopFilterSetsTest, LRUEviction)
+{
+    SnoopFilterSets<TestItem> sets(2, 2, 64);
+
+    // 0x0, 0x80 and 0x100 all map to set 0
+    allocate(sets, 0x0)->holders = 1;
+    allocate(sets, 0x80)->holders = 2;
+    // Filling set 1 does not affect set 0
+    allocate(sets, 0x40);
+    allocate(sets, 0xc0);
+
+    // Touching 0x0 makes 0x80 the LRU line
+    sets.find(0x0);
+    auto *victim = sets.findVictim(0x100, replaceable);
+    ASSERT_NE(victim, nullptr);
+    EXPECT_TRUE(victim->valid);
+    EXPECT_EQ(victim->lineAddr, 0x80);
+    EXPECT_EQ(victim->item.holders, 2);
+
+    TestItem *item = sets.insert(victim, 0x100);
+    EXPECT_EQ(item->holders, 0);
+    EXPECT_EQ(sets.find(0x80), nullptr);
+    EXPECT_EQ(sets.find(0x100), item);
+    EXPECT_EQ(sets.find(0x0)->holders, 1);
+    EXPECT_NE(sets.find(0x40), nullptr);
+    EXPECT_NE(sets.find(0xc0), nullptr);
+
+    // 0x0 was looked up after 0x100 was allocated
+    victim = sets.findVictim(0x180, replaceable);
+    ASSERT_NE(victim, nullptr);
+    EXPECT_EQ(victim->lineAddr, 0x100);
+}
+
+/** Lines with requests in flight are never replaced. */
+TEST(SnoopFilterSetsTest, InFlightNotReplaced)
+{
+    SnoopFilterSets<TestItem> sets(1, 2, 64);
+
+    allocate(sets, 0x0)->inFlight = true;
+    allocate(sets, 0x40);
+
+    // 0x0 is the LRU line, but has a request in flight
+    auto *victim = sets.findVictim(0x80, replaceable);
+    ASSERT_NE(victim, nullptr);
+    EXPECT_EQ(victim->lineAddr, 0x40);
+
+    // With the whole set in flight the line overflows
+    sets.find(0x40)->inFlight = true;
+    EXPECT_EQ(sets.findVictim(0x80, replaceable), nullptr);
+
+    // Once the request completes the line can be replaced again
+    sets.find(0x0)->inFlight = false;
+    victim = sets.findVictim(0x80, replaceable);
+    ASSERT_NE(victim, nullptr);
+    EXPECT_EQ(victim->lineAddr, 0x0);
+}
+
+/** Erased lines free their way, and foreign items are not erased. */
+TEST(SnoopFilterSetsTest, Erase)
+{
+    SnoopFilterSets<TestItem> sets(1, 2, 64);
+
+    TestItem *a = allocate(sets, 0x0);
+    TestItem *b = allocate(sets, 0x40);
+    TestItem overflowed;
+
+    EXPECT_FALSE(sets.erase(0x80, &overflowed));
+    EXPECT_EQ(sets.find(0x0), a);
+    EXPECT_EQ(sets.find(0x40), b);
+
+    EXPECT_TRUE(sets.erase(0x0, a));
+    EXPECT_EQ(sets.find(0x0), nullptr);
+
+    // The freed way is used before replacing the LRU line
+    auto *victim = sets.findVictim(0x80, replaceable);
+    ASSERT_NE(victim, nullptr);
+    EXPECT_FALSE(victim->valid);
+    EXPECT_EQ(sets.insert(victim, 0x80), a);
+    EXPECT_EQ(sets.find(0x40), b);
+}
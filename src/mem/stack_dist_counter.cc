@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/stack_dist_counter.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+namespace gem5
+{
+
+namespace
+{
+
+/** Number of slots of a new tree. */
+constexpr uint64_t initialCapacity = 1 << 12;
+
+} // anonymous namespace
+
+StackDistCounter::StackDistCounter(unsigned sample_shift)
+    : sampleShift(sample_shift), tree(initialCapacity + 1, 0),
+      capacity(initialCapacity), nextSlot(0)
+{
+    assert(sample_shift < 64);
+}
+
+double
+StackDistCounter::setAssocMissProb(double stack_dist, unsigned assoc,
+                                   uint64_t sets)
+{
+    if (stack_dist < assoc)
+        return 0;
+    if (sets <= 1)
+        return 1;
+
+    // Binomial probabilities of k of the lines mapping to the set
+    const double p = 1.0 / sets;
+    double pmf = std::exp(stack_dist * std::log1p(-p));
+    double hit = pmf;
+    for (unsigned k = 1; k < assoc; ++k) {
+        pmf *= (stack_dist - k + 1) / k * p / (1 - p);
+        hit += pmf;
+    }
+    return std::max(0.0, 1.0 - hit);
+}
+
+uint64_t
+StackDistCounter::access(Addr addr)
+{
+    assert(sampled(addr));
+
+    if (nextSlot == capacity)
+        compact();
+
+    auto [it, inserted] = lastSlot.emplace(addr, nextSlot);
+    uint64_t dist = Infinity;
+    if (!inserted) {
+        // Every tracked address has a live slot, and the ones after
+        // the previous access to this address were accessed since
+        const uint64_t prev = it->second;
+        dist = (lastSlot.size() - prefix(prev + 1)) << sampleShift;
+        add(prev, -1);
+        it->second = nextSlot;
+    }
+    add(nextSlot, 1);
+    ++nextSlot;
+
+    return dist;
+}
+
+void
+StackDistCounter::clear()
+{
+    lastSlot.clear();
+    tree.assign(initialCapacity + 1, 0);
+    capacity = initialCapacity;
+    nextSlot = 0;
+}
+
+void
+StackDistCounter::compact()
+{
+    std::vector<std::pair<uint64_t, uint64_t *>> live;
+    live.reserve(lastSlot.size());
+    for (auto &entry : lastSlot)
+        live.emplace_back(entry.second, &entry.second);
+    std::sort(live.begin(), live.end());
+
+    while (live.size() * 2 > capacity)
+        capacity *= 2;
+
+    // Rebuild the tree in linear time: set the leaves, then add each
+    // node to its parent
+    tree.assign(capacity + 1, 0);
+    for (uint64_t i = 0; i < live.size(); ++i) {
+        *live[i].second = i;
+        tree[i + 1] = 1;
+    }
+    for (uint64_t i = 1; i <= capacity; ++i) {
+        const uint64_t parent = i + (i & -i);
+        if (parent <= capacity)
+            tree[parent] += tree[i];
+    }
+
+    nextSlot = live.size();
+}
+
+} // namespace gem5
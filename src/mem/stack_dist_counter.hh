@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_STACK_DIST_COUNTER_HH__
+#define __MEM_STACK_DIST_COUNTER_HH__
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/**
+ * Computes LRU stack distances (the number of distinct addresses
+ * accessed since the previous access to the same address) in
+ * O(log n) time per access, using the algorithm of Bennett and Kruskal.
+ *
+ * Every access takes the next slot of a Fenwick tree, and the tree
+ * holds a one for the slot of the latest access to each address. The
+ * stack distance of an address is then the number of ones after the
+ * slot of its previous access. When the slots run out they are
+ * renumbered in access order, keeping only the live ones.
+ *
+ * Optionally only a fraction of the addresses are tracked, as in
+ * SHARDS (Waldspurger et al., FAST'15): an address is sampled if its
+ * hash falls in the lowest 1/2^sample_shift of the hash space, and
+ * the distances between sampled addresses are scaled back up by
+ * 2^sample_shift. This bounds the memory used and the time spent at
+ * the cost of some accuracy.
+ */
+class StackDistCounter
+{
+  public:
+    /** Distance returned on the first access to an address. */
+    static constexpr uint64_t Infinity = std::numeric_limits<uint64_t>::max();
+
+    /**
+     * @param sample_shift Track one address in 2^sample_shift.
+     */
+    StackDistCounter(unsigned sample_shift = 0);
+
+    /** Whether an address is tracked when sampling. */
+    bool
+    sampled(Addr addr) const
+    {
+        return sampleShift == 0 || (hash(addr) >> (64 - sampleShift)) == 0;
+    }
+
+    /**
+     * Access an address, moving it to the top of the stack.
+     *
+     * @param addr The address, which must be sampled.
+     * @return Its stack distance, scaled if sampling, or Infinity.
+     */
+    uint64_t access(Addr addr);
+
+    /** Number of distinct addresses tracked. */
+    size_t size() const { return lastSlot.size(); }
+
+    /** Forget all addresses. */
+    void clear();
+
+    /**
+     * Probability that an access misses in a set-associative LRU cache,
+     * given its stack distance in a fully-associative one. It hits if
+     * fewer than assoc of the stack_dist lines accessed since map to
+     * its set, assuming that lines map to sets uniformly at random. A
+     * cache with at most one set is a fully-associative one of assoc
+     * lines.
+     *
+     * @param stack_dist The stack distance of the access.
+     * @param assoc The associativity of the cache.
+     * @param sets The number of sets of the cache.
+     */
+    static double setAssocMissProb(double stack_dist, unsigned assoc,
+                                   uint64_t sets);
+
+  protected:
+    static uint64_t
+    hash(Addr addr)
+    {
+        // splitmix64 finalizer
+        uint64_t x = addr;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    /** Add a value to a slot of the Fenwick tree. */
+    void
+    add(uint64_t slot, int32_t value)
+    {
+        for (uint64_t i = slot + 1; i <= capacity; i += i & -i)
+            tree[i] += value;
+    }
+
+    /** Number of live slots before the given one. */
+    uint64_t
+    prefix(uint64_t slot) const
+    {
+        uint64_t sum = 0;
+        for (uint64_t i = slot; i > 0; i -= i & -i)
+            sum += tree[i];
+        return sum;
+    }
+
+    /**
+     * Renumber the live slots from 0 in access order, growing the
+     * tree if more than half of it would still be in use.
+     */
+    void compact();
+
+    const unsigned sampleShift;
+
+    /** Slot of the latest access to each address. */
+    std::unordered_map<Addr, uint64_t> lastSlot;
+
+    /** Fenwick tree over the slots, indexed from 1. */
+    std::vector<int32_t> tree;
+
+    /** Number of slots in the tree. */
+    uint64_t capacity;
+
+    /** Slot of the next access. */
+    uint64_t nextSlot;
+};
+
+} // namespace gem5
+
+#endif //__MEM_STACK_DIST_COUNTER_HH__
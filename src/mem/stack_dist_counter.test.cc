@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "mem/stack_dist_counter.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** Reference stack distance: the position of addr in an LRU stack. */
+uint64_t
+naiveAccess(std::vector<Addr> &stack, Addr addr)
+{
+    auto it = std::find(stack.begin(), stack.end(), addr);
+    uint64_t dist = StackDistCounter::Infinity;
+    if (it != stack.end()) {
+        dist = stack.end() - it - 1;
+        stack.erase(it);
+    }
+    stack.push_back(addr);
+    return dist;
+}
+
+} // anonymous namespace
+
+TEST(StackDistCounterTest, Simple)
+{
+    StackDistCounter counter;
+    EXPECT_EQ(counter.access(0x0), StackDistCounter::Infinity);
+    EXPECT_EQ(counter.access(0x40), StackDistCounter::Infinity);
+    EXPECT_EQ(counter.access(0x40), 0);
+    EXPECT_EQ(counter.access(0x80), StackDistCounter::Infinity);
+    EXPECT_EQ(counter.access(0x0), 2);
+    EXPECT_EQ(counter.access(0x80), 1);
+    EXPECT_EQ(counter.size(), 3);
+
+    counter.clear();
+    EXPECT_EQ(counter.size(), 0);
+    EXPECT_EQ(counter.access(0x0), StackDistCounter::Infinity);
+}
+
+/** Match a naive LRU stack across several compactions. */
+TEST(StackDistCounterTest, MatchesNaiveStack)
+{
+    StackDistCounter counter;
+    std::vector<Addr> stack;
+    std::mt19937 rng(1);
+
+    // Mostly short reuse with some streaming, enough to fill the
+    // initial tree a few times and to make it grow
+    for (int i = 0; i < 50000; ++i) {
+        Addr addr = (rng() % 4 == 0) ? 0x100000 + i :
+                                       rng() % (1000 + i / 10);
+        ASSERT_EQ(counter.access(addr), naiveAccess(stack, addr)) << i;
+    }
+}
+
+/** Sampled distances are scaled, and about the sampling rate is kept. */
+TEST(StackDistCounterTest, Sampling)
+{
+    StackDistCounter counter(4);
+
+    std::vector<Addr> sampled;
+    for (Addr addr = 0; addr < 16000; ++addr) {
+        if (counter.sampled(addr))
+            sampled.push_back(addr);
+    }
+    EXPECT_GT(sampled.size(), 800);
+    EXPECT_LT(sampled.size(), 1200);
+
+    for (auto addr : sampled)
+        EXPECT_EQ(counter.access(addr), StackDistCounter::Infinity);
+    for (auto addr : sampled) {
+        EXPECT_EQ(counter.access(addr), (sampled.size() - 1) << 4);
+    }
+}
+
+/** Miss probabilities of a set-associative cache. */
+TEST(StackDistCounterTest, SetAssocMissProb)
+{
+    // Accesses reusing fewer lines than the associativity always hit
+    EXPECT_EQ(StackDistCounter::setAssocMissProb(7, 8, 64), 0);
+
+    // A direct-mapped cache hits only if none of the lines map to the set
+    EXPECT_DOUBLE_EQ(StackDistCounter::setAssocMissProb(1, 1, 4), 0.25);
+    EXPECT_DOUBLE_EQ(StackDistCounter::setAssocMissProb(2, 1, 4),
+                     1 - 0.75 * 0.75);
+
+    // The miss probability grows with the stack distance
+    const double near = StackDistCounter::setAssocMissProb(16, 4, 16);
+    const double far = StackDistCounter::setAssocMissProb(64, 4, 16);
+    EXPECT_GT(near, 0);
+    EXPECT_LT(near, far);
+    EXPECT_LT(far, 1);
+}
+
+/** A cache with a single set is fully associative, e.g., 16 lines 12-way. */
+TEST(StackDistCounterTest, SetAssocMissProbSingleSet)
+{
+    const uint64_t lines = 16;
+    const unsigned assoc = 12;
+    EXPECT_EQ(StackDistCounter::setAssocMissProb(11, assoc, lines / assoc),
+              0);
+    EXPECT_EQ(StackDistCounter::setAssocMissProb(12, assoc, lines / assoc),
+              1);
+    EXPECT_EQ(StackDistCounter::setAssocMissProb(1000, assoc, 0), 1);
+}
@@ -28,12 +28,22 @@ import m5
 import m5.ticks
 from m5.stats import addStatVisitor
 from m5.stats.gem5stats import get_simstat
-from m5.objects import Root
+from m5.objects import Root, System
 from m5.util import warn
 
 import os
+import sys
+import traceback
 from pathlib import Path
-from typing import Optional, List, Tuple, Dict, Generator, Union
+from typing import (
+    Callable,
+    Optional,
+    List,
+    Tuple,
+    Dict,
+    Generator,
+    Union,
+)
 
 from .exit_event_generators import (
     default_exit_generator,
@@ -364,6 +374,119 @@ class Simulator:
             if exit_on_completion:
                 return
 
+    def run_forked(
+        self,
+        variants: List[Callable[[AbstractBoard], None]],
+        max_ticks: int = m5.MaxTick,
+        max_processes: Optional[int] = None,
+    ) -> List[int]:
+        """
+        Run a number of variants of the simulation from the current state,
+        each in its own forked process.
+
+        The simulation is instantiated (and the checkpoint, if any, restored)
+        once in this process, which then forks a child per variant. The
+        children share the memory of this process, including the backing
+        store of the simulated memory, copy-on-write, so they only use host
+        memory for the pages they change. A backing store in shared memory
+        (see `System.shared_backstore`) would instead be shared by all the
+        children, so it is not supported. Each child calls its variant
+        function with the board, e.g. to switch to one of the cores of a
+        `SwitchableProcessor`, and then calls `run()`. Its output, including
+        its stats, goes to a `variantN` directory in the output directory
+        and it exits when `run()` returns.
+
+        Listeners (e.g., the terminal and GDB) cannot be forked, so they are
+        disabled if the simulation has not been instantiated yet.
+
+        Example
+        -------
+
+        ```
+        simulator = Simulator(board=board, checkpoint_path=path)
+        statuses = simulator.run_forked(
+            variants=[
+                lambda board: None,
+                lambda board: board.get_processor().switch(),
+            ],
+            max_processes=2,
+        )
+        ```
+
+        :param variants: A function per child, called with the board before
+        the child starts running.
+        :param max_ticks: The maximum number of ticks per simulation run,
+        passed to `run()` in each child.
+        :param max_processes: The maximum number of children to run at once.
+        By default, all children are run at once.
+
+        :returns: The exit status of each child, in the order of `variants`.
+        """
+
+        for obj in self._board.descendants():
+            if isinstance(obj, System) and obj.shared_backstore:
+                raise Exception(
+                    f"{obj.path()} uses a shared backing store, which "
+                    "forked variants would all write to."
+                )
+
+        if not self._instantiated:
+            m5.disableAllListeners()
+        self._instantiate()
+
+        if max_processes is not None and max_processes < 1:
+            raise Exception("max_processes must be at least 1.")
+
+        running = {}
+        statuses = [None] * len(variants)
+
+        def wait_child():
+            pid, status = os.wait()
+            if os.WIFEXITED(status):
+                status = os.WEXITSTATUS(status)
+            else:
+                status = -os.WTERMSIG(status)
+            statuses[running.pop(pid)] = status
+
+        for index, variant in enumerate(variants):
+            while max_processes is not None and len(running) >= max_processes:
+                wait_child()
+
+            pid = m5.fork(os.path.join("%(parent)s", f"variant{index}"))
+            if pid == 0:
+                # Never return into the caller's script from a child.
+                status = 1
+                try:
+                    variant(self._board)
+                    self.run(max_ticks)
+                    # The handler that dumps the stats at exit is skipped
+                    # by os._exit().
+                    m5.stats.dump()
+                    status = 0
+                except SystemExit as e:
+                    # Follow sys.exit(): None is success, and other
+                    # non-integer codes are failures.
+                    if e.code is None:
+                        status = 0
+                    elif isinstance(e.code, int):
+                        status = e.code
+                    else:
+                        status = 1
+                except BaseException:
+                    traceback.print_exc()
+                # Exit without unwinding, which would run the handlers of
+                # the caller's script in the child.
+                sys.stdout.flush()
+                sys.stderr.flush()
+                os._exit(status)
+
+            running[pid] = index
+
+        while running:
+            wait_child()
+
+        return statuses
+
     def save_checkpoint(self, checkpoint_dir: Path) -> None:
         """
         This function will save the checkpoint to the specified directory.
@@ -183,6 +183,30 @@ def _hdf5Factory(fn, chunking=10, desc=True, formulas=True):
 
     return _m5.stats.initHDF5(fn, chunking, desc, formulas)
 
+@_url_factory([ "bin", "binary", ])
+def _binaryFactory(fn, desc=True):
+    """Output stats in a compact binary format.
+
+    Binary stat files store the names and metadata of all stats once
+    and then each dump as an array of raw values, which makes frequent
+    periodic dumps much faster and smaller than text. Files can be read
+    with the m5.stats.binary module, which also works outside of gem5:
+
+      python3 src/python/m5/stats/binary.py m5out/stats.bin
+
+    Known limitations:
+      * Sparse histograms currently unsupported.
+
+    Parameters:
+      * desc (bool): Output stat descriptions (default: True)
+
+    Example:
+      bin://stats.bin?desc=False
+
+    """
+
+    return _m5.stats.initBinary(fn, desc)
+
 @_url_factory(["json"])
 def _jsonFactory(fn):
     """Output stats in JSON format.
@@ -336,14 +360,10 @@ def prepare():
     _visit_stats(lambda g, s: s.prepare())
 
 def _dump_to_visitor(visitor, roots=None):
-    # New stats
+    # New stats. The hierarchy is walked in C++ to avoid wrapping
+    # every stat and group in a Python object on each dump.
     def dump_group(group):
-        for stat in group.getStats():
-            stat.visit(visitor)
-        for n, g in group.getStatGroups().items():
-            visitor.beginGroup(n)
-            dump_group(g)
-            visitor.endGroup()
+        group.visitStats(visitor)
 
     if roots:
         # New stats from selected subroots.
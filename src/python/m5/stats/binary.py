@@ -0,0 +1,234 @@
+# Copyright (c) 2022 The Regents of The University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Reader for binary stat files (bin://stats.bin).
+
+A binary stat file starts with a header followed by schema and dump
+records. A schema lists the stats in a dump along with their metadata,
+and each dump holds the values of those stats as an array of doubles.
+See src/base/stats/binary.hh for the layout.
+
+This module only depends on the Python standard library so that it can
+be used outside of gem5, e.g.:
+
+    from binary import read
+    for dump in read("m5out/stats.bin"):
+        print(dump.tick, dump["system.cpu.numCycles"])
+
+Running it as a script prints all dumps in a text-like format.
+"""
+
+import array
+import struct
+import sys
+
+MAGIC = b"gem5sbin"
+VERSION = 1
+BYTE_ORDER_MARKER = 0x01020304
+
+SCALAR, VECTOR, DIST, VECTOR_DIST, VECTOR_2D, FORMULA = range(6)
+KIND_NAMES = ("scalar", "vector", "dist", "vector_dist", "vector2d",
+              "formula")
+
+# Values stored ahead of the buckets of each distribution.
+DIST_FIELDS = ("samples", "sum", "squares", "logs", "min_val", "max_val",
+               "underflow", "overflow")
+
+class StatEntry(object):
+    """Metadata of one stat in a schema.
+
+    The values of the stat are dump.values[offset:offset + size].
+    """
+
+    __slots__ = ("name", "kind", "size", "unit", "desc", "subnames",
+                 "y_subnames", "params", "offset")
+
+    def __repr__(self):
+        return "StatEntry(%s, %s, size=%d)" % (
+            self.name, KIND_NAMES[self.kind], self.size)
+
+class Dump(object):
+    """A single stat dump."""
+
+    def __init__(self, tick, schema, index, values):
+        self.tick = tick
+        self.schema = schema
+        self._index = index
+        self.values = values
+
+    def __contains__(self, name):
+        return name in self._index
+
+    def __getitem__(self, name):
+        """Return the values of a stat as a list."""
+        entry = self._index[name]
+        return self.values[entry.offset:entry.offset + entry.size].tolist()
+
+    def entry(self, name):
+        return self._index[name]
+
+    def items(self):
+        for entry in self.schema:
+            yield entry, \
+                self.values[entry.offset:entry.offset + entry.size].tolist()
+
+class _Reader(object):
+    def __init__(self, f):
+        self.f = f
+
+        if f.read(len(MAGIC)) != MAGIC:
+            raise ValueError("Not a gem5 binary stat file")
+
+        header = f.read(8)
+        self.order = "="
+        self.swap = False
+        if struct.unpack("=I", header[4:])[0] != BYTE_ORDER_MARKER:
+            # Written on a host with the other byte order
+            self.order = ">" if sys.byteorder == "little" else "<"
+            self.swap = True
+        version, marker = struct.unpack(self.order + "II", header)
+        if marker != BYTE_ORDER_MARKER:
+            raise ValueError("Bad byte order marker in stat file")
+
+        if version != VERSION:
+            raise ValueError("Unsupported stat file version %d" % version)
+
+        self.schemas = []
+
+    def unpack(self, fmt):
+        size = struct.calcsize(self.order + fmt)
+        data = self.f.read(size)
+        if len(data) != size:
+            raise EOFError("Truncated stat file")
+        return struct.unpack(self.order + fmt, data)
+
+    def string(self):
+        length, = self.unpack("I")
+        return self.f.read(length).decode("utf-8")
+
+    def strings(self):
+        count, = self.unpack("I")
+        return [ self.string() for _ in range(count) ]
+
+    def schema(self):
+        schema_id, count = self.unpack("IQ")
+        assert schema_id == len(self.schemas)
+
+        entries = []
+        offset = 0
+        for _ in range(count):
+            entry = StatEntry()
+            entry.kind, entry.size = self.unpack("BQ")
+            entry.name = self.string()
+            entry.unit = self.string()
+            entry.desc = self.string()
+            entry.subnames = self.strings()
+            entry.y_subnames = self.strings()
+            num_params, = self.unpack("I")
+            entry.params = list(self.unpack("%dd" % num_params))
+            entry.offset = offset
+            offset += entry.size
+            entries.append(entry)
+
+        self.schemas.append(
+            (entries, dict((e.name, e) for e in entries)))
+
+    def dump(self):
+        schema_id, tick, count = self.unpack("IQQ")
+        values = array.array("d")
+        values.fromfile(self.f, count)
+        if self.swap:
+            values.byteswap()
+
+        entries, index = self.schemas[schema_id]
+        return Dump(tick, entries, index, values)
+
+    def __iter__(self):
+        while True:
+            kind = self.f.read(1)
+            if not kind:
+                return
+            elif kind == b"S":
+                self.schema()
+            elif kind == b"D":
+                yield self.dump()
+            else:
+                raise ValueError("Unknown record type %r" % kind)
+
+def read(path):
+    """Iterate over the dumps in a binary stat file."""
+    with open(path, "rb") as f:
+        for dump in _Reader(f):
+            yield dump
+
+def _format_values(entry, values):
+    if entry.kind in (SCALAR, ):
+        yield entry.name, values[0]
+        return
+
+    if entry.kind in (VECTOR, FORMULA, VECTOR_2D):
+        names = entry.subnames
+        if entry.kind == VECTOR_2D:
+            x, y = (int(p) for p in entry.params)
+            names = [ "%s.%s" % (
+                        names[i] if i < len(names) and names[i] else i,
+                        entry.y_subnames[j] \
+                            if j < len(entry.y_subnames) else j)
+                      for i in range(x) for j in range(y) ]
+        for i, value in enumerate(values):
+            sub = names[i] if i < len(names) and names[i] else i
+            yield "%s::%s" % (entry.name, sub), value
+        return
+
+    # Distributions, possibly a vector of them
+    buckets = int(entry.params[4]) if entry.params else 0
+    step = len(DIST_FIELDS) + buckets
+    for n, base in enumerate(range(0, len(values), step)):
+        name = entry.name
+        if entry.kind == VECTOR_DIST:
+            name = "%s::%s" % (name, entry.subnames[n] \
+                               if n < len(entry.subnames) and \
+                                   entry.subnames[n] else n)
+        for i, field in enumerate(DIST_FIELDS):
+            yield "%s::%s" % (name, field), values[base + i]
+        for i in range(buckets):
+            yield "%s::%d" % (name, i), values[base + len(DIST_FIELDS) + i]
+
+def main(argv):
+    if len(argv) != 2:
+        print("Usage: %s STATS_FILE" % argv[0], file=sys.stderr)
+        return 1
+
+    for dump in read(argv[1]):
+        print("---------- Dump at tick %d ----------" % dump.tick)
+        for entry, values in dump.items():
+            for name, value in _format_values(entry, values):
+                print("%-60s %s" % (name, repr(value)))
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -42,6 +42,7 @@
 #include "pybind11/stl.h"
 
 #include "base/statistics.hh"
+#include "base/stats/binary.hh"
 #include "base/stats/text.hh"
 #include "config/have_hdf5.hh"
 
@@ -115,6 +116,7 @@ pybind_init_stats(py::module_ &m_native)
 #if HAVE_HDF5
         .def("initHDF5", &statistics::initHDF5)
 #endif
+        .def("initBinary", &statistics::initBinary)
         .def("registerPythonStatsHandlers",
              &statistics::registerPythonStatsHandlers)
         .def("schedStatEvent", &statistics::schedStatEvent)
@@ -234,6 +236,7 @@ pybind_init_stats(py::module_ &m_native)
                 return py_stats;
             })
         .def("getStatGroups", &statistics::Group::getStatGroups)
+        .def("visitStats", &statistics::Group::visitStats)
         .def("addStatGroup", &statistics::Group::addStatGroup)
         .def("resolveStat", [](const statistics::Group &self,
                                const std::string &name) -> py::object {
@@ -67,6 +67,17 @@ class Root(SimObject):
     # Needs to be set explicitly for a multi-eventq simulation.
     sim_quantum = Param.Tick(0, "simulation quantum")
 
+    # Bounds of an adaptive simulation quantum. If they differ, the
+    # quantum starts at sim_quantum, is doubled after every quantum in
+    # which the event queues did not communicate, and falls back to
+    # sim_quantum_min as soon as they do. sim_quantum_min must not be
+    # larger than the smallest latency between objects on different
+    # event queues. Both default to sim_quantum, i.e., a fixed quantum.
+    sim_quantum_min = Param.Tick(0, "minimum simulation quantum "
+                                 "(0 to use sim_quantum)")
+    sim_quantum_max = Param.Tick(0, "maximum simulation quantum "
+                                 "(0 to use sim_quantum)")
+
     full_system = Param.Bool("if this is a full system simulation")
 
     # Time syncing prevents the simulation from running faster than real time.
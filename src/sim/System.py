@@ -90,6 +90,18 @@ class System(SimObject):
     auto_unlink_shared_backstore = Param.Bool(False, "Automatically remove the "
         "shmem segment file upon destruction. This is used only if "
         "shared_backstore is non-empty.")
+    incremental_checkpoints = Param.Bool(False, "Only write the pages of "
+        "the backstore that changed since the previous checkpoint, which "
+        "is then needed to restore the new one. Changed pages are found by "
+        "comparing the backstore with a copy of it taken at the previous "
+        "checkpoint, which uses as much host memory as the pages of the "
+        "backstore that are not all zeros.")
+    full_checkpoint_interval = Param.Unsigned(0, "Write a full image of the "
+        "backstore after this many incremental checkpoints to bound the "
+        "chain of checkpoints needed to restore, 0 to never do so.")
+    mappable_checkpoints = Param.Bool(False, "Write full checkpoints of the "
+        "backstore as uncompressed images that are mapped copy-on-write "
+        "on restore, so that only the pages touched are read.")
 
     cache_line_size = Param.Unsigned(64, "Cache line size in bytes")
 
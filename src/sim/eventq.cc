@@ -30,7 +30,9 @@
 
 #include "sim/eventq.hh"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <iostream>
 #include <mutex>
 #include <string>
@@ -39,13 +41,30 @@
 
 #include "base/logging.hh"
 #include "base/trace.hh"
+#include "config/use_calendar_eventq.hh"
 #include "cpu/smt.hh"
 #include "debug/Checkpoint.hh"
 
 namespace gem5
 {
 
+namespace
+{
+
+/** Smallest number of buckets used by the calendar backend. */
+constexpr size_t minCalendarBuckets = 16;
+
+/** Bucket width used until the calendar is first rebuilt. */
+constexpr Tick initialBucketWidth = 1000;
+
+/** Number of early bins sampled to estimate the bucket width. */
+constexpr size_t bucketWidthSamples = 25;
+
+} // anonymous namespace
+
 Tick simQuantum = 0;
+Tick simQuantumMin = 0;
+Tick simQuantumMax = 0;
 
 //
 // Main Event Queues
@@ -65,6 +84,7 @@ getEventQueue(uint32_t index)
         numMainEventQueues++;
         mainEventQueue.push_back(
             new EventQueue(csprintf("MainEventQueue-%d", index)));
+        mainEventQueue.back()->mainQueueIndex = numMainEventQueues - 1;
     }
 
     return mainEventQueue[index];
@@ -111,6 +131,11 @@ Event::insertBefore(Event *event, Event *curr)
 void
 EventQueue::insert(Event *event)
 {
+    if (backend == Backend::Calendar) {
+        calendarInsert(event);
+        return;
+    }
+
     // Deal with the head case
     if (!head || *event <= *head) {
         head = Event::insertBefore(event, head);
@@ -170,6 +195,11 @@ EventQueue::remove(Event *event)
 
     assert(event->queue == this);
 
+    if (backend == Backend::Calendar) {
+        calendarRemove(event);
+        return;
+    }
+
     // deal with an event on the head's 'in bin' list (event has the same
     // time as the head)
     if (*head == *event) {
@@ -199,10 +229,13 @@ EventQueue::serviceOne()
 {
     std::lock_guard<EventQueue> lock(*this);
     Event *event = head;
-    Event *next = head->nextInBin;
     event->flags.clear(Event::Scheduled);
 
-    if (next) {
+    if (backend == Backend::Calendar) {
+        // The head bin is always the first bin of its bucket, so this
+        // does not need to walk the bucket.
+        calendarRemove(event);
+    } else if (Event *next = head->nextInBin) {
         // update the next bin pointer since it could be stale
         next->nextBin = head->nextBin;
 
@@ -295,15 +328,12 @@ EventQueue::dump() const
     if (empty())
         cprintf("<No Events>\n");
     else {
-        Event *nextBin = head;
-        while (nextBin) {
+        for (Event *nextBin : collectBins(true)) {
             Event *nextInBin = nextBin;
             while (nextInBin) {
                 nextInBin->dump();
                 nextInBin = nextInBin->nextInBin;
             }
-
-            nextBin = nextBin->nextBin;
         }
     }
 
@@ -316,10 +346,33 @@ EventQueue::debugVerify() const
     std::unordered_map<long, bool> map;
 
     Tick time = 0;
-    short priority = 0;
+    short priority = Event::Minimum_Pri;
+
+    if (backend == Backend::Calendar) {
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            for (Event *bin = buckets[i]; bin; bin = bin->nextBin) {
+                if (bucketIndex(bin->when()) != i) {
+                    cprintf("bin in the wrong bucket!");
+                    bin->dump();
+                    return false;
+                }
+                if (bin->nextBin && !(*bin < *bin->nextBin)) {
+                    cprintf("bucket not sorted!");
+                    bin->dump();
+                    return false;
+                }
+            }
+        }
+    }
 
-    Event *nextBin = head;
-    while (nextBin) {
+    std::vector<Event *> bins = collectBins(true);
+    if (!bins.empty() && bins.front() != head) {
+        cprintf("head is not the earliest bin!");
+        head->dump();
+        return false;
+    }
+
+    for (Event *nextBin : bins) {
         Event *nextInBin = nextBin;
         while (nextInBin) {
             if (nextInBin->when() < time) {
@@ -345,8 +398,6 @@ EventQueue::debugVerify() const
 
             nextInBin = nextInBin->nextInBin;
         }
-
-        nextBin = nextBin->nextBin;
     }
 
     return true;
@@ -355,9 +406,205 @@ EventQueue::debugVerify() const
 Event*
 EventQueue::replaceHead(Event* s)
 {
-    Event* t = head;
-    head = s;
-    return t;
+    if (backend == Backend::SortedList) {
+        Event* t = head;
+        head = s;
+        return t;
+    }
+
+    // Hand the current events out as a sorted chain of bins, which is
+    // what callers expect to get back, and rebuild the calendar from
+    // the chain we were given.
+    std::vector<Event *> old_bins = collectBins(true);
+    for (size_t i = 0; i < old_bins.size(); ++i) {
+        old_bins[i]->nextBin =
+            i + 1 < old_bins.size() ? old_bins[i + 1] : nullptr;
+    }
+
+    std::vector<Event *> new_bins;
+    for (; s; s = s->nextBin)
+        new_bins.push_back(s);
+    calendarRebuild(new_bins);
+
+    return old_bins.empty() ? nullptr : old_bins.front();
+}
+
+size_t
+EventQueue::bucketIndex(Tick when) const
+{
+    return (when / bucketWidth) & (buckets.size() - 1);
+}
+
+void
+EventQueue::calendarInsert(Event *event)
+{
+    // Find the bin in the bucket that the event belongs to, or the place
+    // where a new bin needs to be inserted.
+    Event **link = &buckets[bucketIndex(event->when())];
+    Event *curr = *link;
+    while (curr && *curr < *event) {
+        link = &curr->nextBin;
+        curr = curr->nextBin;
+    }
+
+    const bool new_bin = !curr || *event < *curr;
+    *link = Event::insertBefore(event, curr);
+
+    // An event that joins the head bin goes on top of its stack, so it
+    // becomes the new head just like a strictly earlier event does.
+    if (!head || *event <= *head)
+        head = event;
+
+    if (new_bin && ++numBins > 2 * buckets.size())
+        calendarRebuild(collectBins(false));
+}
+
+void
+EventQueue::calendarInsertBin(Event *bin)
+{
+    Event **link = &buckets[bucketIndex(bin->when())];
+    while (*link && **link < *bin)
+        link = &(*link)->nextBin;
+
+    assert(!*link || *bin < **link);
+    bin->nextBin = *link;
+    *link = bin;
+
+    if (!head || *bin < *head)
+        head = bin;
+}
+
+void
+EventQueue::calendarRemove(Event *event)
+{
+    Event **link = &buckets[bucketIndex(event->when())];
+    Event *curr = *link;
+    while (curr && *curr < *event) {
+        link = &curr->nextBin;
+        curr = curr->nextBin;
+    }
+
+    if (!curr || *curr != *event)
+        panic("event not found!");
+
+    const bool last_in_bin = curr == event && !event->nextInBin;
+    *link = Event::removeItem(event, curr);
+
+    if (!last_in_bin) {
+        // The head bin is the first bin of its bucket, so if the head
+        // was popped, the new top of its stack is now at the link.
+        if (event == head)
+            head = *link;
+        return;
+    }
+
+    --numBins;
+    if (event == head)
+        head = calendarFindHead(event->when());
+
+    if (buckets.size() > minCalendarBuckets && numBins < buckets.size() / 4)
+        calendarRebuild(collectBins(false));
+}
+
+Event *
+EventQueue::calendarFindHead(Tick from) const
+{
+    if (numBins == 0)
+        return nullptr;
+
+    // Scan the calendar one bucket-sized "day" at a time, starting from
+    // the day that contains 'from'. No event is pending before 'from',
+    // so the first bucket whose earliest bin falls on the day being
+    // scanned holds the earliest bin overall.
+    const size_t mask = buckets.size() - 1;
+    size_t idx = bucketIndex(from);
+    Tick day_end = (from / bucketWidth) * bucketWidth;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        if (day_end > MaxTick - bucketWidth)
+            break;
+        day_end += bucketWidth;
+
+        Event *bin = buckets[idx];
+        if (bin && bin->when() < day_end)
+            return bin;
+        idx = (idx + 1) & mask;
+    }
+
+    // Nothing is pending within a full calendar year, fall back to a
+    // direct search of the earliest bin in every bucket.
+    Event *earliest = nullptr;
+    for (Event *bin : buckets) {
+        if (bin && (!earliest || *bin < *earliest))
+            earliest = bin;
+    }
+    return earliest;
+}
+
+void
+EventQueue::calendarRebuild(const std::vector<Event *> &bins)
+{
+    size_t num_buckets = minCalendarBuckets;
+    while (num_buckets < bins.size())
+        num_buckets *= 2;
+
+    // Estimate the bucket width from the separation of the earliest
+    // bins, discarding gaps more than twice the average, as proposed
+    // by Brown. Far-future events are typically sparse and would
+    // otherwise inflate the width.
+    const size_t samples = std::min(bins.size(), bucketWidthSamples);
+    if (samples > 1) {
+        std::vector<Tick> ticks;
+        ticks.reserve(bins.size());
+        for (const Event *bin : bins)
+            ticks.push_back(bin->when());
+        std::nth_element(ticks.begin(), ticks.begin() + samples - 1,
+                         ticks.end());
+        std::sort(ticks.begin(), ticks.begin() + samples);
+
+        const Tick avg = (ticks[samples - 1] - ticks[0]) / (samples - 1);
+        Tick sum = 0;
+        size_t count = 0;
+        for (size_t i = 1; i < samples; ++i) {
+            const Tick gap = ticks[i] - ticks[i - 1];
+            if (gap / 2 <= avg) {
+                sum += gap;
+                ++count;
+            }
+        }
+
+        const Tick mean = count ? sum / count : 0;
+        if (mean > 0)
+            bucketWidth = mean > MaxTick / 3 ? MaxTick / 3 : 3 * mean;
+    }
+
+    buckets.assign(num_buckets, nullptr);
+    head = nullptr;
+    numBins = bins.size();
+    for (Event *bin : bins)
+        calendarInsertBin(bin);
+}
+
+std::vector<Event *>
+EventQueue::collectBins(bool sorted) const
+{
+    std::vector<Event *> bins;
+    if (backend == Backend::SortedList) {
+        for (Event *bin = head; bin; bin = bin->nextBin)
+            bins.push_back(bin);
+        return bins;
+    }
+
+    bins.reserve(numBins);
+    for (Event *bin : buckets) {
+        for (; bin; bin = bin->nextBin)
+            bins.push_back(bin);
+    }
+
+    if (sorted) {
+        std::sort(bins.begin(), bins.end(),
+                  [](const Event *l, const Event *r) { return *l < *r; });
+    }
+    return bins;
 }
 
 void
@@ -415,23 +662,84 @@ Event::dump() const
     }
 }
 
-EventQueue::EventQueue(const std::string &n)
-    : objName(n), head(NULL), _curTick(0)
+EventQueue::Backend
+EventQueue::defaultBackend()
+{
+    return USE_CALENDAR_EVENTQ ? Backend::Calendar : Backend::SortedList;
+}
+
+EventQueue::EventQueue(const std::string &n, Backend _backend)
+    : objName(n), head(NULL), _curTick(0), backend(_backend),
+      bucketWidth(initialBucketWidth), numBins(0), mainQueueIndex(-1),
+      crossQueuePosts(0)
 {
+    if (backend == Backend::Calendar)
+        buckets.assign(minCalendarBuckets, nullptr);
 }
 
 void
-EventQueue::asyncInsert(Event *event)
+EventQueue::asyncInsert(Event *event, bool global)
 {
+    // Events scheduled from the thread of another main event queue have
+    // a well defined producer and can use its mailbox. Global events
+    // need a single queue to keep their total order, and events coming
+    // from any other thread have no mailbox.
+    EventQueue *src = curEventQueue();
+    if (!global && src && src->mainQueueIndex >= 0 &&
+            src->mainQueueIndex < (int)mailboxes.size()) {
+        mailboxes[src->mainQueueIndex]->push(event);
+        src->crossQueuePosts++;
+        return;
+    }
+
     async_queue_mutex.lock();
     async_queue.push_back(event);
     async_queue_mutex.unlock();
 }
 
+void
+EventQueue::initMailboxes(uint32_t num_queues)
+{
+    assert(!inParallelMode);
+    while (mailboxes.size() < num_queues)
+        mailboxes.emplace_back(new SPSCQueue<Event *>);
+}
+
 void
 EventQueue::handleAsyncInsertions()
 {
     assert(this == curEventQueue());
+
+    if (!mailboxes.empty()) {
+        const auto start = std::chrono::steady_clock::now();
+
+        // Drain in source order so that the insertion order does not
+        // depend on which thread got to post its events first.
+        uint64_t occupancy = 0;
+        Event *event;
+        for (auto &mailbox : mailboxes) {
+            while (mailbox->pop(event)) {
+                // With an adaptive quantum, an event can be posted with
+                // less than a quantum of slack. It is then serviced as
+                // soon as possible rather than in the past.
+                if (event->when() < getCurTick()) {
+                    event->setWhen(getCurTick(), this);
+                    _mailboxStats.lateEvents++;
+                }
+                insert(event);
+                ++occupancy;
+            }
+        }
+
+        _mailboxStats.drains++;
+        _mailboxStats.events += occupancy;
+        _mailboxStats.maxOccupancy =
+            std::max(_mailboxStats.maxOccupancy, occupancy);
+        _mailboxStats.drainTime +=
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+    }
+
     async_queue_mutex.lock();
 
     while (!async_queue.empty()) {
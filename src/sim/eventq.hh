@@ -43,9 +43,11 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/debug.hh"
 #include "base/flags.hh"
+#include "base/spsc_queue.hh"
 #include "base/types.hh"
 #include "base/uncontended_mutex.hh"
 #include "debug/Event.hh"
@@ -65,6 +67,14 @@ class BaseGlobalEvent;
 //! Queue B should be at least simQuantum ticks away in future.
 extern Tick simQuantum;
 
+//! Bounds of the simulation quantum. When they differ, the quantum is
+//! adapted at run time: it is widened after a quantum in which no
+//! local events were posted across main event queues, and it is
+//! brought back to simQuantumMin as soon as some were. simQuantumMin
+//! must then be no larger than the smallest cross-queue latency.
+extern Tick simQuantumMin;
+extern Tick simQuantumMax;
+
 //! Current number of allocated main event queues.
 extern uint32_t numMainEventQueues;
 
@@ -262,6 +272,10 @@ class Event : public EventBase, public Serializable
     // linear/constant, and the lookup/removal in 'nextInBin' is
     // constant/constant.  Hopefully this is a significant improvement
     // over the current fully linear insertion.
+    //
+    // When the owning queue uses the calendar backend, 'nextBin'
+    // instead links the bins that hash to the same calendar bucket,
+    // again sorted by when+priority.
     Event *nextBin;
     Event *nextInBin;
 
@@ -618,22 +632,105 @@ operator!=(const Event &l, const Event &r)
  * events must happen at least one simulation quantum into the future,
  * otherwise they risk being scheduled in the past by
  * handleAsyncInsertions().
+ *
+ * Local (non-global) events that the thread running one main event
+ * queue schedules on another main event queue do not go through the
+ * mutex protected async_queue. Each main event queue instead has one
+ * lock-free single-producer/single-consumer mailbox per source main
+ * event queue, which handleAsyncInsertions() drains in source order
+ * before merging the async_queue. Global events keep using the
+ * async_queue since their total order relies on a single queue per
+ * destination.
+ *
+ * Two storage backends are provided for the pending events. The
+ * default SortedList backend keeps all bins in a single linked list
+ * sorted by when+priority, which makes insertion linear in the number
+ * of distinct pending ticks. The Calendar backend hashes bins into an
+ * array of buckets indexed by time (R. Brown, "Calendar Queues",
+ * CACM 1988), giving amortized constant-time insertion and removal.
+ * Both backends produce exactly the same servicing order: events are
+ * ordered by tick, then priority, and events in the same bin are
+ * serviced in LIFO order of insertion. The default backend is selected
+ * at build time with the USE_CALENDAR_EVENTQ option.
  */
 class EventQueue
 {
+  public:
+    /**
+     * Storage backend used for the pending events.
+     *
+     * @ingroup api_eventq
+     */
+    enum class Backend
+    {
+        SortedList,
+        Calendar
+    };
+
+    /**
+     * Backend used by queues that do not request a specific one.
+     *
+     * @ingroup api_eventq
+     */
+    static Backend defaultBackend();
+
   private:
     friend void curEventQueue(EventQueue *);
+    friend EventQueue *getEventQueue(uint32_t index);
 
     std::string objName;
     Event *head;
     Tick _curTick;
 
+    const Backend backend;
+
+    /**
+     * @{
+     * Calendar backend state. Each bucket holds a list of bins sorted
+     * by when+priority and linked through Event::nextBin. A bin with
+     * tick t lives in bucket (t / bucketWidth) % buckets.size(); the
+     * number of buckets is always a power of two. The head pointer
+     * caches the top of the earliest bin so that nextTick() and
+     * getHead() stay constant time.
+     */
+    std::vector<Event *> buckets;
+    Tick bucketWidth;
+    size_t numBins;
+    /** @} */
+
+    //! Calendar backend helpers, see eventq.cc.
+    size_t bucketIndex(Tick when) const;
+    void calendarInsert(Event *event);
+    void calendarInsertBin(Event *bin);
+    void calendarRemove(Event *event);
+    Event *calendarFindHead(Tick from) const;
+    void calendarRebuild(const std::vector<Event *> &bins);
+
+    //! Return the top event of every bin, optionally sorted by
+    //! when+priority (the sorted list backend is always sorted).
+    std::vector<Event *> collectBins(bool sorted) const;
+
     //! Mutex to protect async queue.
     UncontendedMutex async_queue_mutex;
 
     //! List of events added by other threads to this event queue.
     std::list<Event*> async_queue;
 
+    //! Index of this queue in mainEventQueue, or -1 if this is not a
+    //! main event queue.
+    int mainQueueIndex;
+
+    //! Mailboxes for local events scheduled on this queue by the
+    //! threads running the other main event queues, indexed by the
+    //! source queue. Only the source queue's thread pushes into a
+    //! mailbox and only this queue's thread pops from it.
+    std::vector<std::unique_ptr<SPSCQueue<Event *>>> mailboxes;
+
+    //! Number of local events this queue's thread posted to the
+    //! mailboxes of other main event queues since the last call to
+    //! takeCrossQueuePosts().
+    uint64_t crossQueuePosts;
+
     /**
      * Lock protecting event handling.
      *
@@ -664,10 +761,46 @@ class EventQueue
     //! Function for adding events to the async queue. The added events
     //! are added to main event queue later. Threads, other than the
     //! owning thread, should call this function instead of insert().
-    void asyncInsert(Event *event);
+    void asyncInsert(Event *event, bool global);
 
     EventQueue(const EventQueue &);
 
+  public:
+    /**
+     * Counters for the cross-queue mailboxes of a main event queue.
+     */
+    struct MailboxStats
+    {
+        //! Number of times the mailboxes were drained.
+        uint64_t drains = 0;
+        //! Number of events received through the mailboxes.
+        uint64_t events = 0;
+        //! Largest number of events found in the mailboxes by a drain.
+        uint64_t maxOccupancy = 0;
+        //! Host time spent draining the mailboxes, in nanoseconds.
+        uint64_t drainTime = 0;
+        //! Number of events found in the mailboxes with a time stamp
+        //! that the queue had already passed, which can only happen
+        //! with an adaptive quantum.
+        uint64_t lateEvents = 0;
+    };
+
+    /**
+     * Counters for the quantum barriers of a main event queue.
+     */
+    struct BarrierStats
+    {
+        //! Number of quantum barriers this queue went through.
+        uint64_t syncs = 0;
+        //! Host time spent waiting for the other queues at the quantum
+        //! barriers, in nanoseconds.
+        uint64_t waitTime = 0;
+    };
+
+  private:
+    MailboxStats _mailboxStats;
+    BarrierStats _barrierStats;
+
   public:
     class ScopedMigration
     {
@@ -745,7 +878,7 @@ class EventQueue
     /**
      * @ingroup api_eventq
      */
-    EventQueue(const std::string &n);
+    EventQueue(const std::string &n, Backend _backend=defaultBackend());
 
     /**
      * @ingroup api_eventq
@@ -753,6 +886,7 @@ class EventQueue
      */
     virtual const std::string name() const { return objName; }
     void name(const std::string &st) { objName = st; }
+    Backend getBackend() const { return backend; }
     /** @}*/ //end of api_eventq group
 
     /**
@@ -777,7 +911,7 @@ class EventQueue
         //    a total order amongst the global events. See global_event.{cc,hh}
         //    for more explanation.
         if (inParallelMode && (this != curEventQueue() || global)) {
-            asyncInsert(event);
+            asyncInsert(event, global);
         } else {
             insert(event);
         }
@@ -908,10 +1042,48 @@ class EventQueue
     bool debugVerify() const;
 
     /**
-     * Function for moving events from the async_queue to the main queue.
+     * Function for moving events from the mailboxes and the async_queue
+     * to the main queue.
      */
     void handleAsyncInsertions();
 
+    /**
+     * Make sure this queue has a mailbox for each of the first
+     * num_queues main event queues. Must not be called in parallel
+     * mode.
+     */
+    void initMailboxes(uint32_t num_queues);
+
+    /** @{ */
+    const MailboxStats &mailboxStats() const { return _mailboxStats; }
+    void resetMailboxStats() { _mailboxStats = MailboxStats(); }
+    /** @} */
+
+    /**
+     * Return the number of local events this queue's thread posted to
+     * other main event queues since the previous call, and clear it.
+     * Must only be called while this queue's thread is stopped at a
+     * barrier or owns the queue.
+     */
+    uint64_t
+    takeCrossQueuePosts()
+    {
+        const uint64_t posts = crossQueuePosts;
+        crossQueuePosts = 0;
+        return posts;
+    }
+
+    /** @{ */
+    void
+    recordBarrierWait(uint64_t wait_ns)
+    {
+        _barrierStats.syncs++;
+        _barrierStats.waitTime += wait_ns;
+    }
+    const BarrierStats &barrierStats() const { return _barrierStats; }
+    void resetBarrierStats() { _barrierStats = BarrierStats(); }
+    /** @} */
+
     /**
      *  Function to signal that the event loop should be woken up because
      *  an event has been scheduled by an agent outside the gem5 event
@@ -933,7 +1105,9 @@ class EventQueue
      *  function for replacing the head of the event queue, so that a
      *  different set of events can run without disturbing events that have
      *  already been scheduled. Already scheduled events can be processed
-     *  by replacing the original head back.
+     *  by replacing the original head back. The events are exchanged as
+     *  a chain of bins sorted by when+priority and linked through
+     *  nextBin, regardless of the backend in use.
      *  USING THIS FUNCTION CAN BE DANGEROUS TO THE HEALTH OF THE SIMULATOR.
      *  NOT RECOMMENDED FOR USE.
      */
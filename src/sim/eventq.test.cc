@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "sim/eventq.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** An event that records its id in a log when it is processed. */
+class LogEvent : public Event
+{
+  private:
+    int id;
+    std::vector<int> &log;
+
+  public:
+    LogEvent(int _id, std::vector<int> &_log, Priority p)
+        : Event(p), id(_id), log(_log)
+    {}
+
+    void process() override { log.push_back(id); }
+};
+
+/**
+ * Apply the same pseudo-random sequence of schedule, deschedule and
+ * reschedule operations to a queue and return the order in which the
+ * events were serviced.
+ */
+std::vector<int>
+runRandomSequence(EventQueue::Backend backend, unsigned seed)
+{
+    EventQueue eq("test_eventq", backend);
+    std::vector<int> log;
+    std::vector<std::unique_ptr<LogEvent>> events;
+
+    const int num_events = 2000;
+    const Event::Priority priorities[] = {
+        Event::Default_Pri, Event::CPU_Tick_Pri, Event::Sim_Exit_Pri,
+        Event::Minimum_Pri };
+
+    std::mt19937 rng(seed);
+    for (int i = 0; i < num_events; ++i) {
+        events.emplace_back(new LogEvent(i, log, priorities[rng() % 4]));
+    }
+
+    for (int round = 0; round < 20; ++round) {
+        for (auto &event : events) {
+            // Use a mix of near ticks, repeated ticks (to exercise the
+            // LIFO order within a bin) and far future ticks.
+            Tick delta;
+            switch (rng() % 4) {
+              case 0: delta = rng() % 4; break;
+              case 1: delta = (rng() % 64) * 500; break;
+              case 2: delta = rng() % 100000; break;
+              default: delta = (Tick)(rng() % 16) << 40; break;
+            }
+            const Tick when = eq.getCurTick() + delta;
+
+            switch (rng() % 3) {
+              case 0:
+                if (!event->scheduled())
+                    eq.schedule(event.get(), when);
+                break;
+              case 1:
+                if (event->scheduled())
+                    eq.deschedule(event.get());
+                break;
+              default:
+                eq.reschedule(event.get(), when, true);
+                break;
+            }
+        }
+        EXPECT_TRUE(eq.debugVerify());
+
+        // Service part of the queue so that the calendar drains and
+        // rebuilds.
+        for (int i = 0; i < num_events / 3 && !eq.empty(); ++i)
+            eq.serviceOne();
+    }
+
+    while (!eq.empty())
+        eq.serviceOne();
+
+    return log;
+}
+
+} // anonymous namespace
+
+/** Events in the same bin are serviced in LIFO order of insertion. */
+TEST(EventQueueTest, SameBinOrder)
+{
+    for (auto backend : {EventQueue::Backend::SortedList,
+                         EventQueue::Backend::Calendar}) {
+        EventQueue eq("test_eventq", backend);
+        std::vector<int> log;
+        LogEvent e0(0, log, Event::Default_Pri);
+        LogEvent e1(1, log, Event::Default_Pri);
+        LogEvent e2(2, log, Event::CPU_Tick_Pri);
+        LogEvent e3(3, log, Event::Default_Pri);
+
+        eq.schedule(&e0, 100);
+        eq.schedule(&e1, 100);
+        eq.schedule(&e2, 100);
+        eq.schedule(&e3, 50);
+        ASSERT_EQ(eq.getBackend(), backend);
+        ASSERT_EQ(eq.nextTick(), 50);
+
+        while (!eq.empty())
+            eq.serviceOne();
+
+        EXPECT_EQ(log, std::vector<int>({3, 1, 0, 2}));
+    }
+}
+
+/** Both backends service random event sequences in the same order. */
+TEST(EventQueueTest, CalendarMatchesSortedList)
+{
+    for (unsigned seed = 1; seed <= 4; ++seed) {
+        std::vector<int> list_log =
+            runRandomSequence(EventQueue::Backend::SortedList, seed);
+        std::vector<int> calendar_log =
+            runRandomSequence(EventQueue::Backend::Calendar, seed);
+        ASSERT_FALSE(list_log.empty());
+        EXPECT_EQ(list_log, calendar_log);
+    }
+}
+
+/** Swapping the events out and back in preserves their order. */
+TEST(EventQueueTest, CalendarReplaceHead)
+{
+    EventQueue eq("test_eventq", EventQueue::Backend::Calendar);
+    std::vector<int> log;
+    std::vector<std::unique_ptr<LogEvent>> events;
+    for (int i = 0; i < 100; ++i) {
+        events.emplace_back(new LogEvent(i, log, Event::Default_Pri));
+        eq.schedule(events.back().get(), 1000 - (i % 50) * 10);
+    }
+
+    Event *saved = eq.replaceHead(nullptr);
+    ASSERT_TRUE(eq.empty());
+
+    LogEvent other(-1, log, Event::Default_Pri);
+    eq.schedule(&other, 5);
+    eq.serviceOne();
+    ASSERT_TRUE(eq.empty());
+
+    eq.replaceHead(saved);
+    EXPECT_TRUE(eq.debugVerify());
+    while (!eq.empty())
+        eq.serviceOne();
+
+    ASSERT_EQ(log.size(), 101);
+    EXPECT_EQ(log[0], -1);
+    for (int i = 1; i <= 50; ++i) {
+        // The latest bins hold the events with the smallest ids, and
+        // each bin is serviced in LIFO order.
+        EXPECT_EQ(log[2 * i - 1], 100 - i);
+        EXPECT_EQ(log[2 * i], 50 - i);
+    }
+}
+
+/** Local events posted from another main queue go through its mailbox. */
+TEST(EventQueueTest, CrossQueueMailbox)
+{
+    EventQueue *dst = getEventQueue(0);
+    EventQueue *src = getEventQueue(1);
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->initMailboxes(numMainEventQueues);
+
+    std::vector<int> log;
+    std::vector<std::unique_ptr<LogEvent>> events;
+    for (int i = 0; i < 1000; ++i)
+        events.emplace_back(new LogEvent(i, log, Event::Default_Pri));
+
+    inParallelMode = true;
+    std::thread producer([&] () {
+        curEventQueue(src);
+        for (int i = 0; i < 1000; ++i)
+            dst->schedule(events[i].get(), 1000 - i, i % 100 == 0);
+    });
+    producer.join();
+
+    // Nothing is visible to the destination before it drains.
+    curEventQueue(dst);
+    EXPECT_TRUE(dst->empty());
+    dst->handleAsyncInsertions();
+    inParallelMode = false;
+
+    // Global events bypass the mailboxes.
+    EXPECT_EQ(dst->mailboxStats().drains, 1);
+    EXPECT_EQ(dst->mailboxStats().events, 990);
+    EXPECT_EQ(dst->mailboxStats().maxOccupancy, 990);
+
+    while (!dst->empty())
+        dst->serviceOne();
+    curEventQueue(nullptr);
+
+    ASSERT_EQ(log.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(log[i], 999 - i);
+}
+
+/** Mailbox events the destination has already passed are not lost. */
+TEST(EventQueueTest, LateCrossQueueEvent)
+{
+    EventQueue *dst = getEventQueue(0);
+    EventQueue *src = getEventQueue(1);
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->initMailboxes(numMainEventQueues);
+    dst->resetMailboxStats();
+    src->takeCrossQueuePosts();
+
+    std::vector<int> log;
+    LogEvent early(0, log, Event::Default_Pri);
+    LogEvent late(1, log, Event::Default_Pri);
+
+    inParallelMode = true;
+    std::thread producer([&] () {
+        curEventQueue(src);
+        dst->schedule(&late, dst->getCurTick() + 10);
+        dst->schedule(&early, dst->getCurTick() + 20);
+    });
+    producer.join();
+    EXPECT_EQ(src->takeCrossQueuePosts(), 2);
+    EXPECT_EQ(src->takeCrossQueuePosts(), 0);
+
+    // The destination ran ahead while the events were in flight.
+    const Tick now = dst->getCurTick() + 15;
+    dst->setCurTick(now);
+    curEventQueue(dst);
+    dst->handleAsyncInsertions();
+    inParallelMode = false;
+
+    EXPECT_EQ(dst->mailboxStats().events, 2);
+    EXPECT_EQ(dst->mailboxStats().lateEvents, 1);
+    EXPECT_EQ(late.when(), now);
+    EXPECT_EQ(early.when(), now + 5);
+
+    while (!dst->empty())
+        dst->serviceOne();
+    curEventQueue(nullptr);
+
+    ASSERT_EQ(log.size(), 2);
+    EXPECT_EQ(log[0], 1);
+    EXPECT_EQ(log[1], 0);
+}
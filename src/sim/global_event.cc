@@ -29,6 +29,8 @@
 
 #include "sim/global_event.hh"
 
+#include <chrono>
+
 #include "sim/cur_tick.hh"
 
 namespace gem5
@@ -143,14 +145,27 @@ GlobalEvent::BarrierEvent::process()
 void
 GlobalSyncEvent::BarrierEvent::process()
 {
+    using namespace std::chrono;
+
+    // Account for the host time spent waiting on the barriers, but not
+    // for the time spent processing the global event.
+    auto start = steady_clock::now();
+    uint64_t wait_ns = 0;
+
     // wait for all queues to arrive at barrier, then process event
-    if (globalBarrier()) {
+    const bool last = globalBarrier();
+    wait_ns += duration_cast<nanoseconds>(steady_clock::now() - start).count();
+    if (last) {
         _globalEvent->process();
     }
 
     // second barrier to force all queues to wait for event processing
     // to finish before continuing
+    start = steady_clock::now();
     globalBarrier();
+    wait_ns += duration_cast<nanoseconds>(steady_clock::now() - start).count();
+
+    curEventQueue()->recordBarrierWait(wait_ns);
     curEventQueue()->handleAsyncInsertions();
 }
 
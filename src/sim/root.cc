@@ -75,6 +75,31 @@ Root::RootStats::RootStats()
              "The number of ticks simulated per host second (ticks/s)"),
     ADD_STAT(hostMemory, statistics::units::Byte::get(),
              "Number of bytes of host memory used"),
+    ADD_STAT(eventqMailboxDrains, statistics::units::Count::get(),
+             "Number of times the cross-queue mailboxes of each main "
+             "event queue were drained"),
+    ADD_STAT(eventqMailboxEvents, statistics::units::Count::get(),
+             "Number of events each main event queue received through "
+             "its cross-queue mailboxes"),
+    ADD_STAT(eventqMailboxMaxOccupancy, statistics::units::Count::get(),
+             "Largest number of events found in the cross-queue "
+             "mailboxes of each main event queue by a single drain"),
+    ADD_STAT(eventqMailboxDrainTime, statistics::units::Second::get(),
+             "Host time spent draining the cross-queue mailboxes of "
+             "each main event queue"),
+    ADD_STAT(eventqMailboxAvgOccupancy, statistics::units::Rate<
+                statistics::units::Count, statistics::units::Count>::get(),
+             "Average number of events found in the cross-queue "
+             "mailboxes of each main event queue per drain"),
+    ADD_STAT(eventqMailboxLateEvents, statistics::units::Count::get(),
+             "Number of events each main event queue received through "
+             "its cross-queue mailboxes after their scheduled tick"),
+    ADD_STAT(eventqBarrierSyncs, statistics::units::Count::get(),
+             "Number of quantum barriers each main event queue went "
+             "through"),
+    ADD_STAT(eventqBarrierWaitTime, statistics::units::Second::get(),
+             "Host time each main event queue spent waiting for the "
+             "other queues at the quantum barriers"),
 
     statTime(true),
     startTick(0)
@@ -101,6 +126,28 @@ Root::RootStats::RootStats()
 
     simSeconds = simTicks / simFreq;
     hostTickRate = simTicks / hostSeconds;
+
+    eventqMailboxAvgOccupancy = eventqMailboxEvents / eventqMailboxDrains;
+}
+
+void
+Root::RootStats::regStats()
+{
+    statistics::Group::regStats();
+
+    // The number of main event queues is only known once all the
+    // SimObjects have been created. The mailbox stats are only
+    // relevant to multi-queue simulations, so hide them otherwise.
+    const uint32_t num_queues = std::max(numMainEventQueues, 1u);
+    for (auto *stat : {&eventqMailboxDrains, &eventqMailboxEvents,
+                       &eventqMailboxMaxOccupancy, &eventqMailboxDrainTime,
+                       &eventqMailboxLateEvents, &eventqBarrierSyncs,
+                       &eventqBarrierWaitTime}) {
+        stat->init(num_queues).flags(statistics::nozero);
+    }
+    eventqMailboxDrainTime.precision(6);
+    eventqBarrierWaitTime.precision(6);
+    eventqMailboxAvgOccupancy.flags(statistics::nozero | statistics::nonan);
 }
 
 void
@@ -109,9 +156,34 @@ Root::RootStats::resetStats()
     statTime.setTimer();
     startTick = curTick();
 
+    for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+        mainEventQueue[i]->resetMailboxStats();
+        mainEventQueue[i]->resetBarrierStats();
+    }
+
     statistics::Group::resetStats();
 }
 
+void
+Root::RootStats::preDumpStats()
+{
+    statistics::Group::preDumpStats();
+
+    for (uint32_t i = 0; i < numMainEventQueues &&
+             i < eventqMailboxDrains.size(); ++i) {
+        const auto &mb = mainEventQueue[i]->mailboxStats();
+        eventqMailboxDrains[i] = mb.drains;
+        eventqMailboxEvents[i] = mb.events;
+        eventqMailboxMaxOccupancy[i] = mb.maxOccupancy;
+        eventqMailboxDrainTime[i] = mb.drainTime / 1e9;
+        eventqMailboxLateEvents[i] = mb.lateEvents;
+
+        const auto &bs = mainEventQueue[i]->barrierStats();
+        eventqBarrierSyncs[i] = bs.syncs;
+        eventqBarrierWaitTime[i] = bs.waitTime / 1e9;
+    }
+}
+
 /*
  * This function is called periodically by an event in M5 and ensures that
  * at least as much real time has passed between invocations as simulated time.
@@ -187,6 +259,12 @@ Root::Root(const RootParams &p, int)
     lastTime.setTimer();
 
     simQuantum = p.sim_quantum;
+    simQuantumMin = p.sim_quantum_min ? p.sim_quantum_min : p.sim_quantum;
+    simQuantumMax = p.sim_quantum_max ? p.sim_quantum_max : p.sim_quantum;
+    fatal_if(simQuantum < simQuantumMin || simQuantum > simQuantumMax,
+             "sim_quantum (%d) must be within sim_quantum_min (%d) and "
+             "sim_quantum_max (%d)", simQuantum, simQuantumMin,
+             simQuantumMax);
 
     // Some of the statistics are global and need to be accessed by
     // stat formulas. The most convenient way to implement that is by
@@ -99,7 +99,9 @@ class Root : public SimObject
   public: // Global statistics
     struct RootStats : public statistics::Group
     {
+        void regStats() override;
         void resetStats() override;
+        void preDumpStats() override;
 
         statistics::Formula simSeconds;
         statistics::Value simTicks;
@@ -110,6 +112,20 @@ class Root : public SimObject
         statistics::Formula hostTickRate;
         statistics::Value hostMemory;
 
+        /** @{ Cross-queue mailbox counters, one per main event queue */
+        statistics::Vector eventqMailboxDrains;
+        statistics::Vector eventqMailboxEvents;
+        statistics::Vector eventqMailboxMaxOccupancy;
+        statistics::Vector eventqMailboxDrainTime;
+        statistics::Formula eventqMailboxAvgOccupancy;
+        statistics::Vector eventqMailboxLateEvents;
+        /** @} */
+
+        /** @{ Quantum barrier counters, one per main event queue */
+        statistics::Vector eventqBarrierSyncs;
+        statistics::Vector eventqBarrierWaitTime;
+        /** @} */
+
         static RootStats instance;
 
       private:
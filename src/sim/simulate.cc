@@ -49,8 +49,10 @@
 #include "base/logging.hh"
 #include "base/pollevent.hh"
 #include "base/types.hh"
+#include "mem/request.hh"
 #include "sim/async.hh"
 #include "sim/eventq.hh"
+#include "sim/global_event.hh"
 #include "sim/sim_events.hh"
 #include "sim/sim_exit.hh"
 #include "sim/stat_control.hh"
@@ -167,6 +169,47 @@ class SimulatorThreads
 
 static std::unique_ptr<SimulatorThreads> simulatorThreads;
 
+/**
+ * The barrier that ends each quantum of a multi-queue simulation.
+ *
+ * If simQuantumMin and simQuantumMax differ, the length of the next
+ * quantum is chosen while all the threads are stopped at the
+ * barrier. It is doubled, up to simQuantumMax, if no local events
+ * were posted across main event queues in the quantum that just
+ * ended, and falls back to simQuantumMin otherwise: the queues
+ * are then communicating and a wider quantum would delay their
+ * events. simQuantum follows the current quantum, so that global
+ * events scheduled a quantum ahead are never in the past.
+ */
+class QuantumSyncEvent : public GlobalSyncEvent
+{
+  public:
+    QuantumSyncEvent(Tick when)
+        : GlobalSyncEvent(when, simQuantum, EventBase::Progress_Event_Pri, 0)
+    {}
+
+    void
+    process() override
+    {
+        if (simQuantumMin < simQuantumMax) {
+            uint64_t posts = 0;
+            for (uint32_t i = 0; i < numMainEventQueues; ++i)
+                posts += mainEventQueue[i]->takeCrossQueuePosts();
+
+            if (posts)
+                simQuantum = simQuantumMin;
+            else if (simQuantum > simQuantumMax / 2)
+                simQuantum = simQuantumMax;
+            else
+                simQuantum *= 2;
+
+            repeat = simQuantum;
+        }
+
+        GlobalSyncEvent::process();
+    }
+};
+
 struct DescheduleDeleter
 {
     void operator()(BaseGlobalEvent *event)
@@ -187,7 +230,7 @@ struct DescheduleDeleter
 GlobalSimLoopExitEvent *
 simulate(Tick num_cycles)
 {
-    std::unique_ptr<GlobalSyncEvent, DescheduleDeleter> quantum_event;
+    std::unique_ptr<QuantumSyncEvent, DescheduleDeleter> quantum_event;
     const Tick exit_tick = num_cycles < MaxTick - curTick() ?
                                         curTick() + num_cycles : MaxTick;
 
@@ -206,10 +249,17 @@ simulate(Tick num_cycles)
     if (numMainEventQueues > 1) {
         fatal_if(simQuantum == 0,
                  "Quantum for multi-eventq simulation not specified");
+#ifdef GEM5_NONATOMIC_REQUEST_REFCOUNT
+        fatal("Multi-eventq simulation is not supported with "
+              "USE_NONATOMIC_REQUEST_REFCOUNT");
+#endif
+
+        quantum_event.reset(new QuantumSyncEvent(curTick() + simQuantum));
 
-        quantum_event.reset(
-            new GlobalSyncEvent(curTick() + simQuantum, simQuantum,
-                                EventBase::Progress_Event_Pri, 0));
+        // Local events posted across queues go through per source queue
+        // mailboxes, which are drained at every quantum barrier.
+        for (uint32_t i = 0; i < numMainEventQueues; ++i)
+            mainEventQueue[i]->initMailboxes(numMainEventQueues);
 
         inParallelMode = true;
     }
@@ -234,7 +284,10 @@ simulate(Tick num_cycles)
 void
 terminateEventQueueThreads()
 {
-    simulatorThreads->terminateThreads();
+    // The threads are only started by the first call to simulate(), so
+    // there are none yet if, e.g., a checkpoint was just restored.
+    if (simulatorThreads)
+        simulatorThreads->terminateThreads();
 }
 
 
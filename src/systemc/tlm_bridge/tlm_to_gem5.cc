@@ -113,7 +113,7 @@ payload2packet(RequestorID _id, tlm::tlm_generic_payload &trans)
         AtomicOpFunctorPtr amo_op = AtomicOpFunctorPtr(
             atomic_ex->getAtomicOpFunctor()->clone());
         // FIXME: correct the context_id and pc state.
-        req = std::make_shared<Request>(
+        req = Request::make(
             trans.get_address(), trans.get_data_length(), flags, _id,
             0, 0, std::move(amo_op));
         req->setPaddr(trans.get_address());
@@ -133,7 +133,7 @@ payload2packet(RequestorID _id, tlm::tlm_generic_payload &trans)
                             "command");
         }
         Request::Flags flags;
-        req = std::make_shared<Request>(
+        req = Request::make(
             trans.get_address(), trans.get_data_length(), flags, _id);
     }
 
@@ -0,0 +1,152 @@
+# Copyright (c) 2022 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Checks the decoded block cache of the NonCachingSimpleCPU. Each binary is
+run in a forked process with and without the cache, and a non-zero exit
+code is returned unless both runs print the same output and commit the
+same number of instructions at the same tick, with the instructions run
+from the cache. The self-modifying binary rewrites code that is in the
+cache, which must be detected.
+"""
+
+import argparse
+import os
+import sys
+import traceback
+
+import m5
+from m5.objects import *
+
+parser = argparse.ArgumentParser(
+    description="Compares runs with and without the decoded block cache."
+)
+
+parser.add_argument(
+    "binary", type=str, help="An x86 binary to run in SE mode."
+)
+
+parser.add_argument(
+    "self_modifying",
+    type=str,
+    help="An x86 binary that modifies its code, to run in SE mode.",
+)
+
+args = parser.parse_args()
+
+
+def build_root(binary, decoded_block_cache):
+    system = System()
+    system.clk_domain = SrcClockDomain(
+        clock="1GHz", voltage_domain=VoltageDomain()
+    )
+    system.mem_mode = "atomic_noncaching"
+    system.mem_ranges = [AddrRange("512MB")]
+
+    system.cpu = X86NonCachingSimpleCPU(
+        decoded_block_cache=decoded_block_cache
+    )
+    system.membus = SystemXBar()
+    system.cpu.icache_port = system.membus.cpu_side_ports
+    system.cpu.dcache_port = system.membus.cpu_side_ports
+    system.cpu.createInterruptController()
+    system.cpu.interrupts[0].pio = system.membus.mem_side_ports
+    system.cpu.interrupts[0].int_requestor = system.membus.cpu_side_ports
+    system.cpu.interrupts[0].int_responder = system.membus.mem_side_ports
+
+    # The cache only works on memory with a backdoor.
+    system.memory = SimpleMemory(range=system.mem_ranges[0])
+    system.memory.port = system.membus.mem_side_ports
+    system.system_port = system.membus.cpu_side_ports
+
+    system.workload = SEWorkload.init_compatible(binary)
+    system.cpu.workload = Process(cmd=[binary], output="program.out")
+    system.cpu.createThreads()
+
+    return Root(full_system=False, system=system)
+
+
+def run(name, binary, decoded_block_cache):
+    """Run a binary in a child, with its output in a directory of its own."""
+    outdir = os.path.join(m5.options.outdir, name)
+    pid = os.fork()
+    if pid == 0:
+        status = 1
+        try:
+            m5.options.outdir = outdir
+            m5.core.setOutputDir(outdir)
+            build_root(binary, decoded_block_cache)
+            m5.instantiate()
+            event = m5.simulate()
+            print(f"{name}: exiting because {event.getCause()}")
+            m5.stats.dump()
+            status = event.getCode()
+        except BaseException:
+            traceback.print_exc()
+        sys.stdout.flush()
+        sys.stderr.flush()
+        os._exit(status)
+
+    _, status = os.waitpid(pid, 0)
+    if not os.WIFEXITED(status) or os.WEXITSTATUS(status) != 0:
+        sys.exit(f"The {name} run failed.")
+
+    stats = {}
+    with open(os.path.join(outdir, "stats.txt")) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) >= 2:
+                stats[fields[0]] = fields[1]
+    with open(os.path.join(outdir, "program.out")) as f:
+        output = f.read()
+    return output, stats
+
+
+for name, binary in (
+    ("plain", args.binary),
+    ("self-modifying", args.self_modifying),
+):
+    output, stats = run(f"{name}-uncached", binary, False)
+    cached_output, cached_stats = run(f"{name}-cached", binary, True)
+
+    if not output or output != cached_output:
+        sys.exit(f"The {name} binary printed:\n{output}\nwithout the "
+                 f"cache, and:\n{cached_output}\nwith the cache.")
+    for stat in ("simInsts", "simTicks"):
+        if stat not in stats or stats[stat] != cached_stats.get(stat):
+            sys.exit(f"The {name} binary ran with {stat} {stats.get(stat)} "
+                     f"without the cache, and {cached_stats.get(stat)} "
+                     "with it.")
+
+    def block_stat(stat):
+        return float(cached_stats.get(f"system.cpu.decodedBlocks.{stat}", 0))
+
+    if block_stat("hits") == 0 or block_stat("chained") == 0:
+        sys.exit(f"The {name} binary did not run from the cache.")
+    if name == "self-modifying" and block_stat("stale") == 0:
+        sys.exit("The modified code was not found stale in the cache.")
+
+print("The runs with and without the decoded block cache match.")
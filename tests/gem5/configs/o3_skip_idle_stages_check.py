@@ -0,0 +1,147 @@
+# Copyright (c) 2022 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Checks that skipping the tick of idle O3 pipeline stages doesn't change
+the simulation. The same binary is run with `skipIdleStages` off in a
+child process and on in this one, and the committed instructions and
+the cycles of the two runs must be the same. A non-zero exit code is
+returned otherwise.
+"""
+
+import argparse
+import os
+import sys
+import traceback
+
+from gem5.resources.resource import Resource
+from gem5.components.boards.simple_board import SimpleBoard
+from gem5.components.cachehierarchies.classic.private_l1_cache_hierarchy \
+    import PrivateL1CacheHierarchy
+from gem5.components.memory import SingleChannelDDR3_1600
+from gem5.components.processors.cpu_types import CPUTypes
+from gem5.components.processors.simple_processor import SimpleProcessor
+from gem5.simulate.simulator import Simulator
+from gem5.isas import get_isa_from_str, get_isas_str_set
+
+import m5
+
+parser = argparse.ArgumentParser(
+    description="Compares O3 runs with and without skipping idle stages."
+)
+
+parser.add_argument(
+    "resource",
+    type=str,
+    help="The gem5 resource binary to run.",
+)
+
+parser.add_argument(
+    "isa",
+    type=str,
+    choices=get_isas_str_set(),
+    help="The ISA used",
+)
+
+parser.add_argument(
+    "-r",
+    "--resource-directory",
+    type=str,
+    required=False,
+    help="The directory in which resources will be downloaded or exist.",
+)
+
+args = parser.parse_args()
+
+
+def run(skip_idle_stages):
+    """Run the binary and return its committed instructions and cycles."""
+    processor = SimpleProcessor(
+        cpu_type=CPUTypes.O3,
+        isa=get_isa_from_str(args.isa),
+        num_cores=1,
+    )
+    core = processor.get_cores()[0].get_simobject()
+    core.skipIdleStages = skip_idle_stages
+
+    # The caches make the pipeline wait on memory, which is when stages
+    # go idle
+    board = SimpleBoard(
+        clk_freq="3GHz",
+        processor=processor,
+        memory=SingleChannelDDR3_1600(),
+        cache_hierarchy=PrivateL1CacheHierarchy(
+            l1d_size="16kB", l1i_size="16kB"
+        ),
+    )
+    board.set_se_binary_workload(
+        Resource(args.resource, resource_directory=args.resource_directory)
+    )
+
+    simulator = Simulator(board=board)
+    simulator.run()
+
+    return (
+        int(core.resolveStat("committedInsts").total),
+        int(core.resolveStat("numCycles").value),
+        int(core.resolveStat("idleStageCycles").total),
+    )
+
+
+results = os.path.join(m5.options.outdir, "no_skip.txt")
+
+pid = os.fork()
+if pid == 0:
+    status = 1
+    try:
+        insts, cycles, _ = run(skip_idle_stages=False)
+        with open(results, "w") as f:
+            f.write(f"{insts} {cycles}\n")
+        status = 0
+    except BaseException:
+        traceback.print_exc()
+    sys.stdout.flush()
+    sys.stderr.flush()
+    os._exit(status)
+
+_, status = os.waitpid(pid, 0)
+if not os.WIFEXITED(status) or os.WEXITSTATUS(status) != 0:
+    sys.exit("The run without skipping idle stages failed.")
+
+insts, cycles, skipped = run(skip_idle_stages=True)
+with open(results) as f:
+    ref_insts, ref_cycles = (int(value) for value in f.read().split())
+
+print(f"Without skipping: {ref_insts} instructions in {ref_cycles} cycles.")
+print(
+    f"With skipping: {insts} instructions in {cycles} cycles, "
+    f"{skipped} stage ticks skipped."
+)
+
+if (insts, cycles) != (ref_insts, ref_cycles):
+    sys.exit("Skipping idle stages changed the simulation.")
+if skipped == 0:
+    sys.exit("No stage tick was skipped.")
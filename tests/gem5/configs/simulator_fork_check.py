@@ -0,0 +1,159 @@
+# Copyright (c) 2022 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Checks `Simulator.run_forked()` from a checkpoint that was just restored,
+i.e., before this process has simulated anything. A checkpoint is first
+taken in a separate process, then restored here and forked into two
+variants, one of which switches from the atomic to the timing core. A
+non-zero exit code is returned if any of this fails, if a child returned
+into this script, or if the stats of the two children do not show that
+they ran the same program on different cores.
+"""
+
+import argparse
+import os
+import sys
+import traceback
+
+import m5
+
+from gem5.components.boards.simple_board import SimpleBoard
+from gem5.components.cachehierarchies.classic.no_cache import NoCache
+from gem5.components.memory.single_channel import SingleChannelDDR3_1600
+from gem5.components.processors.cpu_types import CPUTypes
+from gem5.components.processors.simple_switchable_processor import (
+    SimpleSwitchableProcessor,
+)
+from gem5.isas import ISA
+from gem5.resources.resource import Resource
+from gem5.simulate.simulator import Simulator
+
+parser = argparse.ArgumentParser(
+    description="Checks forking a restored simulation into variants."
+)
+
+parser.add_argument(
+    "-r",
+    "--resource-directory",
+    type=str,
+    required=False,
+    help="The directory in which resources will be downloaded or exist.",
+)
+
+args = parser.parse_args()
+
+checkpoint_ticks = m5.ticks.fromSeconds(1e-6)
+
+processor = SimpleSwitchableProcessor(
+    starting_core_type=CPUTypes.ATOMIC,
+    switch_core_type=CPUTypes.TIMING,
+    num_cores=1,
+    isa=ISA.X86,
+)
+board = SimpleBoard(
+    clk_freq="3GHz",
+    processor=processor,
+    memory=SingleChannelDDR3_1600(),
+    cache_hierarchy=NoCache(),
+)
+board.set_se_binary_workload(
+    Resource(
+        "x86-hello64-static", resource_directory=args.resource_directory
+    )
+)
+
+checkpoint_dir = os.path.join(m5.options.outdir, "cpt")
+
+# Take the checkpoint in a child, so that this process never simulates
+# before restoring it.
+pid = os.fork()
+if pid == 0:
+    status = 1
+    try:
+        simulator = Simulator(board=board)
+        simulator.run(max_ticks=checkpoint_ticks)
+        simulator.save_checkpoint(checkpoint_dir)
+        status = 0
+    except BaseException:
+        traceback.print_exc()
+    sys.stdout.flush()
+    sys.stderr.flush()
+    os._exit(status)
+
+_, status = os.waitpid(pid, 0)
+if not os.WIFEXITED(status) or os.WEXITSTATUS(status) != 0:
+    sys.exit("Failed to take the checkpoint.")
+
+simulator = Simulator(board=board, checkpoint_path=checkpoint_dir)
+
+# Every process that gets out of run_forked() leaves a line here. Only
+# this one should.
+returned = os.path.join(m5.options.outdir, "returned.txt")
+try:
+    statuses = simulator.run_forked(
+        variants=[
+            lambda board: None,
+            lambda board: board.get_processor().switch(),
+        ],
+    )
+finally:
+    with open(returned, "a") as f:
+        f.write(f"{os.getpid()}\n")
+
+if statuses != [0, 0]:
+    sys.exit(f"Forked variants failed with statuses {statuses}.")
+
+with open(returned) as f:
+    pids = f.read().split()
+if pids != [str(os.getpid())]:
+    sys.exit(f"Forked children returned into the script: {pids}.")
+
+
+def read_stats(variant):
+    stats = {}
+    path = os.path.join(m5.options.outdir, f"variant{variant}", "stats.txt")
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) >= 2:
+                stats[fields[0]] = fields[1]
+    return stats
+
+
+atomic, timing = read_stats(0), read_stats(1)
+for name in ("simInsts", "simTicks"):
+    if name not in atomic or name not in timing:
+        sys.exit(f"A forked variant did not dump {name}.")
+if atomic["simInsts"] != timing["simInsts"]:
+    sys.exit(
+        f"The variants committed {atomic['simInsts']} and "
+        f"{timing['simInsts']} instructions."
+    )
+if atomic["simTicks"] == timing["simTicks"]:
+    sys.exit("Switching to the timing core did not change the run time.")
+
+print("Forked runs from the restored checkpoint succeeded.")
@@ -0,0 +1,133 @@
+# Copyright (c) 2022 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Checks that shadow tags don't change the simulation. The same MemTest
+system, whose caches use a random replacement policy, is run without
+shadow tags in a child process and with them in this one, and all the
+stats outside of the shadow tags must be the same. A non-zero exit code
+is returned otherwise.
+"""
+
+import json
+import os
+import sys
+import traceback
+
+import m5
+from m5.objects import *
+from m5.stats.gem5stats import get_simstat
+m5.util.addToPath('../../../configs/')
+from common.Caches import *
+
+nb_cores = 2
+
+def build_system(shadows):
+    cpus = [MemTest(max_loads = 1e4, progress_interval = 1e3)
+            for i in range(nb_cores)]
+
+    system = System(cpu = cpus,
+                    physmem = SimpleMemory(),
+                    membus = SystemXBar())
+    system.voltage_domain = VoltageDomain()
+    system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                       voltage_domain = system.voltage_domain)
+    system.cpu_clk_domain = SrcClockDomain(clock = '2GHz',
+                                       voltage_domain = system.voltage_domain)
+
+    system.toL2Bus = L2XBar(clk_domain = system.cpu_clk_domain)
+    system.l2c = L2Cache(clk_domain = system.cpu_clk_domain, size='16kB',
+                         assoc=8, replacement_policy=RandomRP())
+    system.l2c.cpu_side = system.toL2Bus.mem_side_ports
+    system.l2c.mem_side = system.membus.cpu_side_ports
+
+    for cpu in cpus:
+        cpu.clk_domain = system.cpu_clk_domain
+        cpu.l1c = L1Cache(size = '4kB', assoc = 4,
+                          replacement_policy=RandomRP())
+        cpu.l1c.cpu_side = cpu.port
+        cpu.l1c.mem_side = system.toL2Bus.cpu_side_ports
+
+    if shadows:
+        # The shadows draw random numbers too, which must not change the
+        # decisions of the real caches or of the testers
+        for cache in [cpu.l1c for cpu in cpus] + [system.l2c]:
+            cache.shadow_tags = [
+                BaseSetAssoc(size='8kB', assoc=2,
+                             replacement_policy=RandomRP()),
+                BaseSetAssoc(size='4kB', assoc=4,
+                             replacement_policy=BRRIPRP()),
+            ]
+
+    system.system_port = system.membus.cpu_side_ports
+    system.physmem.port = system.membus.mem_side_ports
+    return system
+
+def strip_shadows(stats):
+    return { key: strip_shadows(value) if isinstance(value, dict) else value
+             for key, value in stats.items()
+             if not key.startswith("shadow_tags") }
+
+def run(shadows):
+    system = build_system(shadows)
+    root = Root(full_system = False, system = system)
+    root.system.mem_mode = 'timing'
+
+    m5.instantiate()
+    exit_event = m5.simulate()
+    if exit_event.getCause() != "maximum number of loads reached":
+        sys.exit("Unexpected exit cause: %s" % exit_event.getCause())
+
+    stats = get_simstat([root.system]).to_json()[root.system.get_name()]
+    stats = strip_shadows(stats)
+    stats["finalTick"] = m5.curTick()
+    return json.dumps(stats, sort_keys=True)
+
+baseline = os.path.join(m5.options.outdir, "no_shadows.json")
+
+pid = os.fork()
+if pid == 0:
+    status = 1
+    try:
+        with open(baseline, "w") as f:
+            f.write(run(shadows=False))
+        status = 0
+    except BaseException:
+        traceback.print_exc()
+    sys.stdout.flush()
+    sys.stderr.flush()
+    os._exit(status)
+
+_, status = os.waitpid(pid, 0)
+if not os.WIFEXITED(status) or os.WEXITSTATUS(status) != 0:
+    sys.exit("The run without shadow tags failed.")
+
+with_shadows = run(shadows=True)
+with open(baseline) as f:
+    if f.read() != with_shadows:
+        sys.exit("Shadow tags changed the stats of the simulation.")
+
+print("Shadow tags left the stats unchanged.")
@@ -0,0 +1,100 @@
+# Copyright (c) 2022 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Runs the MemTest testers behind a snoop filter much smaller than the
+caches above it, with a counting Bloom filter in front of its storage.
+Replacing lines in the filter back-invalidates them in the L1 caches,
+and the testers check that no data is lost when dirty lines are written
+back this way. A non-zero exit code is returned if the testers fail, or
+if the snoop filter never back-invalidated a line.
+"""
+
+import os
+import re
+import sys
+
+import m5
+from m5.objects import *
+m5.util.addToPath('../../../configs/')
+from common.Caches import *
+
+nb_cores = 4
+cpus = [MemTest(max_loads = 2e4, progress_interval = 2e3)
+        for i in range(nb_cores)]
+
+system = System(cpu = cpus,
+                physmem = SimpleMemory(),
+                membus = SystemXBar())
+system.voltage_domain = VoltageDomain()
+system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                   voltage_domain = system.voltage_domain)
+system.cpu_clk_domain = SrcClockDomain(clock = '2GHz',
+                                   voltage_domain = system.voltage_domain)
+
+# The filter tracks 32 lines in 16 sets, while the L1 caches hold 256,
+# and the Bloom filter entries saturate at three lines
+system.toL2Bus = L2XBar(clk_domain = system.cpu_clk_domain)
+system.toL2Bus.snoop_filter = SnoopFilter(lookup_latency = 0,
+    max_capacity = '2kB', assoc = 2,
+    bloom_filter = BloomFilterMultiBitSel(size = 256, num_bits = 2,
+                                          skip_bits = 0))
+system.l2c = L2Cache(clk_domain = system.cpu_clk_domain, size='64kB',
+                     assoc=8)
+system.l2c.cpu_side = system.toL2Bus.mem_side_ports
+system.l2c.mem_side = system.membus.cpu_side_ports
+
+for cpu in cpus:
+    cpu.clk_domain = system.cpu_clk_domain
+    cpu.l1c = L1Cache(size = '4kB', assoc = 4)
+    cpu.l1c.cpu_side = cpu.port
+    cpu.l1c.mem_side = system.toL2Bus.cpu_side_ports
+
+system.system_port = system.membus.cpu_side_ports
+system.physmem.port = system.membus.mem_side_ports
+
+root = Root(full_system = False, system = system)
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+exit_event = m5.simulate()
+if exit_event.getCause() != "maximum number of loads reached":
+    sys.exit("Unexpected exit cause: %s" % exit_event.getCause())
+
+m5.stats.dump()
+with open(os.path.join(m5.options.outdir, "stats.txt")) as f:
+    stats = f.read()
+
+def snoop_filter_stat(name):
+    match = re.search(r"^system\.toL2Bus\.snoop_filter\.%s\s+(\d+)" % name,
+                      stats, re.MULTILINE)
+    return int(match.group(1)) if match else 0
+
+for name in ["backInvalidations", "bloomFiltered"]:
+    if snoop_filter_stat(name) == 0:
+        sys.exit("The snoop filter did not count any %s." % name)
+
+print("Back-invalidations kept the data consistent.")
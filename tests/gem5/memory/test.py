@@ -67,6 +67,22 @@ gem5_verify_config(
     valid_isas=(constants.null_tag,),
 )
 
+gem5_verify_config(
+    name='memtest-shadow-tags',
+    verifiers=(), # No need for verfiers this will return non-zero on fail
+    config=joinpath(getcwd(), 'shadow-tags-run.py'),
+    config_args = [],
+    valid_isas=(constants.null_tag,),
+)
+
+gem5_verify_config(
+    name='memtest-snoop-filter',
+    verifiers=(), # No need for verfiers this will return non-zero on fail
+    config=joinpath(getcwd(), 'snoop-filter-run.py'),
+    config_args = [],
+    valid_isas=(constants.null_tag,),
+)
+
 null_tests = [
     ('garnet_synth_traffic', None, ['--sim-cycles', '5000000']),
     ('memcheck', None, ['--maxtick', '2000000000', '--prefetchers']),
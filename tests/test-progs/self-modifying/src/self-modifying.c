@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2022 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Runs code that it rewrites between calls, to check that a simulated
+ * CPU doesn't keep executing stale instructions. Prints the sum of the
+ * values returned by the generated function, which is 495000.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/* mov $imm32, %eax; ret */
+static const unsigned char code[] = { 0xb8, 0, 0, 0, 0, 0xc3 };
+
+int
+main(void)
+{
+    unsigned char *buf = mmap(NULL, 4096,
+            PROT_READ | PROT_WRITE | PROT_EXEC,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    memcpy(buf, code, sizeof(code));
+
+    int (*func)(void) = (int (*)(void))buf;
+    unsigned long sum = 0;
+    for (int i = 0; i < 1000; i++) {
+        /* Rewrite the immediate every ten calls, so that the same code
+         * runs several times in between. */
+        if (i % 10 == 0)
+            memcpy(buf + 1, &i, sizeof(i));
+        sum += func();
+    }
+
+    printf("sum: %lu\n", sum);
+    return sum == 495000 ? 0 : 1;
+}